@@ -0,0 +1,78 @@
+#include "addon_names.hpp"
+#include "monitor_arena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace perf_monitor {
+    // Open addressing table of ids, kept at most half full
+    constexpr size_t ADDON_NAME_SLOTS = MAX_ADDON_NAMES * 2;
+
+    // Names live in their own arena that is never rewound, next to each other instead of spread
+    // over the client's heap one string at a time
+    static MonitorArena gAddonNameArena(ADDON_NAME_BYTES);
+    static const char *gAddonNames[MAX_ADDON_NAMES];
+    static size_t gAddonNameLengths[MAX_ADDON_NAMES];
+    static AddonId gAddonNameSlots[ADDON_NAME_SLOTS];
+    static bool gAddonNameSlotsInitialized = false;
+    static std::atomic<size_t> gAddonNameCount{0};
+
+    // FNV-1a
+    static uint32_t HashName(const char *name, size_t length) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<uint8_t>(name[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    AddonId InternAddonName(const char *name, size_t length) {
+        if (length == 0) {
+            return ADDON_NONE;
+        }
+
+        if (!gAddonNameSlotsInitialized) {
+            std::fill(gAddonNameSlots, gAddonNameSlots + ADDON_NAME_SLOTS, ADDON_NONE);
+            gAddonNameSlotsInitialized = true;
+        }
+
+        size_t slot = HashName(name, length) & (ADDON_NAME_SLOTS - 1);
+        while (gAddonNameSlots[slot] != ADDON_NONE) {
+            AddonId existing = gAddonNameSlots[slot];
+            if (gAddonNameLengths[existing] == length && std::memcmp(gAddonNames[existing], name, length) == 0) {
+                return existing;
+            }
+            slot = (slot + 1) & (ADDON_NAME_SLOTS - 1);
+        }
+
+        size_t count = gAddonNameCount.load(std::memory_order_relaxed);
+        if (count >= MAX_ADDON_NAMES) {
+            return ADDON_NONE;
+        }
+
+        auto *copy = static_cast<char *>(gAddonNameArena.allocate(length + 1, 1));
+        if (copy == nullptr) {
+            return ADDON_NONE;
+        }
+        std::memcpy(copy, name, length);
+        copy[length] = '\0';
+
+        auto id = static_cast<AddonId>(count);
+        gAddonNames[id] = copy;
+        gAddonNameLengths[id] = length;
+        gAddonNameSlots[slot] = id;
+        // Publish the name before the id can be seen by the stats worker
+        gAddonNameCount.store(count + 1, std::memory_order_release);
+        return id;
+    }
+
+    const char *GetAddonName(AddonId id) {
+        return gAddonNames[id];
+    }
+
+    size_t GetAddonNameCount() {
+        return gAddonNameCount.load(std::memory_order_acquire);
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace perf_monitor {
+    // Small dense id for an interned addon or frame name
+    using AddonId = uint16_t;
+
+    constexpr AddonId ADDON_NONE = 0xFFFF;
+    constexpr size_t MAX_ADDON_NAMES = 4096;
+    constexpr size_t ADDON_NAME_BYTES = 1024 * 1024;
+
+    // Returns the id for name, adding it on first sight.  Game thread only.  Returns ADDON_NONE
+    // for empty names, or once MAX_ADDON_NAMES distinct names or ADDON_NAME_BYTES of them have been seen.
+    AddonId InternAddonName(const char *name, size_t length);
+
+    // Names are never removed, so any id handed out stays valid from every thread
+    const char *GetAddonName(AddonId id);
+
+    // Number of ids handed out so far
+    size_t GetAddonNameCount();
+}
@@ -0,0 +1,185 @@
+#include "call_tree.hpp"
+#include "stats.hpp"
+#include "thread_shards.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace perf_monitor {
+    struct CallTreeNode {
+        CallFrameKey key;
+        std::atomic<CallTreeNodeId> firstChild;
+        std::atomic<CallTreeNodeId> nextSibling;
+    };
+
+    struct ShadowFrame {
+        CallTreeNodeId node;
+        uint64_t childTime; // inclusive time of the hooked calls made from this frame so far
+        uint64_t splitTime; // part of this frame's time already charged to a frame split
+    };
+
+    // frames[0] is the root, depth past MAX_CALL_DEPTH is only counted so enter and leave stay paired
+    struct ShadowStack {
+        ShadowFrame frames[MAX_CALL_DEPTH + 1];
+        int depth;
+    };
+
+    static CallTreeNode gCallTreeNodes[MAX_CALL_TREE_NODES];
+    static std::atomic<size_t> gCallTreeNodeCount{1};
+    // Only taken when a call path is seen for the first time
+    static std::atomic_flag gCallTreeInsertLock = ATOMIC_FLAG_INIT;
+
+    static thread_local ShadowStack tShadowStack;
+
+    static CallTreeNodeId FindChild(CallTreeNodeId parent, CallFrameKey key) {
+        CallTreeNodeId child = gCallTreeNodes[parent].firstChild.load(std::memory_order_acquire);
+        while (child != CALL_TREE_ROOT) {
+            if (gCallTreeNodes[child].key == key) {
+                return child;
+            }
+            child = gCallTreeNodes[child].nextSibling.load(std::memory_order_acquire);
+        }
+        return CALL_TREE_ROOT;
+    }
+
+    // Returns parent itself once the node table is full
+    static CallTreeNodeId FindOrAddChild(CallTreeNodeId parent, CallFrameKey key) {
+        CallTreeNodeId child = FindChild(parent, key);
+        if (child != CALL_TREE_ROOT) {
+            return child;
+        }
+
+        while (gCallTreeInsertLock.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        // Another thread may have added it while we waited
+        child = FindChild(parent, key);
+        if (child == CALL_TREE_ROOT) {
+            size_t count = gCallTreeNodeCount.load(std::memory_order_relaxed);
+            if (count < MAX_CALL_TREE_NODES) {
+                child = static_cast<CallTreeNodeId>(count);
+                CallTreeNode &node = gCallTreeNodes[child];
+                node.key = key;
+                node.nextSibling.store(gCallTreeNodes[parent].firstChild.load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
+                // Publish the node before it can be reached from its parent
+                gCallTreeNodeCount.store(count + 1, std::memory_order_release);
+                gCallTreeNodes[parent].firstChild.store(child, std::memory_order_release);
+            } else {
+                child = parent;
+            }
+        }
+
+        gCallTreeInsertLock.clear(std::memory_order_release);
+        return child;
+    }
+
+    static void EnterFrame(CallFrameKey key) {
+        // The window's node stats are plain counters, other threads only get the flat metrics
+        if (!IsGameThread()) {
+            return;
+        }
+        ShadowStack &stack = tShadowStack;
+        if (stack.depth >= MAX_CALL_DEPTH) {
+            ++stack.depth;
+            return;
+        }
+
+        CallTreeNodeId parent = stack.frames[stack.depth].node;
+        CallTreeNodeId node = parent;
+        if (parent == CALL_TREE_ROOT || gCallTreeNodes[parent].key != key) {
+            node = FindOrAddChild(parent, key);
+        }
+
+        ShadowFrame &frame = stack.frames[++stack.depth];
+        frame.node = node;
+        frame.childTime = 0;
+        frame.splitTime = 0;
+    }
+
+    void CallTreeEnter(MetricId id) {
+        EnterFrame(MakeCallFrameKey(CALL_FRAME_METRIC, id));
+    }
+
+    void CallTreeEnterAddon(CallFrameKind kind, AddonId addonId) {
+        EnterFrame(MakeCallFrameKey(kind, addonId));
+    }
+
+    void CallTreeLeave(uint64_t duration) {
+        if (!IsGameThread()) {
+            return;
+        }
+        ShadowStack &stack = tShadowStack;
+        if (stack.depth > MAX_CALL_DEPTH) {
+            --stack.depth;
+            return;
+        }
+        if (stack.depth == 0) {
+            return;
+        }
+
+        const ShadowFrame &frame = stack.frames[stack.depth--];
+        ShadowFrame &caller = stack.frames[stack.depth];
+
+        // Folded into the caller, which already times this span, only pass the children up
+        if (frame.node == caller.node) {
+            caller.childTime += frame.childTime;
+            caller.splitTime += frame.splitTime;
+            return;
+        }
+
+        CallTreeNodeStats &stats = ActiveStats().callTree.nodes[frame.node];
+        stats.inclusiveTime += duration;
+        stats.selfTime += duration > frame.childTime ? duration - frame.childTime : 0;
+        stats.count++;
+
+        caller.childTime += duration;
+        caller.splitTime += frame.splitTime;
+    }
+
+    uint64_t CallTreeSplitSelfTime(uint64_t duration) {
+        if (!IsGameThread()) {
+            return duration;
+        }
+        ShadowStack &stack = tShadowStack;
+        // Untracked past the maximum depth, charge the whole span
+        if (stack.depth == 0 || stack.depth > MAX_CALL_DEPTH) {
+            return duration;
+        }
+
+        ShadowFrame &frame = stack.frames[stack.depth];
+        uint64_t selfTime = duration > frame.splitTime ? duration - frame.splitTime : 0;
+        // All of it is charged now, the enclosing split hook only gets what is left
+        frame.splitTime = duration;
+        return selfTime;
+    }
+
+    size_t GetCallTreeNodeCount() {
+        return gCallTreeNodeCount.load(std::memory_order_acquire);
+    }
+
+    CallFrameKey GetCallTreeNodeKey(CallTreeNodeId node) {
+        return gCallTreeNodes[node].key;
+    }
+
+    std::string GetCallFrameName(CallFrameKey key) {
+        auto id = static_cast<uint16_t>(key & 0xFFFF);
+        switch (static_cast<CallFrameKind>(key >> 16)) {
+            case CALL_FRAME_ADDON_ON_UPDATE:
+                return std::string(GetAddonName(id)) + " OnUpdate";
+            case CALL_FRAME_ADDON_ON_EVENT:
+                return std::string(GetAddonName(id)) + " OnEvent";
+            default:
+                return kMetricInfo[id].name;
+        }
+    }
+
+    CallTreeNodeId GetCallTreeFirstChild(CallTreeNodeId node) {
+        return gCallTreeNodes[node].firstChild.load(std::memory_order_acquire);
+    }
+
+    CallTreeNodeId GetCallTreeNextSibling(CallTreeNodeId node) {
+        return gCallTreeNodes[node].nextSibling.load(std::memory_order_acquire);
+    }
+}
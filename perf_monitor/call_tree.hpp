@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "addon_names.hpp"
+
+namespace perf_monitor {
+    // Forward declarations
+    enum MetricId : uint16_t;
+
+    enum CallFrameKind : uint32_t {
+        CALL_FRAME_METRIC,
+        CALL_FRAME_ADDON_ON_UPDATE,
+        CALL_FRAME_ADDON_ON_EVENT,
+    };
+
+    // One frame of a call path, a hooked function or an addon handler, as kind << 16 | id
+    using CallFrameKey = uint32_t;
+
+    inline CallFrameKey MakeCallFrameKey(CallFrameKind kind, uint16_t id) {
+        return (static_cast<uint32_t>(kind) << 16) | id;
+    }
+
+    // Index into the call tree shared by every window, node 0 is the root and is never a child.
+    // A node id stands for its whole path, so paths are aggregated without ever building a string.
+    using CallTreeNodeId = uint16_t;
+
+    constexpr CallTreeNodeId CALL_TREE_ROOT = 0;
+    constexpr size_t MAX_CALL_TREE_NODES = 4096;
+    constexpr int MAX_CALL_DEPTH = 32;
+
+    // Cost of one call path during a window, durations in timer ticks
+    struct CallTreeNodeStats {
+        uint64_t inclusiveTime; // time between entering and leaving the hook
+        uint64_t selfTime;      // inclusive time minus the inclusive time of hooked children
+        uint64_t count;
+    };
+
+    // Per window side of the call tree, indexed by CallTreeNodeId so a reset is one memset
+    struct CallTreeWindow {
+        CallTreeNodeStats nodes[MAX_CALL_TREE_NODES];
+
+        void clear() {
+            std::memset(nodes, 0, sizeof(nodes));
+        }
+    };
+
+    // Called around every timed hook.  Each thread keeps a shadow stack of the hooks it is inside
+    // of, entering a hook finds (or adds) the child node of the current path and leaving it charges
+    // the duration to that node of the active window.  Direct recursion folds into the caller's
+    // node so recursive frame rendering doesn't grow the tree without bound.
+    void CallTreeEnter(MetricId id);
+
+    // Same for an addon handler, nested inside the hook that runs it
+    void CallTreeEnterAddon(CallFrameKind kind, AddonId addonId);
+
+    void CallTreeLeave(uint64_t duration);
+
+    // Called by a hook that charges a frame split, before its CallTreeLeave.  Returns the duration
+    // minus the time hooks nested in it already charged to a split, so each split holds self time
+    // and the splits of a frame never overlap.
+    uint64_t CallTreeSplitSelfTime(uint64_t duration);
+
+    // Nodes are never removed, anything below GetCallTreeNodeCount can be walked from any thread
+    size_t GetCallTreeNodeCount();
+
+    CallFrameKey GetCallTreeNodeKey(CallTreeNodeId node);
+
+    // "PaintScreen", "pfUI OnUpdate", ...  Allocates, not for the hooks.
+    std::string GetCallFrameName(CallFrameKey key);
+
+    // CALL_TREE_ROOT when there is none
+    CallTreeNodeId GetCallTreeFirstChild(CallTreeNodeId node);
+
+    CallTreeNodeId GetCallTreeNextSibling(CallTreeNodeId node);
+}
@@ -7,6 +7,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 #include <logging.hpp>
 
 namespace perf_monitor {
@@ -69,9 +70,9 @@ namespace perf_monitor {
 
         class CDataStore &GetDataInSitu(void *&, unsigned int);
 
-        void CDataStore::GetPackedGuid(uint64_t &val);
+        void GetPackedGuid(uint64_t &val);
 
-        void CDataStore::PutPackedGuid(uint64_t guid);
+        void PutPackedGuid(uint64_t guid);
 
             template<typename T>
         void Set(unsigned int pos, T val) {
@@ -161,14 +162,14 @@ namespace perf_monitor {
                     count = m_read + len;
                     if (count > m_size) {
                         m_read = m_size + sizeof(T);
-                        return *this;
+                        return;
                     }
 
                     // check to make sure we can read
                     if ((m_read < (unsigned int) m_base) || (count > m_base + m_alloc)) {
                         if (!AssertFetchRead(m_read, len)) {
                             m_read = m_size + sizeof(T);
-                            return *this;
+                            return;
                         }
                     }
                     if (pVal != (T *) (m_buffer - m_base + m_read)) {
@@ -0,0 +1,140 @@
+#include "config.hpp"
+#include "logging.hpp"
+#include "metric_sampler.hpp"
+
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+
+namespace perf_monitor {
+    Config gConfig;
+    // Modification time of the config file when it was last read
+    static std::time_t gConfigModifiedTime = 0;
+
+    struct ConfigKey {
+        const char *name;
+        double Config::*field;
+    };
+
+    static const ConfigKey kConfigKeys[] = {
+            {"hitch_threshold_ms",      &Config::hitchThresholdMs},
+            {"trace_start_seconds",     &Config::traceStartSeconds},
+            {"trace_seconds",           &Config::traceSeconds},
+            {"report_ndjson",           &Config::reportNdjson},
+            {"report_csv",              &Config::reportCsv},
+            {"report_addon_events",     &Config::reportAddonEvents},
+            {"sample_random",           &Config::sampleRandom},
+            {"tier_render_detail",      &Config::tierRenderDetail},
+            {"tier_memory",             &Config::tierMemory},
+            {"overhead_budget_percent", &Config::overheadBudgetPercent},
+            {"aggregator_thread",       &Config::aggregatorThread},
+    };
+
+    static std::string Trim(const std::string &text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            return "";
+        }
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    static bool ParseConfigNumber(const std::string &key, const std::string &value, double &parsed) {
+        char *end = nullptr;
+        parsed = std::strtod(value.c_str(), &end);
+        if (end == value.c_str() || *end != '\0' || parsed < 0) {
+            DEBUG_LOG("Config: bad value for " << key << ": " << value);
+            return false;
+        }
+        return true;
+    }
+
+    static bool ApplyConfigValue(Config &config, const std::string &key, const std::string &value) {
+        for (const auto &entry: kConfigKeys) {
+            if (key != entry.name) {
+                continue;
+            }
+            double parsed;
+            if (!ParseConfigNumber(key, value, parsed)) {
+                return false;
+            }
+            config.*entry.field = parsed;
+            return true;
+        }
+
+        static const std::string kSamplePrefix = "sample.";
+        if (key.compare(0, kSamplePrefix.size(), kSamplePrefix) == 0) {
+            double parsed;
+            if (!ParseConfigNumber(key, value, parsed)) {
+                return false;
+            }
+            if (parsed < 1 || parsed > 1000000) {
+                DEBUG_LOG("Config: bad value for " << key << ": " << value);
+                return false;
+            }
+            if (!SetMetricSampleEvery(key.substr(kSamplePrefix.size()), static_cast<uint32_t>(parsed))) {
+                DEBUG_LOG("Config: " << key << " is not a hook that can be sampled");
+                return false;
+            }
+            return true;
+        }
+
+        DEBUG_LOG("Config: unknown key " << key);
+        return false;
+    }
+
+    static std::time_t ConfigModifiedTime(const char *path) {
+        struct stat info;
+        return stat(path, &info) == 0 ? info.st_mtime : 0;
+    }
+
+    static bool ReadConfigFile(const char *path, Config &config) {
+        std::ifstream file(path);
+        if (!file) {
+            return false;
+        }
+        gConfigModifiedTime = ConfigModifiedTime(path);
+
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) {
+                line.erase(comment);
+            }
+            size_t equals = line.find('=');
+            if (equals == std::string::npos) {
+                continue;
+            }
+
+            std::string key = Trim(line.substr(0, equals));
+            std::string value = Trim(line.substr(equals + 1));
+            if (ApplyConfigValue(config, key, value)) {
+                DEBUG_LOG("Config: " << key << " = " << value);
+            }
+        }
+        return true;
+    }
+
+    bool LoadConfigFile(const char *path) {
+        return ReadConfigFile(path, gConfig);
+    }
+
+    bool ReloadConfigFileIfChanged(const char *path) {
+        std::time_t modified = ConfigModifiedTime(path);
+        if (modified == 0 || modified == gConfigModifiedTime) {
+            return false;
+        }
+
+        DEBUG_LOG("Config: " << path << " changed, reloading");
+        // Read in full before it replaces gConfig, nothing ever sees the defaults half way through
+        Config config;
+        ResetMetricSampling();
+        if (!ReadConfigFile(path, config)) {
+            return false;
+        }
+        gConfig = config;
+        return true;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace perf_monitor {
+    // Settings read from perf_monitor.cfg next to WoW.exe, every field keeps its default when the
+    // file or the key is missing
+    struct Config {
+        double hitchThresholdMs = 50.0; // frames at least this slow are written to the hitch log, 0 disables
+        double traceStartSeconds = 0.0; // delay after loading before the Chrome trace starts
+        double traceSeconds = 0.0;      // length of the Chrome trace, 0 disables
+        double reportNdjson = 1.0;      // every window as one JSON line in perf_monitor_windows.ndjson, 0 disables
+        double reportCsv = 0.0;         // every window as CSV rows in perf_monitor_windows.csv, 0 disables
+        double reportAddonEvents = 0.0; // slowest addon x event cells per window in perf_monitor_addon_events.csv, 0 disables
+        double sampleRandom = 0.0;      // sampled hooks time each call with probability 1/N instead of every Nth
+        double tierRenderDetail = 1.0;  // nested world/scene/model render and update hooks, 0 disables
+        double tierMemory = 1.0;        // Lua memory delta of every addon handler, 0 disables
+        double overheadBudgetPercent = 2.0; // monitor cost as % of the window before it backs off, 0 disables
+        double aggregatorThread = 0.0;  // game thread hooks only queue records, a separate thread updates the stats
+    };
+
+    extern Config gConfig;
+
+    // Reads "key = value" lines, '#' starts a comment.  "sample.<hook name> = N" sets the sample
+    // interval of a render hook, see metric_sampler.hpp.  Unknown keys and bad values are logged and
+    // skipped.  Returns false if the file couldn't be opened.
+    bool LoadConfigFile(const char *path);
+
+    // Resets every setting to its default and reads the file again if it changed since it was
+    // last loaded.  Returns true if it was read.
+    bool ReloadConfigFileIfChanged(const char *path);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include "addon_names.hpp"
+#include "monitor_arena.hpp"
+
+namespace perf_monitor {
+    // Cost of one addon handling one event code during a window, durations in timer ticks
+    struct AddonEventCell {
+        uint64_t totalTime;
+        uint64_t maxTime;
+        uint32_t count;
+    };
+
+    // Addon x event code cost matrix.  Each addon row is split into blocks of 64 event slots that are
+    // only allocated once the addon handles an event in that range, so the matrix stays small even
+    // though most addons register for a handful of events.  Rows and blocks come from the window's
+    // arena, a clear just forgets them and the window rewinds the arena.
+    class AddonEventMatrix {
+    public:
+        static constexpr int BLOCK_BITS = 6;
+        static constexpr int BLOCK_SIZE = 1 << BLOCK_BITS;
+        static constexpr int ROW_BLOCKS = 16; // up to 1024 event slots, checked against EVENT_CODE_SLOTS
+
+        struct Block {
+            AddonEventCell cells[BLOCK_SIZE];
+        };
+
+        struct Row {
+            Block *blocks[ROW_BLOCKS];
+        };
+
+        explicit AddonEventMatrix(MonitorArena &arena) : arena(arena) {}
+
+        // False if the arena had no room left for the cell's block
+        bool record(AddonId addonId, int eventSlot, uint64_t duration) {
+            Row *row = rows[addonId];
+            if (row == nullptr) {
+                row = arena.create<Row>();
+                if (row == nullptr) {
+                    return false;
+                }
+                rows[addonId] = row;
+                if (addonId >= rowCount) {
+                    rowCount = static_cast<size_t>(addonId) + 1;
+                }
+            }
+            Block *&block = row->blocks[eventSlot >> BLOCK_BITS];
+            if (block == nullptr) {
+                block = arena.create<Block>();
+                if (block == nullptr) {
+                    return false;
+                }
+            }
+
+            AddonEventCell &cell = block->cells[eventSlot & (BLOCK_SIZE - 1)];
+            cell.totalTime += duration;
+            cell.count++;
+            if (duration > cell.maxTime) {
+                cell.maxTime = duration;
+            }
+            return true;
+        }
+
+        // Calls fn(addonId, eventSlot, cell) for every cell that saw at least one call
+        template<typename Fn>
+        void forEachCell(Fn fn) const {
+            for (size_t addon = 0; addon < rowCount; ++addon) {
+                const Row *row = rows[addon];
+                if (row == nullptr) {
+                    continue;
+                }
+                for (int blockIndex = 0; blockIndex < ROW_BLOCKS; ++blockIndex) {
+                    const Block *block = row->blocks[blockIndex];
+                    if (block == nullptr) {
+                        continue;
+                    }
+                    for (int i = 0; i < BLOCK_SIZE; ++i) {
+                        const AddonEventCell &cell = block->cells[i];
+                        if (cell.count > 0) {
+                            fn(static_cast<AddonId>(addon), (blockIndex << BLOCK_BITS) + i, cell);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Forgets every row, their memory goes back with the window's arena
+        void clear() {
+            std::fill(rows, rows + rowCount, nullptr);
+            rowCount = 0;
+        }
+
+    private:
+        MonitorArena &arena;
+        Row *rows[MAX_ADDON_NAMES] = {};
+        size_t rowCount = 0; // one past the highest addon with a row
+    };
+}
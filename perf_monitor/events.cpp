@@ -1,484 +1,536 @@
 #include "events.hpp"
-#include <queue>
+#include <ostream>
 
 namespace perf_monitor {
-    // Event tracking globals - definitions
-    std::map<EVENT_ID, FunctionStats> gEventStats = {
-        {EVENT_ID_CAPTURECHANGED,     FunctionStats("EVT_CAPTURECHANGED")},
-        {EVENT_ID_CHAR,               FunctionStats("EVT_CHAR")},
-        {EVENT_ID_FOCUS,              FunctionStats("EVT_FOCUS")},
-        {EVENT_ID_CLOSE,              FunctionStats("EVT_CLOSE")},
-        {EVENT_ID_DESTROY,            FunctionStats("EVT_DESTROY")},
-        {EVENT_ID_IDLE,               FunctionStats("EVT_IDLE")},
-        {EVENT_ID_POLL,               FunctionStats("EVT_POLL")},
-        {EVENT_ID_INITIALIZE,         FunctionStats("EVT_INITIALIZE")},
-        {EVENT_ID_KEYDOWN,            FunctionStats("EVT_KEYDOWN")},
-        {EVENT_ID_KEYUP,              FunctionStats("EVT_KEYUP")},
-        {EVENT_ID_KEYDOWN_REPEATING,  FunctionStats("EVT_KEYDOWN_REPEATING")},
-        {EVENT_ID_MOUSEDOWN,          FunctionStats("EVT_MOUSEDOWN")},
-        {EVENT_ID_MOUSEMOVE,          FunctionStats("EVT_MOUSEMOVE")},
-        {EVENT_ID_MOUSEMOVE_RELATIVE, FunctionStats("EVT_MOUSEMOVE_RELATIVE")},
-        {EVENT_ID_MOUSEUP,            FunctionStats("EVT_MOUSEUP")},
-        {EVENT_ID_MOUSEMODE_CHANGED,  FunctionStats("EVT_MOUSEMODE_CHANGED")},
-        {EVENT_ID_MOUSEWHEEL,         FunctionStats("EVT_MOUSEWHEEL")},
-        {EVENT_ID_PAINT,              FunctionStats("EVT_PAINT")},
-        {EVENT_ID_NET_DATA,           FunctionStats("EVT_NET_DATA")},
-        {EVENT_ID_NET_CONNECT,        FunctionStats("EVT_NET_CONNECT")},
-        {EVENT_ID_NET_DISCONNECT,     FunctionStats("EVT_NET_DISCONNECT")},
-        {EVENT_ID_NET_CANTCONNECT,    FunctionStats("EVT_NET_CANTCONNECT")},
-        {EVENT_ID_NET_DESTROY,        FunctionStats("EVT_NET_DESTROY")},
-        {EVENT_ID_CONSOLE_INPUT,      FunctionStats("EVT_CONSOLE_INPUT")},
-        {EVENT_ID_ENGINENET,          FunctionStats("EVT_ENGINENET")},
-        {EVENT_ID_BATTLENET,          FunctionStats("EVT_BATTLENET")},
-        {EVENT_ID_WOW_Q_IDLE,         FunctionStats("EVT_WOW_Q_IDLE")},
-        {EVENT_ID_IME,                FunctionStats("EVT_IME")},
-        {EVENT_ID_SIZE,               FunctionStats("EVT_SIZE")}
+    static_assert(EVENTIDS == EVENT_ID_COUNT, "EVENT_ID_COUNT in stats.hpp is out of date");
+    static_assert(EVENT_CODE_SLOTS <= AddonEventMatrix::ROW_BLOCKS * AddonEventMatrix::BLOCK_SIZE,
+                  "AddonEventMatrix rows are too short for every event code slot");
+
+    // Names of the per event stats every window starts from
+    struct NamedEvent {
+        EVENT_ID id;
+        const char *name;
+    };
+
+    static const NamedEvent kNamedEvents[] = {
+        {EVENT_ID_CAPTURECHANGED,     "EVT_CAPTURECHANGED"},
+        {EVENT_ID_CHAR,               "EVT_CHAR"},
+        {EVENT_ID_FOCUS,              "EVT_FOCUS"},
+        {EVENT_ID_CLOSE,              "EVT_CLOSE"},
+        {EVENT_ID_DESTROY,            "EVT_DESTROY"},
+        {EVENT_ID_IDLE,               "EVT_IDLE"},
+        {EVENT_ID_POLL,               "EVT_POLL"},
+        {EVENT_ID_INITIALIZE,         "EVT_INITIALIZE"},
+        {EVENT_ID_KEYDOWN,            "EVT_KEYDOWN"},
+        {EVENT_ID_KEYUP,              "EVT_KEYUP"},
+        {EVENT_ID_KEYDOWN_REPEATING,  "EVT_KEYDOWN_REPEATING"},
+        {EVENT_ID_MOUSEDOWN,          "EVT_MOUSEDOWN"},
+        {EVENT_ID_MOUSEMOVE,          "EVT_MOUSEMOVE"},
+        {EVENT_ID_MOUSEMOVE_RELATIVE, "EVT_MOUSEMOVE_RELATIVE"},
+        {EVENT_ID_MOUSEUP,            "EVT_MOUSEUP"},
+        {EVENT_ID_MOUSEMODE_CHANGED,  "EVT_MOUSEMODE_CHANGED"},
+        {EVENT_ID_MOUSEWHEEL,         "EVT_MOUSEWHEEL"},
+        {EVENT_ID_PAINT,              "EVT_PAINT"},
+        {EVENT_ID_NET_DATA,           "EVT_NET_DATA"},
+        {EVENT_ID_NET_CONNECT,        "EVT_NET_CONNECT"},
+        {EVENT_ID_NET_DISCONNECT,     "EVT_NET_DISCONNECT"},
+        {EVENT_ID_NET_CANTCONNECT,    "EVT_NET_CANTCONNECT"},
+        {EVENT_ID_NET_DESTROY,        "EVT_NET_DESTROY"},
+        {EVENT_ID_CONSOLE_INPUT,      "EVT_CONSOLE_INPUT"},
+        {EVENT_ID_ENGINENET,          "EVT_ENGINENET"},
+        {EVENT_ID_BATTLENET,          "EVT_BATTLENET"},
+        {EVENT_ID_WOW_Q_IDLE,         "EVT_WOW_Q_IDLE"},
+        {EVENT_ID_IME,                "EVT_IME"},
+        {EVENT_ID_SIZE,               "EVT_SIZE"}
     };
     
-    std::map<std::string, FunctionStats> gAddonStats;
-    std::map<std::string, FunctionStats> gAddonScriptEventStats;
-    std::map<std::string, std::priority_queue<EventStats>> gAddonSlowEvents;
     int gLastEventCode = -1;
     
     // Per-event code duration tracking
-    std::map<int, FunctionStats> gEventCodeStats;
-    std::map<int, std::chrono::high_resolution_clock::time_point> gEventCodeStartTimes;
+    uint64_t gEventCodeStartTimes[EVENT_CODE_SLOTS]; // start timestamps in timer ticks, 0 when not running
+
+    struct EventNameEntry {
+        uint32_t code;
+        const char *name;
+    };
+
+    constexpr EventNameEntry kEventNameEntries[] = {
+            {Events::UNIT_PET_01, "UNIT_PET"},
+            {Events::UNIT_PET_02, "UNIT_PET"},
+            {Events::UNIT_HEALTH, "UNIT_HEALTH"},
+            {Events::UNIT_MANA_01, "UNIT_MANA"},
+            {Events::UNIT_RAGE, "UNIT_RAGE"},
+            {Events::UNIT_FOCUS, "UNIT_FOCUS"},
+            {Events::UNIT_ENERGY, "UNIT_ENERGY"},
+            {Events::UNIT_HAPPINESS, "UNIT_HAPPINESS"},
+            {Events::UNIT_MAXHEALTH, "UNIT_MAXHEALTH"},
+            {Events::UNIT_MAXMANA, "UNIT_MAXMANA"},
+            {Events::UNIT_MAXRAGE, "UNIT_MAXRAGE"},
+            {Events::UNIT_MAXFOCUS, "UNIT_MAXFOCUS"},
+            {Events::UNIT_MAXENERGY, "UNIT_MAXENERGY"},
+            {Events::UNIT_MAXHAPPINESS, "UNIT_MAXHAPPINESS"},
+            {Events::UNIT_LEVEL, "UNIT_LEVEL"},
+            {Events::UNIT_FACTION, "UNIT_FACTION"},
+            {Events::UNIT_DISPLAYPOWER, "UNIT_DISPLAYPOWER"},
+            {Events::UNIT_FLAGS, "UNIT_FLAGS"},
+            {Events::UNIT_AURA_01, "UNIT_AURA"},
+            {Events::UNIT_AURA_02, "UNIT_AURA"},
+            {Events::UNIT_ATTACK_SPEED_01, "UNIT_ATTACK_SPEED"},
+            {Events::UNIT_ATTACK_SPEED_02, "UNIT_ATTACK_SPEED"},
+            {Events::UNIT_RANGEDDAMAGE_01, "UNIT_RANGEDDAMAGE"},
+            {Events::UNIT_DAMAGE_01, "UNIT_DAMAGE"},
+            {Events::UNIT_DAMAGE_02, "UNIT_DAMAGE"},
+            {Events::UNIT_DAMAGE_03, "UNIT_DAMAGE"},
+            {Events::UNIT_DAMAGE_04, "UNIT_DAMAGE"},
+            {Events::UNIT_LOYALTY, "UNIT_LOYALTY"},
+            {Events::UNIT_PET_EXPERIENCE_01, "UNIT_PET_EXPERIENCE"},
+            {Events::UNIT_PET_EXPERIENCE_02, "UNIT_PET_EXPERIENCE"},
+            {Events::UNIT_DYNAMIC_FLAGS, "UNIT_DYNAMIC_FLAGS"},
+            {Events::UNIT_PET_TRAINING_POINTS, "UNIT_PET_TRAINING_POINTS"},
+            {Events::UNIT_STATS_01, "UNIT_STATS"},
+            {Events::UNIT_STATS_02, "UNIT_STATS"},
+            {Events::UNIT_STATS_03, "UNIT_STATS"},
+            {Events::UNIT_STATS_04, "UNIT_STATS"},
+            {Events::UNIT_STATS_05, "UNIT_STATS"},
+            {Events::UNIT_RESISTANCES_01, "UNIT_RESISTANCES"},
+            {Events::UNIT_RESISTANCES_02, "UNIT_RESISTANCES"},
+            {Events::UNIT_RESISTANCES_03, "UNIT_RESISTANCES"},
+            {Events::UNIT_RESISTANCES_04, "UNIT_RESISTANCES"},
+            {Events::UNIT_RESISTANCES_05, "UNIT_RESISTANCES"},
+            {Events::UNIT_RESISTANCES_06, "UNIT_RESISTANCES"},
+            {Events::UNIT_RESISTANCES_07, "UNIT_RESISTANCES"},
+            {Events::UNIT_ATTACK_POWER_01, "UNIT_ATTACK_POWER"},
+            {Events::UNIT_ATTACK_POWER_02, "UNIT_ATTACK_POWER"},
+            {Events::UNIT_ATTACK_POWER_03, "UNIT_ATTACK_POWER"},
+            {Events::UNIT_RANGED_ATTACK_POWER_01, "UNIT_RANGED_ATTACK_POWER"},
+            {Events::UNIT_RANGED_ATTACK_POWER_02, "UNIT_RANGED_ATTACK_POWER"},
+            {Events::UNIT_RANGED_ATTACK_POWER_03, "UNIT_RANGED_ATTACK_POWER"},
+            {Events::UNIT_RANGEDDAMAGE_02, "UNIT_RANGEDDAMAGE"},
+            {Events::UNIT_RANGEDDAMAGE_03, "UNIT_RANGEDDAMAGE"},
+            {Events::UNIT_MANA1, "UNIT_MANA1"},
+            {Events::UNIT_MANA2, "UNIT_MANA2"},
+            {Events::UNIT_COMBAT, "UNIT_COMBAT"},
+            {Events::UNIT_NAME_UPDATE, "UNIT_NAME_UPDATE"},
+            {Events::UNIT_PORTRAIT_UPDATE, "UNIT_PORTRAIT_UPDATE"},
+            {Events::UNIT_MODEL_CHANGED, "UNIT_MODEL_CHANGED"},
+            {Events::UNIT_INVENTORY_CHANGED, "UNIT_INVENTORY_CHANGED"},
+            {Events::UNIT_CLASSIFICATION_CHANGED, "UNIT_CLASSIFICATION_CHANGED"},
+            {Events::ITEM_LOCK_CHANGED, "ITEM_LOCK_CHANGED"},
+            {Events::PLAYER_XP_UPDATE, "PLAYER_XP_UPDATE"},
+            {Events::PLAYER_REGEN_DISABLED, "PLAYER_REGEN_DISABLED"},
+            {Events::PLAYER_REGEN_ENABLED, "PLAYER_REGEN_ENABLED"},
+            {Events::PLAYER_AURAS_CHANGED, "PLAYER_AURAS_CHANGED"},
+            {Events::PLAYER_ENTER_COMBAT, "PLAYER_ENTER_COMBAT"},
+            {Events::PLAYER_LEAVE_COMBAT, "PLAYER_LEAVE_COMBAT"},
+            {Events::PLAYER_TARGET_CHANGED, "PLAYER_TARGET_CHANGED"},
+            {Events::PLAYER_CONTROL_LOST, "PLAYER_CONTROL_LOST"},
+            {Events::PLAYER_CONTROL_GAINED, "PLAYER_CONTROL_GAINED"},
+            {Events::PLAYER_FARSIGHT_FOCUS_CHANGED, "PLAYER_FARSIGHT_FOCUS_CHANGED"},
+            {Events::PLAYER_LEVEL_UP, "PLAYER_LEVEL_UP"},
+            {Events::PLAYER_MONEY, "PLAYER_MONEY"},
+            {Events::PLAYER_DAMAGE_DONE_MODS, "PLAYER_DAMAGE_DONE_MODS"},
+            {Events::PLAYER_COMBO_POINTS, "PLAYER_COMBO_POINTS"},
+            {Events::ZONE_CHANGED, "ZONE_CHANGED"},
+            {Events::ZONE_CHANGED_INDOORS, "ZONE_CHANGED_INDOORS"},
+            {Events::ZONE_CHANGED_NEW_AREA, "ZONE_CHANGED_NEW_AREA"},
+            {Events::MINIMAP_ZONE_CHANGED, "MINIMAP_ZONE_CHANGED"},
+            {Events::MINIMAP_UPDATE_ZOOM, "MINIMAP_UPDATE_ZOOM"},
+            {Events::SCREENSHOT_SUCCEEDED, "SCREENSHOT_SUCCEEDED"},
+            {Events::SCREENSHOT_FAILED, "SCREENSHOT_FAILED"},
+            {Events::ACTIONBAR_SHOWGRID, "ACTIONBAR_SHOWGRID"},
+            {Events::ACTIONBAR_HIDEGRID, "ACTIONBAR_HIDEGRID"},
+            {Events::ACTIONBAR_PAGE_CHANGED, "ACTIONBAR_PAGE_CHANGED"},
+            {Events::ACTIONBAR_SLOT_CHANGED, "ACTIONBAR_SLOT_CHANGED"},
+            {Events::ACTIONBAR_UPDATE_STATE, "ACTIONBAR_UPDATE_STATE"},
+            {Events::ACTIONBAR_UPDATE_USABLE, "ACTIONBAR_UPDATE_USABLE"},
+            {Events::ACTIONBAR_UPDATE_COOLDOWN, "ACTIONBAR_UPDATE_COOLDOWN"},
+            {Events::UPDATE_BONUS_ACTIONBAR, "UPDATE_BONUS_ACTIONBAR"},
+            {Events::PARTY_MEMBERS_CHANGED, "PARTY_MEMBERS_CHANGED"},
+            {Events::PARTY_LEADER_CHANGED, "PARTY_LEADER_CHANGED"},
+            {Events::PARTY_MEMBER_ENABLE, "PARTY_MEMBER_ENABLE"},
+            {Events::PARTY_MEMBER_DISABLE, "PARTY_MEMBER_DISABLE"},
+            {Events::PARTY_LOOT_METHOD_CHANGED, "PARTY_LOOT_METHOD_CHANGED"},
+            {Events::SYSMSG, "SYSMSG"},
+            {Events::UI_ERROR_MESSAGE, "UI_ERROR_MESSAGE"},
+            {Events::UI_INFO_MESSAGE, "UI_INFO_MESSAGE"},
+            {Events::UPDATE_CHAT_COLOR, "UPDATE_CHAT_COLOR"},
+            {Events::CHAT_MSG_ADDON, "CHAT_MSG_ADDON"},
+            {Events::CHAT_MSG_SAY, "CHAT_MSG_SAY"},
+            {Events::CHAT_MSG_PARTY, "CHAT_MSG_PARTY"},
+            {Events::CHAT_MSG_RAID, "CHAT_MSG_RAID"},
+            {Events::CHAT_MSG_GUILD, "CHAT_MSG_GUILD"},
+            {Events::CHAT_MSG_OFFICER, "CHAT_MSG_OFFICER"},
+            {Events::CHAT_MSG_YELL, "CHAT_MSG_YELL"},
+            {Events::CHAT_MSG_WHISPER, "CHAT_MSG_WHISPER"},
+            {Events::CHAT_MSG_WHISPER_INFORM, "CHAT_MSG_WHISPER_INFORM"},
+            {Events::CHAT_MSG_EMOTE, "CHAT_MSG_EMOTE"},
+            {Events::CHAT_MSG_TEXT_EMOTE, "CHAT_MSG_TEXT_EMOTE"},
+            {Events::CHAT_MSG_SYSTEM, "CHAT_MSG_SYSTEM"},
+            {Events::CHAT_MSG_MONSTER_SAY, "CHAT_MSG_MONSTER_SAY"},
+            {Events::CHAT_MSG_MONSTER_YELL, "CHAT_MSG_MONSTER_YELL"},
+            {Events::CHAT_MSG_MONSTER_WHISPER, "CHAT_MSG_MONSTER_WHISPER"},
+            {Events::CHAT_MSG_MONSTER_EMOTE, "CHAT_MSG_MONSTER_EMOTE"},
+            {Events::CHAT_MSG_CHANNEL, "CHAT_MSG_CHANNEL"},
+            {Events::CHAT_MSG_CHANNEL_JOIN, "CHAT_MSG_CHANNEL_JOIN"},
+            {Events::CHAT_MSG_CHANNEL_LEAVE, "CHAT_MSG_CHANNEL_LEAVE"},
+            {Events::CHAT_MSG_CHANNEL_LIST, "CHAT_MSG_CHANNEL_LIST"},
+            {Events::CHAT_MSG_CHANNEL_NOTICE, "CHAT_MSG_CHANNEL_NOTICE"},
+            {Events::CHAT_MSG_CHANNEL_NOTICE_USER, "CHAT_MSG_CHANNEL_NOTICE_USER"},
+            {Events::CHAT_MSG_AFK, "CHAT_MSG_AFK"},
+            {Events::CHAT_MSG_DND, "CHAT_MSG_DND"},
+            {Events::CHAT_MSG_COMBAT_LOG, "CHAT_MSG_COMBAT_LOG"},
+            {Events::CHAT_MSG_IGNORED, "CHAT_MSG_IGNORED"},
+            {Events::CHAT_MSG_SKILL, "CHAT_MSG_SKILL"},
+            {Events::CHAT_MSG_LOOT, "CHAT_MSG_LOOT"},
+            {Events::CHAT_MSG_MONEY, "CHAT_MSG_MONEY"},
+            {Events::CHAT_MSG_RAID_LEADER, "CHAT_MSG_RAID_LEADER"},
+            {Events::CHAT_MSG_RAID_WARNING, "CHAT_MSG_RAID_WARNING"},
+            {Events::LANGUAGE_LIST_CHANGED, "LANGUAGE_LIST_CHANGED"},
+            {Events::TIME_PLAYED_MSG, "TIME_PLAYED_MSG"},
+            {Events::SPELLS_CHANGED, "SPELLS_CHANGED"},
+            {Events::CURRENT_SPELL_CAST_CHANGED, "CURRENT_SPELL_CAST_CHANGED"},
+            {Events::SPELL_UPDATE_COOLDOWN, "SPELL_UPDATE_COOLDOWN"},
+            {Events::SPELL_UPDATE_USABLE, "SPELL_UPDATE_USABLE"},
+            {Events::CHARACTER_POINTS_CHANGED, "CHARACTER_POINTS_CHANGED"},
+            {Events::SKILL_LINES_CHANGED, "SKILL_LINES_CHANGED"},
+            {Events::ITEM_PUSH, "ITEM_PUSH"},
+            {Events::LOOT_OPENED, "LOOT_OPENED"},
+            {Events::LOOT_SLOT_CLEARED, "LOOT_SLOT_CLEARED"},
+            {Events::LOOT_CLOSED, "LOOT_CLOSED"},
+            {Events::PLAYER_LOGIN, "PLAYER_LOGIN"},
+            {Events::PLAYER_LOGOUT, "PLAYER_LOGOUT"},
+            {Events::PLAYER_ENTERING_WORLD, "PLAYER_ENTERING_WORLD"},
+            {Events::PLAYER_LEAVING_WORLD, "PLAYER_LEAVING_WORLD"},
+            {Events::PLAYER_ALIVE, "PLAYER_ALIVE"},
+            {Events::PLAYER_DEAD, "PLAYER_DEAD"},
+            {Events::PLAYER_CAMPING, "PLAYER_CAMPING"},
+            {Events::PLAYER_QUITING, "PLAYER_QUITING"},
+            {Events::LOGOUT_CANCEL, "LOGOUT_CANCEL"},
+            {Events::RESURRECT_REQUEST, "RESURRECT_REQUEST"},
+            {Events::PARTY_INVITE_REQUEST, "PARTY_INVITE_REQUEST"},
+            {Events::PARTY_INVITE_CANCEL, "PARTY_INVITE_CANCEL"},
+            {Events::GUILD_INVITE_REQUEST, "GUILD_INVITE_REQUEST"},
+            {Events::GUILD_INVITE_CANCEL, "GUILD_INVITE_CANCEL"},
+            {Events::GUILD_MOTD, "GUILD_MOTD"},
+            {Events::TRADE_REQUEST, "TRADE_REQUEST"},
+            {Events::TRADE_REQUEST_CANCEL, "TRADE_REQUEST_CANCEL"},
+            {Events::LOOT_BIND_CONFIRM, "LOOT_BIND_CONFIRM"},
+            {Events::EQUIP_BIND_CONFIRM, "EQUIP_BIND_CONFIRM"},
+            {Events::AUTOEQUIP_BIND_CONFIRM, "AUTOEQUIP_BIND_CONFIRM"},
+            {Events::USE_BIND_CONFIRM, "USE_BIND_CONFIRM"},
+            {Events::DELETE_ITEM_CONFIRM, "DELETE_ITEM_CONFIRM"},
+            {Events::CURSOR_UPDATE, "CURSOR_UPDATE"},
+            {Events::ITEM_TEXT_BEGIN, "ITEM_TEXT_BEGIN"},
+            {Events::ITEM_TEXT_TRANSLATION, "ITEM_TEXT_TRANSLATION"},
+            {Events::ITEM_TEXT_READY, "ITEM_TEXT_READY"},
+            {Events::ITEM_TEXT_CLOSED, "ITEM_TEXT_CLOSED"},
+            {Events::GOSSIP_SHOW, "GOSSIP_SHOW"},
+            {Events::GOSSIP_ENTER_CODE, "GOSSIP_ENTER_CODE"},
+            {Events::GOSSIP_CLOSED, "GOSSIP_CLOSED"},
+            {Events::QUEST_GREETING, "QUEST_GREETING"},
+            {Events::QUEST_DETAIL, "QUEST_DETAIL"},
+            {Events::QUEST_PROGRESS, "QUEST_PROGRESS"},
+            {Events::QUEST_COMPLETE, "QUEST_COMPLETE"},
+            {Events::QUEST_FINISHED, "QUEST_FINISHED"},
+            {Events::QUEST_ITEM_UPDATE, "QUEST_ITEM_UPDATE"},
+            {Events::TAXIMAP_OPENED, "TAXIMAP_OPENED"},
+            {Events::TAXIMAP_CLOSED, "TAXIMAP_CLOSED"},
+            {Events::QUEST_LOG_UPDATE, "QUEST_LOG_UPDATE"},
+            {Events::TRAINER_SHOW, "TRAINER_SHOW"},
+            {Events::TRAINER_UPDATE, "TRAINER_UPDATE"},
+            {Events::TRAINER_CLOSED, "TRAINER_CLOSED"},
+            {Events::CVAR_UPDATE, "CVAR_UPDATE"},
+            {Events::TRADE_SKILL_SHOW, "TRADE_SKILL_SHOW"},
+            {Events::TRADE_SKILL_UPDATE, "TRADE_SKILL_UPDATE"},
+            {Events::TRADE_SKILL_CLOSE, "TRADE_SKILL_CLOSE"},
+            {Events::MERCHANT_SHOW, "MERCHANT_SHOW"},
+            {Events::MERCHANT_UPDATE, "MERCHANT_UPDATE"},
+            {Events::MERCHANT_CLOSED, "MERCHANT_CLOSED"},
+            {Events::TRADE_SHOW, "TRADE_SHOW"},
+            {Events::TRADE_CLOSED, "TRADE_CLOSED"},
+            {Events::TRADE_UPDATE, "TRADE_UPDATE"},
+            {Events::TRADE_ACCEPT_UPDATE, "TRADE_ACCEPT_UPDATE"},
+            {Events::TRADE_TARGET_ITEM_CHANGED, "TRADE_TARGET_ITEM_CHANGED"},
+            {Events::TRADE_PLAYER_ITEM_CHANGED, "TRADE_PLAYER_ITEM_CHANGED"},
+            {Events::TRADE_MONEY_CHANGED, "TRADE_MONEY_CHANGED"},
+            {Events::PLAYER_TRADE_MONEY, "PLAYER_TRADE_MONEY"},
+            {Events::BAG_OPEN, "BAG_OPEN"},
+            {Events::BAG_UPDATE, "BAG_UPDATE"},
+            {Events::BAG_CLOSED, "BAG_CLOSED"},
+            {Events::BAG_UPDATE_COOLDOWN, "BAG_UPDATE_COOLDOWN"},
+            {Events::LOCALPLAYER_PET_RENAMED, "LOCALPLAYER_PET_RENAMED"},
+            {Events::UNIT_ATTACK, "UNIT_ATTACK"},
+            {Events::UNIT_DEFENSE, "UNIT_DEFENSE"},
+            {Events::PET_ATTACK_START, "PET_ATTACK_START"},
+            {Events::PET_ATTACK_STOP, "PET_ATTACK_STOP"},
+            {Events::UPDATE_MOUSEOVER_UNIT, "UPDATE_MOUSEOVER_UNIT"},
+            {Events::SPELLCAST_START, "SPELLCAST_START"},
+            {Events::SPELLCAST_STOP, "SPELLCAST_STOP"},
+            {Events::SPELLCAST_FAILED, "SPELLCAST_FAILED"},
+            {Events::SPELLCAST_INTERRUPTED, "SPELLCAST_INTERRUPTED"},
+            {Events::SPELLCAST_DELAYED, "SPELLCAST_DELAYED"},
+            {Events::SPELLCAST_CHANNEL_START, "SPELLCAST_CHANNEL_START"},
+            {Events::SPELLCAST_CHANNEL_UPDATE, "SPELLCAST_CHANNEL_UPDATE"},
+            {Events::SPELLCAST_CHANNEL_STOP, "SPELLCAST_CHANNEL_STOP"},
+            {Events::PLAYER_GUILD_UPDATE, "PLAYER_GUILD_UPDATE"},
+            {Events::QUEST_ACCEPT_CONFIRM, "QUEST_ACCEPT_CONFIRM"},
+            {Events::PLAYERBANKSLOTS_CHANGED, "PLAYERBANKSLOTS_CHANGED"},
+            {Events::BANKFRAME_OPENED, "BANKFRAME_OPENED"},
+            {Events::BANKFRAME_CLOSED, "BANKFRAME_CLOSED"},
+            {Events::PLAYERBANKBAGSLOTS_CHANGED, "PLAYERBANKBAGSLOTS_CHANGED"},
+            {Events::FRIENDLIST_UPDATE, "FRIENDLIST_UPDATE"},
+            {Events::IGNORELIST_UPDATE, "IGNORELIST_UPDATE"},
+            {Events::PET_BAR_UPDATE, "PET_BAR_UPDATE"},
+            {Events::PET_BAR_UPDATE_COOLDOWN, "PET_BAR_UPDATE_COOLDOWN"},
+            {Events::PET_BAR_SHOWGRID, "PET_BAR_SHOWGRID"},
+            {Events::PET_BAR_HIDEGRID, "PET_BAR_HIDEGRID"},
+            {Events::MINIMAP_PING, "MINIMAP_PING"},
+            {Events::CHAT_MSG_COMBAT_MISC_INFO, "CHAT_MSG_COMBAT_MISC_INFO"},
+            {Events::CRAFT_SHOW, "CRAFT_SHOW"},
+            {Events::CRAFT_UPDATE, "CRAFT_UPDATE"},
+            {Events::CRAFT_CLOSE, "CRAFT_CLOSE"},
+            {Events::MIRROR_TIMER_START, "MIRROR_TIMER_START"},
+            {Events::MIRROR_TIMER_PAUSE, "MIRROR_TIMER_PAUSE"},
+            {Events::MIRROR_TIMER_STOP, "MIRROR_TIMER_STOP"},
+            {Events::WORLD_MAP_UPDATE, "WORLD_MAP_UPDATE"},
+            {Events::WORLD_MAP_NAME_UPDATE, "WORLD_MAP_NAME_UPDATE"},
+            {Events::AUTOFOLLOW_BEGIN, "AUTOFOLLOW_BEGIN"},
+            {Events::AUTOFOLLOW_END, "AUTOFOLLOW_END"},
+            {Events::SPELL_QUEUE_EVENT, "SPELL_QUEUE_EVENT"},
+            {Events::CINEMATIC_START, "CINEMATIC_START"},
+            {Events::CINEMATIC_STOP, "CINEMATIC_STOP"},
+            {Events::UPDATE_FACTION, "UPDATE_FACTION"},
+            {Events::CLOSE_WORLD_MAP, "CLOSE_WORLD_MAP"},
+            {Events::OPEN_TABARD_FRAME, "OPEN_TABARD_FRAME"},
+            {Events::CLOSE_TABARD_FRAME, "CLOSE_TABARD_FRAME"},
+            {Events::TABARD_CANSAVE_CHANGED, "TABARD_CANSAVE_CHANGED"},
+            {Events::SHOW_COMPARE_TOOLTIP, "SHOW_COMPARE_TOOLTIP"},
+            {Events::GUILD_REGISTRAR_SHOW, "GUILD_REGISTRAR_SHOW"},
+            {Events::GUILD_REGISTRAR_CLOSED, "GUILD_REGISTRAR_CLOSED"},
+            {Events::DUEL_REQUESTED, "DUEL_REQUESTED"},
+            {Events::DUEL_OUTOFBOUNDS, "DUEL_OUTOFBOUNDS"},
+            {Events::DUEL_INBOUNDS, "DUEL_INBOUNDS"},
+            {Events::DUEL_FINISHED, "DUEL_FINISHED"},
+            {Events::TUTORIAL_TRIGGER, "TUTORIAL_TRIGGER"},
+            {Events::PET_DISMISS_START, "PET_DISMISS_START"},
+            {Events::UPDATE_BINDINGS, "UPDATE_BINDINGS"},
+            {Events::UPDATE_SHAPESHIFT_FORMS, "UPDATE_SHAPESHIFT_FORMS"},
+            {Events::WHO_LIST_UPDATE, "WHO_LIST_UPDATE"},
+            {Events::UPDATE_LFG, "UPDATE_LFG"},
+            {Events::PETITION_SHOW, "PETITION_SHOW"},
+            {Events::PETITION_CLOSED, "PETITION_CLOSED"},
+            {Events::EXECUTE_CHAT_LINE, "EXECUTE_CHAT_LINE"},
+            {Events::UPDATE_MACROS, "UPDATE_MACROS"},
+            {Events::UPDATE_TICKET, "UPDATE_TICKET"},
+            {Events::UPDATE_CHAT_WINDOWS, "UPDATE_CHAT_WINDOWS"},
+            {Events::CONFIRM_XP_LOSS, "CONFIRM_XP_LOSS"},
+            {Events::CORPSE_IN_RANGE, "CORPSE_IN_RANGE"},
+            {Events::CORPSE_IN_INSTANCE, "CORPSE_IN_INSTANCE"},
+            {Events::CORPSE_OUT_OF_RANGE, "CORPSE_OUT_OF_RANGE"},
+            {Events::UPDATE_GM_STATUS, "UPDATE_GM_STATUS"},
+            {Events::PLAYER_UNGHOST, "PLAYER_UNGHOST"},
+            {Events::BIND_ENCHANT, "BIND_ENCHANT"},
+            {Events::REPLACE_ENCHANT, "REPLACE_ENCHANT"},
+            {Events::TRADE_REPLACE_ENCHANT, "TRADE_REPLACE_ENCHANT"},
+            {Events::PLAYER_UPDATE_RESTING, "PLAYER_UPDATE_RESTING"},
+            {Events::UPDATE_EXHAUSTION, "UPDATE_EXHAUSTION"},
+            {Events::PLAYER_FLAGS_CHANGED, "PLAYER_FLAGS_CHANGED"},
+            {Events::GUILD_ROSTER_UPDATE, "GUILD_ROSTER_UPDATE"},
+            {Events::GM_PLAYER_INFO, "GM_PLAYER_INFO"},
+            {Events::MAIL_SHOW, "MAIL_SHOW"},
+            {Events::MAIL_CLOSED, "MAIL_CLOSED"},
+            {Events::SEND_MAIL_MONEY_CHANGED, "SEND_MAIL_MONEY_CHANGED"},
+            {Events::SEND_MAIL_COD_CHANGED, "SEND_MAIL_COD_CHANGED"},
+            {Events::MAIL_SEND_INFO_UPDATE, "MAIL_SEND_INFO_UPDATE"},
+            {Events::MAIL_SEND_SUCCESS, "MAIL_SEND_SUCCESS"},
+            {Events::MAIL_INBOX_UPDATE, "MAIL_INBOX_UPDATE"},
+            {Events::BATTLEFIELDS_SHOW, "BATTLEFIELDS_SHOW"},
+            {Events::BATTLEFIELDS_CLOSED, "BATTLEFIELDS_CLOSED"},
+            {Events::UPDATE_BATTLEFIELD_STATUS, "UPDATE_BATTLEFIELD_STATUS"},
+            {Events::UPDATE_BATTLEFIELD_SCORE, "UPDATE_BATTLEFIELD_SCORE"},
+            {Events::AUCTION_HOUSE_SHOW, "AUCTION_HOUSE_SHOW"},
+            {Events::AUCTION_HOUSE_CLOSED, "AUCTION_HOUSE_CLOSED"},
+            {Events::NEW_AUCTION_UPDATE, "NEW_AUCTION_UPDATE"},
+            {Events::AUCTION_ITEM_LIST_UPDATE, "AUCTION_ITEM_LIST_UPDATE"},
+            {Events::AUCTION_OWNED_LIST_UPDATE, "AUCTION_OWNED_LIST_UPDATE"},
+            {Events::AUCTION_BIDDER_LIST_UPDATE, "AUCTION_BIDDER_LIST_UPDATE"},
+            {Events::PET_UI_UPDATE, "PET_UI_UPDATE"},
+            {Events::PET_UI_CLOSE, "PET_UI_CLOSE"},
+            {Events::ADDON_LOADED, "ADDON_LOADED"},
+            {Events::VARIABLES_LOADED, "VARIABLES_LOADED"},
+            {Events::MACRO_ACTION_FORBIDDEN, "MACRO_ACTION_FORBIDDEN"},
+            {Events::ADDON_ACTION_FORBIDDEN, "ADDON_ACTION_FORBIDDEN"},
+            {Events::MEMORY_EXHAUSTED, "MEMORY_EXHAUSTED"},
+            {Events::MEMORY_RECOVERED, "MEMORY_RECOVERED"},
+            {Events::START_AUTOREPEAT_SPELL, "START_AUTOREPEAT_SPELL"},
+            {Events::STOP_AUTOREPEAT_SPELL, "STOP_AUTOREPEAT_SPELL"},
+            {Events::PET_STABLE_SHOW, "PET_STABLE_SHOW"},
+            {Events::PET_STABLE_UPDATE, "PET_STABLE_UPDATE"},
+            {Events::PET_STABLE_UPDATE_PAPERDOLL, "PET_STABLE_UPDATE_PAPERDOLL"},
+            {Events::PET_STABLE_CLOSED, "PET_STABLE_CLOSED"},
+            {Events::CHAT_MSG_COMBAT_SELF_HITS, "CHAT_MSG_COMBAT_SELF_HITS"},
+            {Events::CHAT_MSG_COMBAT_SELF_MISSES, "CHAT_MSG_COMBAT_SELF_MISSES"},
+            {Events::CHAT_MSG_COMBAT_PET_HITS, "CHAT_MSG_COMBAT_PET_HITS"},
+            {Events::CHAT_MSG_COMBAT_PET_MISSES, "CHAT_MSG_COMBAT_PET_MISSES"},
+            {Events::CHAT_MSG_COMBAT_PARTY_HITS, "CHAT_MSG_COMBAT_PARTY_HITS"},
+            {Events::CHAT_MSG_COMBAT_PARTY_MISSES, "CHAT_MSG_COMBAT_PARTY_MISSES"},
+            {Events::CHAT_MSG_COMBAT_FRIENDLYPLAYER_HITS, "CHAT_MSG_COMBAT_FRIENDLYPLAYER_HITS"},
+            {Events::CHAT_MSG_COMBAT_FRIENDLYPLAYER_MISSES, "CHAT_MSG_COMBAT_FRIENDLYPLAYER_MISSES"},
+            {Events::CHAT_MSG_COMBAT_HOSTILEPLAYER_HITS, "CHAT_MSG_COMBAT_HOSTILEPLAYER_HITS"},
+            {Events::CHAT_MSG_COMBAT_HOSTILEPLAYER_MISSES, "CHAT_MSG_COMBAT_HOSTILEPLAYER_MISSES"},
+            {Events::CHAT_MSG_COMBAT_CREATURE_VS_SELF_HITS, "CHAT_MSG_COMBAT_CREATURE_VS_SELF_HITS"},
+            {Events::CHAT_MSG_COMBAT_CREATURE_VS_SELF_MISSES, "CHAT_MSG_COMBAT_CREATURE_VS_SELF_MISSES"},
+            {Events::CHAT_MSG_COMBAT_CREATURE_VS_PARTY_HITS, "CHAT_MSG_COMBAT_CREATURE_VS_PARTY_HITS"},
+            {Events::CHAT_MSG_COMBAT_CREATURE_VS_PARTY_MISSES, "CHAT_MSG_COMBAT_CREATURE_VS_PARTY_MISSES"},
+            {Events::CHAT_MSG_COMBAT_CREATURE_VS_CREATURE_HITS, "CHAT_MSG_COMBAT_CREATURE_VS_CREATURE_HITS"},
+            {Events::CHAT_MSG_COMBAT_CREATURE_VS_CREATURE_MISSES, "CHAT_MSG_COMBAT_CREATURE_VS_CREATURE_MISSES"},
+            {Events::CHAT_MSG_COMBAT_FRIENDLY_DEATH, "CHAT_MSG_COMBAT_FRIENDLY_DEATH"},
+            {Events::CHAT_MSG_COMBAT_HOSTILE_DEATH, "CHAT_MSG_COMBAT_HOSTILE_DEATH"},
+            {Events::CHAT_MSG_COMBAT_XP_GAIN, "CHAT_MSG_COMBAT_XP_GAIN"},
+            {Events::CHAT_MSG_COMBAT_HONOR_GAIN, "CHAT_MSG_COMBAT_HONOR_GAIN"},
+            {Events::CHAT_MSG_SPELL_SELF_DAMAGE, "CHAT_MSG_SPELL_SELF_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_SELF_BUFF, "CHAT_MSG_SPELL_SELF_BUFF"},
+            {Events::CHAT_MSG_SPELL_PET_DAMAGE, "CHAT_MSG_SPELL_PET_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_PET_BUFF, "CHAT_MSG_SPELL_PET_BUFF"},
+            {Events::CHAT_MSG_SPELL_PARTY_DAMAGE, "CHAT_MSG_SPELL_PARTY_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_PARTY_BUFF, "CHAT_MSG_SPELL_PARTY_BUFF"},
+            {Events::CHAT_MSG_SPELL_FRIENDLYPLAYER_DAMAGE, "CHAT_MSG_SPELL_FRIENDLYPLAYER_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_FRIENDLYPLAYER_BUFF, "CHAT_MSG_SPELL_FRIENDLYPLAYER_BUFF"},
+            {Events::CHAT_MSG_SPELL_HOSTILEPLAYER_DAMAGE, "CHAT_MSG_SPELL_HOSTILEPLAYER_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_HOSTILEPLAYER_BUFF, "CHAT_MSG_SPELL_HOSTILEPLAYER_BUFF"},
+            {Events::CHAT_MSG_SPELL_CREATURE_VS_SELF_DAMAGE, "CHAT_MSG_SPELL_CREATURE_VS_SELF_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_CREATURE_VS_SELF_BUFF, "CHAT_MSG_SPELL_CREATURE_VS_SELF_BUFF"},
+            {Events::CHAT_MSG_SPELL_CREATURE_VS_PARTY_DAMAGE, "CHAT_MSG_SPELL_CREATURE_VS_PARTY_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_CREATURE_VS_PARTY_BUFF, "CHAT_MSG_SPELL_CREATURE_VS_PARTY_BUFF"},
+            {Events::CHAT_MSG_SPELL_CREATURE_VS_CREATURE_DAMAGE, "CHAT_MSG_SPELL_CREATURE_VS_CREATURE_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_CREATURE_VS_CREATURE_BUFF, "CHAT_MSG_SPELL_CREATURE_VS_CREATURE_BUFF"},
+            {Events::CHAT_MSG_SPELL_TRADESKILLS, "CHAT_MSG_SPELL_TRADESKILLS"},
+            {Events::CHAT_MSG_SPELL_DAMAGESHIELDS_ON_SELF, "CHAT_MSG_SPELL_DAMAGESHIELDS_ON_SELF"},
+            {Events::CHAT_MSG_SPELL_DAMAGESHIELDS_ON_OTHERS, "CHAT_MSG_SPELL_DAMAGESHIELDS_ON_OTHERS"},
+            {Events::CHAT_MSG_SPELL_AURA_GONE_SELF, "CHAT_MSG_SPELL_AURA_GONE_SELF"},
+            {Events::CHAT_MSG_SPELL_AURA_GONE_PARTY, "CHAT_MSG_SPELL_AURA_GONE_PARTY"},
+            {Events::CHAT_MSG_SPELL_AURA_GONE_OTHER, "CHAT_MSG_SPELL_AURA_GONE_OTHER"},
+            {Events::CHAT_MSG_SPELL_ITEM_ENCHANTMENTS, "CHAT_MSG_SPELL_ITEM_ENCHANTMENTS"},
+            {Events::CHAT_MSG_SPELL_BREAK_AURA, "CHAT_MSG_SPELL_BREAK_AURA"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_SELF_DAMAGE, "CHAT_MSG_SPELL_PERIODIC_SELF_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_SELF_BUFFS, "CHAT_MSG_SPELL_PERIODIC_SELF_BUFFS"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_PARTY_DAMAGE, "CHAT_MSG_SPELL_PERIODIC_PARTY_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_PARTY_BUFFS, "CHAT_MSG_SPELL_PERIODIC_PARTY_BUFFS"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_FRIENDLYPLAYER_DAMAGE, "CHAT_MSG_SPELL_PERIODIC_FRIENDLYPLAYER_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_FRIENDLYPLAYER_BUFFS, "CHAT_MSG_SPELL_PERIODIC_FRIENDLYPLAYER_BUFFS"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_HOSTILEPLAYER_DAMAGE, "CHAT_MSG_SPELL_PERIODIC_HOSTILEPLAYER_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_HOSTILEPLAYER_BUFFS, "CHAT_MSG_SPELL_PERIODIC_HOSTILEPLAYER_BUFFS"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_CREATURE_DAMAGE, "CHAT_MSG_SPELL_PERIODIC_CREATURE_DAMAGE"},
+            {Events::CHAT_MSG_SPELL_PERIODIC_CREATURE_BUFFS, "CHAT_MSG_SPELL_PERIODIC_CREATURE_BUFFS"},
+            {Events::CHAT_MSG_SPELL_FAILED_LOCALPLAYER, "CHAT_MSG_SPELL_FAILED_LOCALPLAYER"},
+            {Events::CHAT_MSG_BG_SYSTEM_NEUTRAL, "CHAT_MSG_BG_SYSTEM_NEUTRAL"},
+            {Events::CHAT_MSG_BG_SYSTEM_ALLIANCE, "CHAT_MSG_BG_SYSTEM_ALLIANCE"},
+            {Events::CHAT_MSG_BG_SYSTEM_HORDE, "CHAT_MSG_BG_SYSTEM_HORDE"},
+            {Events::RAID_ROSTER_UPDATE, "RAID_ROSTER_UPDATE"},
+            {Events::UPDATE_PENDING_MAIL, "UPDATE_PENDING_MAIL"},
+            {Events::UPDATE_INVENTORY_ALERTS, "UPDATE_INVENTORY_ALERTS"},
+            {Events::UPDATE_TRADESKILL_RECAST, "UPDATE_TRADESKILL_RECAST"},
+            {Events::OPEN_MASTER_LOOT_LIST, "OPEN_MASTER_LOOT_LIST"},
+            {Events::UPDATE_MASTER_LOOT_LIST, "UPDATE_MASTER_LOOT_LIST"},
+            {Events::START_LOOT_ROLL, "START_LOOT_ROLL"},
+            {Events::CANCEL_LOOT_ROLL, "CANCEL_LOOT_ROLL"},
+            {Events::CONFIRM_LOOT_ROLL, "CONFIRM_LOOT_ROLL"},
+            {Events::INSTANCE_BOOT_START, "INSTANCE_BOOT_START"},
+            {Events::INSTANCE_BOOT_STOP, "INSTANCE_BOOT_STOP"},
+            {Events::LEARNED_SPELL_IN_TAB, "LEARNED_SPELL_IN_TAB"},
+            {Events::DISPLAY_SIZE_CHANGED, "DISPLAY_SIZE_CHANGED"},
+            {Events::CONFIRM_TALENT_WIPE, "CONFIRM_TALENT_WIPE"},
+            {Events::CONFIRM_BINDER, "CONFIRM_BINDER"},
+            {Events::MAIL_FAILED, "MAIL_FAILED"},
+            {Events::CLOSE_INBOX_ITEM, "CLOSE_INBOX_ITEM"},
+            {Events::CONFIRM_SUMMON, "CONFIRM_SUMMON"},
+            {Events::BILLING_NAG_DIALOG, "BILLING_NAG_DIALOG"},
+            {Events::IGR_BILLING_NAG_DIALOG, "IGR_BILLING_NAG_DIALOG"},
+            {Events::MEETINGSTONE_CHANGED, "MEETINGSTONE_CHANGED"},
+            {Events::PLAYER_SKINNED, "PLAYER_SKINNED"},
+            {Events::TABARD_SAVE_PENDING, "TABARD_SAVE_PENDING"},
+            {Events::UNIT_QUEST_LOG_CHANGED, "UNIT_QUEST_LOG_CHANGED"},
+            {Events::PLAYER_PVP_KILLS_CHANGED, "PLAYER_PVP_KILLS_CHANGED"},
+            {Events::PLAYER_PVP_RANK_CHANGED, "PLAYER_PVP_RANK_CHANGED"},
+            {Events::INSPECT_HONOR_UPDATE, "INSPECT_HONOR_UPDATE"},
+            {Events::UPDATE_WORLD_STATES, "UPDATE_WORLD_STATES"},
+            {Events::AREA_SPIRIT_HEALER_IN_RANGE, "AREA_SPIRIT_HEALER_IN_RANGE"},
+            {Events::AREA_SPIRIT_HEALER_OUT_OF_RANGE, "AREA_SPIRIT_HEALER_OUT_OF_RANGE"},
+            {Events::CONFIRM_PET_UNLEARN, "CONFIRM_PET_UNLEARN"},
+            {Events::PLAYTIME_CHANGED, "PLAYTIME_CHANGED"},
+            {Events::UPDATE_LFG_TYPES, "UPDATE_LFG_TYPES"},
+            {Events::UPDATE_LFG_LIST, "UPDATE_LFG_LIST"},
+            {Events::CHAT_MSG_COMBAT_FACTION_CHANGE, "CHAT_MSG_COMBAT_FACTION_CHANGE"},
+            {Events::START_MINIGAME, "START_MINIGAME"},
+            {Events::MINIGAME_UPDATE, "MINIGAME_UPDATE"},
+            {Events::READY_CHECK, "READY_CHECK"},
+            {Events::RAID_TARGET_UPDATE, "RAID_TARGET_UPDATE"},
+            {Events::GMSURVEY_DISPLAY, "GMSURVEY_DISPLAY"},
+            {Events::UPDATE_INSTANCE_INFO, "UPDATE_INSTANCE_INFO"},
+            {Events::SPELL_CAST_EVENT, "SPELL_CAST_EVENT"},
+            {Events::CHAT_MSG_RAID_BOSS_EMOTE, "CHAT_MSG_RAID_BOSS_EMOTE"},
+            {Events::COMBAT_TEXT_UPDATE, "COMBAT_TEXT_UPDATE"},
+            {Events::LOTTERY_SHOW, "LOTTERY_SHOW"},
+            {Events::CHAT_MSG_FILTERED, "CHAT_MSG_FILTERED"},
+            {Events::QUEST_WATCH_UPDATE, "QUEST_WATCH_UPDATE"},
+            {Events::CHAT_MSG_BATTLEGROUND, "CHAT_MSG_BATTLEGROUND"},
+            {Events::CHAT_MSG_BATTLEGROUND_LEADER, "CHAT_MSG_BATTLEGROUND_LEADER"},
+            {Events::LOTTERY_ITEM_UPDATE, "LOTTERY_ITEM_UPDATE"},
+            {Events::SPELL_DAMAGE_EVENT_SELF, "SPELL_DAMAGE_EVENT_SELF"},
+            {Events::SPELL_DAMAGE_EVENT_OTHER, "SPELL_DAMAGE_EVENT_OTHER"},
+            {Events::UNIT_CASTEVENT, "UNIT_CASTEVENT"},
+            {Events::RAW_COMBATLOG, "RAW_COMBATLOG"},
+            {Events::CREATE_CHATBUBBLE, "CREATE_CHATBUBBLE"},
+            {Events::OTHER_UI_EVENTS, "OTHER_UI_EVENTS"},
+    };
+
+    constexpr size_t EVENT_NAME_ENTRY_COUNT = sizeof(kEventNameEntries) / sizeof(kEventNameEntries[0]);
+
+    // Name per flat event code slot, nullptr for codes the client doesn't send
+    struct EventNameTable {
+        const char *names[EVENT_CODE_SLOTS];
+
+        constexpr EventNameTable() : names() {
+            for (size_t i = 0; i < EVENT_NAME_ENTRY_COUNT; ++i) {
+                names[EventCodeSlot(static_cast<int>(kEventNameEntries[i].code))] = kEventNameEntries[i].name;
+            }
+        }
+    };
+
+    constexpr EventNameTable kEventNames{};
 
     void initializeEventStats() {
-        // Event stats are already initialized above, so we don't need to do anything here
-        // This function is kept for future initialization needs
+        for (auto &window: gStatsWindows) {
+            for (const NamedEvent &named: kNamedEvents) {
+                window.eventStats[named.id].name = named.name;
+            }
+
+            // Name every event code slot up front so SignalEvent never allocates
+            window.eventCodeStats.clear();
+            window.eventCodeStats.reserve(EVENT_CODE_SLOTS);
+            for (int slot = 0; slot < EVENT_CODE_SLOTS; ++slot) {
+                const char *name = kEventNames.names[slot];
+                if (name != nullptr) {
+                    window.eventCodeStats.emplace_back(name);
+                } else if (slot == UNKNOWN_EVENT_SLOT) {
+                    window.eventCodeStats.emplace_back("UNKNOWN_EVENT");
+                } else {
+                    window.eventCodeStats.emplace_back("UNKNOWN_EVENT_" + std::to_string(slot));
+                }
+            }
+        }
+    }
+
+    const char *GetEventName(int eventCode) {
+        int slot = EventCodeSlot(eventCode);
+        return slot == UNKNOWN_EVENT_SLOT ? nullptr : kEventNames.names[slot];
     }
 
-    std::string GetEventName(int eventCode) {
-        switch (eventCode) {
-            case Events::UNIT_PET_01: return "UNIT_PET";
-            case Events::UNIT_PET_02: return "UNIT_PET";
-            case Events::UNIT_HEALTH: return "UNIT_HEALTH";
-            case Events::UNIT_MANA_01: return "UNIT_MANA";
-            case Events::UNIT_RAGE: return "UNIT_RAGE";
-            case Events::UNIT_FOCUS: return "UNIT_FOCUS";
-            case Events::UNIT_ENERGY: return "UNIT_ENERGY";
-            case Events::UNIT_HAPPINESS: return "UNIT_HAPPINESS";
-            case Events::UNIT_MAXHEALTH: return "UNIT_MAXHEALTH";
-            case Events::UNIT_MAXMANA: return "UNIT_MAXMANA";
-            case Events::UNIT_MAXRAGE: return "UNIT_MAXRAGE";
-            case Events::UNIT_MAXFOCUS: return "UNIT_MAXFOCUS";
-            case Events::UNIT_MAXENERGY: return "UNIT_MAXENERGY";
-            case Events::UNIT_MAXHAPPINESS: return "UNIT_MAXHAPPINESS";
-            case Events::UNIT_LEVEL: return "UNIT_LEVEL";
-            case Events::UNIT_FACTION: return "UNIT_FACTION";
-            case Events::UNIT_DISPLAYPOWER: return "UNIT_DISPLAYPOWER";
-            case Events::UNIT_FLAGS: return "UNIT_FLAGS";
-            case Events::UNIT_AURA_01: return "UNIT_AURA";
-            case Events::UNIT_AURA_02: return "UNIT_AURA";
-            case Events::UNIT_ATTACK_SPEED_01: return "UNIT_ATTACK_SPEED";
-            case Events::UNIT_ATTACK_SPEED_02: return "UNIT_ATTACK_SPEED";
-            case Events::UNIT_RANGEDDAMAGE_01: return "UNIT_RANGEDDAMAGE";
-            case Events::UNIT_DAMAGE_01: return "UNIT_DAMAGE";
-            case Events::UNIT_DAMAGE_02: return "UNIT_DAMAGE";
-            case Events::UNIT_DAMAGE_03: return "UNIT_DAMAGE";
-            case Events::UNIT_DAMAGE_04: return "UNIT_DAMAGE";
-            case Events::UNIT_LOYALTY: return "UNIT_LOYALTY";
-            case Events::UNIT_PET_EXPERIENCE_01: return "UNIT_PET_EXPERIENCE";
-            case Events::UNIT_PET_EXPERIENCE_02: return "UNIT_PET_EXPERIENCE";
-            case Events::UNIT_DYNAMIC_FLAGS: return "UNIT_DYNAMIC_FLAGS";
-            case Events::UNIT_PET_TRAINING_POINTS: return "UNIT_PET_TRAINING_POINTS";
-            case Events::UNIT_STATS_01: return "UNIT_STATS";
-            case Events::UNIT_STATS_02: return "UNIT_STATS";
-            case Events::UNIT_STATS_03: return "UNIT_STATS";
-            case Events::UNIT_STATS_04: return "UNIT_STATS";
-            case Events::UNIT_STATS_05: return "UNIT_STATS";
-            case Events::UNIT_RESISTANCES_01: return "UNIT_RESISTANCES";
-            case Events::UNIT_RESISTANCES_02: return "UNIT_RESISTANCES";
-            case Events::UNIT_RESISTANCES_03: return "UNIT_RESISTANCES";
-            case Events::UNIT_RESISTANCES_04: return "UNIT_RESISTANCES";
-            case Events::UNIT_RESISTANCES_05: return "UNIT_RESISTANCES";
-            case Events::UNIT_RESISTANCES_06: return "UNIT_RESISTANCES";
-            case Events::UNIT_RESISTANCES_07: return "UNIT_RESISTANCES";
-            case Events::UNIT_ATTACK_POWER_01: return "UNIT_ATTACK_POWER";
-            case Events::UNIT_ATTACK_POWER_02: return "UNIT_ATTACK_POWER";
-            case Events::UNIT_ATTACK_POWER_03: return "UNIT_ATTACK_POWER";
-            case Events::UNIT_RANGED_ATTACK_POWER_01: return "UNIT_RANGED_ATTACK_POWER";
-            case Events::UNIT_RANGED_ATTACK_POWER_02: return "UNIT_RANGED_ATTACK_POWER";
-            case Events::UNIT_RANGED_ATTACK_POWER_03: return "UNIT_RANGED_ATTACK_POWER";
-            case Events::UNIT_RANGEDDAMAGE_02: return "UNIT_RANGEDDAMAGE";
-            case Events::UNIT_RANGEDDAMAGE_03: return "UNIT_RANGEDDAMAGE";
-            case Events::UNIT_MANA1: return "UNIT_MANA1";
-            case Events::UNIT_MANA2: return "UNIT_MANA2";
-            case Events::UNIT_COMBAT: return "UNIT_COMBAT";
-            case Events::UNIT_NAME_UPDATE: return "UNIT_NAME_UPDATE";
-            case Events::UNIT_PORTRAIT_UPDATE: return "UNIT_PORTRAIT_UPDATE";
-            case Events::UNIT_MODEL_CHANGED: return "UNIT_MODEL_CHANGED";
-            case Events::UNIT_INVENTORY_CHANGED: return "UNIT_INVENTORY_CHANGED";
-            case Events::UNIT_CLASSIFICATION_CHANGED: return "UNIT_CLASSIFICATION_CHANGED";
-            case Events::ITEM_LOCK_CHANGED: return "ITEM_LOCK_CHANGED";
-            case Events::PLAYER_XP_UPDATE: return "PLAYER_XP_UPDATE";
-            case Events::PLAYER_REGEN_DISABLED: return "PLAYER_REGEN_DISABLED";
-            case Events::PLAYER_REGEN_ENABLED: return "PLAYER_REGEN_ENABLED";
-            case Events::PLAYER_AURAS_CHANGED: return "PLAYER_AURAS_CHANGED";
-            case Events::PLAYER_ENTER_COMBAT: return "PLAYER_ENTER_COMBAT";
-            case Events::PLAYER_LEAVE_COMBAT: return "PLAYER_LEAVE_COMBAT";
-            case Events::PLAYER_TARGET_CHANGED: return "PLAYER_TARGET_CHANGED";
-            case Events::PLAYER_CONTROL_LOST: return "PLAYER_CONTROL_LOST";
-            case Events::PLAYER_CONTROL_GAINED: return "PLAYER_CONTROL_GAINED";
-            case Events::PLAYER_FARSIGHT_FOCUS_CHANGED: return "PLAYER_FARSIGHT_FOCUS_CHANGED";
-            case Events::PLAYER_LEVEL_UP: return "PLAYER_LEVEL_UP";
-            case Events::PLAYER_MONEY: return "PLAYER_MONEY";
-            case Events::PLAYER_DAMAGE_DONE_MODS: return "PLAYER_DAMAGE_DONE_MODS";
-            case Events::PLAYER_COMBO_POINTS: return "PLAYER_COMBO_POINTS";
-            case Events::ZONE_CHANGED: return "ZONE_CHANGED";
-            case Events::ZONE_CHANGED_INDOORS: return "ZONE_CHANGED_INDOORS";
-            case Events::ZONE_CHANGED_NEW_AREA: return "ZONE_CHANGED_NEW_AREA";
-            case Events::MINIMAP_ZONE_CHANGED: return "MINIMAP_ZONE_CHANGED";
-            case Events::MINIMAP_UPDATE_ZOOM: return "MINIMAP_UPDATE_ZOOM";
-            case Events::SCREENSHOT_SUCCEEDED: return "SCREENSHOT_SUCCEEDED";
-            case Events::SCREENSHOT_FAILED: return "SCREENSHOT_FAILED";
-            case Events::ACTIONBAR_SHOWGRID: return "ACTIONBAR_SHOWGRID";
-            case Events::ACTIONBAR_HIDEGRID: return "ACTIONBAR_HIDEGRID";
-            case Events::ACTIONBAR_PAGE_CHANGED: return "ACTIONBAR_PAGE_CHANGED";
-            case Events::ACTIONBAR_SLOT_CHANGED: return "ACTIONBAR_SLOT_CHANGED";
-            case Events::ACTIONBAR_UPDATE_STATE: return "ACTIONBAR_UPDATE_STATE";
-            case Events::ACTIONBAR_UPDATE_USABLE: return "ACTIONBAR_UPDATE_USABLE";
-            case Events::ACTIONBAR_UPDATE_COOLDOWN: return "ACTIONBAR_UPDATE_COOLDOWN";
-            case Events::UPDATE_BONUS_ACTIONBAR: return "UPDATE_BONUS_ACTIONBAR";
-            case Events::PARTY_MEMBERS_CHANGED: return "PARTY_MEMBERS_CHANGED";
-            case Events::PARTY_LEADER_CHANGED: return "PARTY_LEADER_CHANGED";
-            case Events::PARTY_MEMBER_ENABLE: return "PARTY_MEMBER_ENABLE";
-            case Events::PARTY_MEMBER_DISABLE: return "PARTY_MEMBER_DISABLE";
-            case Events::PARTY_LOOT_METHOD_CHANGED: return "PARTY_LOOT_METHOD_CHANGED";
-            case Events::SYSMSG: return "SYSMSG";
-            case Events::UI_ERROR_MESSAGE: return "UI_ERROR_MESSAGE";
-            case Events::UI_INFO_MESSAGE: return "UI_INFO_MESSAGE";
-            case Events::UPDATE_CHAT_COLOR: return "UPDATE_CHAT_COLOR";
-            case Events::CHAT_MSG_ADDON: return "CHAT_MSG_ADDON";
-            case Events::CHAT_MSG_SAY: return "CHAT_MSG_SAY";
-            case Events::CHAT_MSG_PARTY: return "CHAT_MSG_PARTY";
-            case Events::CHAT_MSG_RAID: return "CHAT_MSG_RAID";
-            case Events::CHAT_MSG_GUILD: return "CHAT_MSG_GUILD";
-            case Events::CHAT_MSG_OFFICER: return "CHAT_MSG_OFFICER";
-            case Events::CHAT_MSG_YELL: return "CHAT_MSG_YELL";
-            case Events::CHAT_MSG_WHISPER: return "CHAT_MSG_WHISPER";
-            case Events::CHAT_MSG_WHISPER_INFORM: return "CHAT_MSG_WHISPER_INFORM";
-            case Events::CHAT_MSG_EMOTE: return "CHAT_MSG_EMOTE";
-            case Events::CHAT_MSG_TEXT_EMOTE: return "CHAT_MSG_TEXT_EMOTE";
-            case Events::CHAT_MSG_SYSTEM: return "CHAT_MSG_SYSTEM";
-            case Events::CHAT_MSG_MONSTER_SAY: return "CHAT_MSG_MONSTER_SAY";
-            case Events::CHAT_MSG_MONSTER_YELL: return "CHAT_MSG_MONSTER_YELL";
-            case Events::CHAT_MSG_MONSTER_WHISPER: return "CHAT_MSG_MONSTER_WHISPER";
-            case Events::CHAT_MSG_MONSTER_EMOTE: return "CHAT_MSG_MONSTER_EMOTE";
-            case Events::CHAT_MSG_CHANNEL: return "CHAT_MSG_CHANNEL";
-            case Events::CHAT_MSG_CHANNEL_JOIN: return "CHAT_MSG_CHANNEL_JOIN";
-            case Events::CHAT_MSG_CHANNEL_LEAVE: return "CHAT_MSG_CHANNEL_LEAVE";
-            case Events::CHAT_MSG_CHANNEL_LIST: return "CHAT_MSG_CHANNEL_LIST";
-            case Events::CHAT_MSG_CHANNEL_NOTICE: return "CHAT_MSG_CHANNEL_NOTICE";
-            case Events::CHAT_MSG_CHANNEL_NOTICE_USER: return "CHAT_MSG_CHANNEL_NOTICE_USER";
-            case Events::CHAT_MSG_AFK: return "CHAT_MSG_AFK";
-            case Events::CHAT_MSG_DND: return "CHAT_MSG_DND";
-            case Events::CHAT_MSG_COMBAT_LOG: return "CHAT_MSG_COMBAT_LOG";
-            case Events::CHAT_MSG_IGNORED: return "CHAT_MSG_IGNORED";
-            case Events::CHAT_MSG_SKILL: return "CHAT_MSG_SKILL";
-            case Events::CHAT_MSG_LOOT: return "CHAT_MSG_LOOT";
-            case Events::CHAT_MSG_MONEY: return "CHAT_MSG_MONEY";
-            case Events::CHAT_MSG_RAID_LEADER: return "CHAT_MSG_RAID_LEADER";
-            case Events::CHAT_MSG_RAID_WARNING: return "CHAT_MSG_RAID_WARNING";
-            case Events::LANGUAGE_LIST_CHANGED: return "LANGUAGE_LIST_CHANGED";
-            case Events::TIME_PLAYED_MSG: return "TIME_PLAYED_MSG";
-            case Events::SPELLS_CHANGED: return "SPELLS_CHANGED";
-            case Events::CURRENT_SPELL_CAST_CHANGED: return "CURRENT_SPELL_CAST_CHANGED";
-            case Events::SPELL_UPDATE_COOLDOWN: return "SPELL_UPDATE_COOLDOWN";
-            case Events::SPELL_UPDATE_USABLE: return "SPELL_UPDATE_USABLE";
-            case Events::CHARACTER_POINTS_CHANGED: return "CHARACTER_POINTS_CHANGED";
-            case Events::SKILL_LINES_CHANGED: return "SKILL_LINES_CHANGED";
-            case Events::ITEM_PUSH: return "ITEM_PUSH";
-            case Events::LOOT_OPENED: return "LOOT_OPENED";
-            case Events::LOOT_SLOT_CLEARED: return "LOOT_SLOT_CLEARED";
-            case Events::LOOT_CLOSED: return "LOOT_CLOSED";
-            case Events::PLAYER_LOGIN: return "PLAYER_LOGIN";
-            case Events::PLAYER_LOGOUT: return "PLAYER_LOGOUT";
-            case Events::PLAYER_ENTERING_WORLD: return "PLAYER_ENTERING_WORLD";
-            case Events::PLAYER_LEAVING_WORLD: return "PLAYER_LEAVING_WORLD";
-            case Events::PLAYER_ALIVE: return "PLAYER_ALIVE";
-            case Events::PLAYER_DEAD: return "PLAYER_DEAD";
-            case Events::PLAYER_CAMPING: return "PLAYER_CAMPING";
-            case Events::PLAYER_QUITING: return "PLAYER_QUITING";
-            case Events::LOGOUT_CANCEL: return "LOGOUT_CANCEL";
-            case Events::RESURRECT_REQUEST: return "RESURRECT_REQUEST";
-            case Events::PARTY_INVITE_REQUEST: return "PARTY_INVITE_REQUEST";
-            case Events::PARTY_INVITE_CANCEL: return "PARTY_INVITE_CANCEL";
-            case Events::GUILD_INVITE_REQUEST: return "GUILD_INVITE_REQUEST";
-            case Events::GUILD_INVITE_CANCEL: return "GUILD_INVITE_CANCEL";
-            case Events::GUILD_MOTD: return "GUILD_MOTD";
-            case Events::TRADE_REQUEST: return "TRADE_REQUEST";
-            case Events::TRADE_REQUEST_CANCEL: return "TRADE_REQUEST_CANCEL";
-            case Events::LOOT_BIND_CONFIRM: return "LOOT_BIND_CONFIRM";
-            case Events::EQUIP_BIND_CONFIRM: return "EQUIP_BIND_CONFIRM";
-            case Events::AUTOEQUIP_BIND_CONFIRM: return "AUTOEQUIP_BIND_CONFIRM";
-            case Events::USE_BIND_CONFIRM: return "USE_BIND_CONFIRM";
-            case Events::DELETE_ITEM_CONFIRM: return "DELETE_ITEM_CONFIRM";
-            case Events::CURSOR_UPDATE: return "CURSOR_UPDATE";
-            case Events::ITEM_TEXT_BEGIN: return "ITEM_TEXT_BEGIN";
-            case Events::ITEM_TEXT_TRANSLATION: return "ITEM_TEXT_TRANSLATION";
-            case Events::ITEM_TEXT_READY: return "ITEM_TEXT_READY";
-            case Events::ITEM_TEXT_CLOSED: return "ITEM_TEXT_CLOSED";
-            case Events::GOSSIP_SHOW: return "GOSSIP_SHOW";
-            case Events::GOSSIP_ENTER_CODE: return "GOSSIP_ENTER_CODE";
-            case Events::GOSSIP_CLOSED: return "GOSSIP_CLOSED";
-            case Events::QUEST_GREETING: return "QUEST_GREETING";
-            case Events::QUEST_DETAIL: return "QUEST_DETAIL";
-            case Events::QUEST_PROGRESS: return "QUEST_PROGRESS";
-            case Events::QUEST_COMPLETE: return "QUEST_COMPLETE";
-            case Events::QUEST_FINISHED: return "QUEST_FINISHED";
-            case Events::QUEST_ITEM_UPDATE: return "QUEST_ITEM_UPDATE";
-            case Events::TAXIMAP_OPENED: return "TAXIMAP_OPENED";
-            case Events::TAXIMAP_CLOSED: return "TAXIMAP_CLOSED";
-            case Events::QUEST_LOG_UPDATE: return "QUEST_LOG_UPDATE";
-            case Events::TRAINER_SHOW: return "TRAINER_SHOW";
-            case Events::TRAINER_UPDATE: return "TRAINER_UPDATE";
-            case Events::TRAINER_CLOSED: return "TRAINER_CLOSED";
-            case Events::CVAR_UPDATE: return "CVAR_UPDATE";
-            case Events::TRADE_SKILL_SHOW: return "TRADE_SKILL_SHOW";
-            case Events::TRADE_SKILL_UPDATE: return "TRADE_SKILL_UPDATE";
-            case Events::TRADE_SKILL_CLOSE: return "TRADE_SKILL_CLOSE";
-            case Events::MERCHANT_SHOW: return "MERCHANT_SHOW";
-            case Events::MERCHANT_UPDATE: return "MERCHANT_UPDATE";
-            case Events::MERCHANT_CLOSED: return "MERCHANT_CLOSED";
-            case Events::TRADE_SHOW: return "TRADE_SHOW";
-            case Events::TRADE_CLOSED: return "TRADE_CLOSED";
-            case Events::TRADE_UPDATE: return "TRADE_UPDATE";
-            case Events::TRADE_ACCEPT_UPDATE: return "TRADE_ACCEPT_UPDATE";
-            case Events::TRADE_TARGET_ITEM_CHANGED: return "TRADE_TARGET_ITEM_CHANGED";
-            case Events::TRADE_PLAYER_ITEM_CHANGED: return "TRADE_PLAYER_ITEM_CHANGED";
-            case Events::TRADE_MONEY_CHANGED: return "TRADE_MONEY_CHANGED";
-            case Events::PLAYER_TRADE_MONEY: return "PLAYER_TRADE_MONEY";
-            case Events::BAG_OPEN: return "BAG_OPEN";
-            case Events::BAG_UPDATE: return "BAG_UPDATE";
-            case Events::BAG_CLOSED: return "BAG_CLOSED";
-            case Events::BAG_UPDATE_COOLDOWN: return "BAG_UPDATE_COOLDOWN";
-            case Events::LOCALPLAYER_PET_RENAMED: return "LOCALPLAYER_PET_RENAMED";
-            case Events::UNIT_ATTACK: return "UNIT_ATTACK";
-            case Events::UNIT_DEFENSE: return "UNIT_DEFENSE";
-            case Events::PET_ATTACK_START: return "PET_ATTACK_START";
-            case Events::PET_ATTACK_STOP: return "PET_ATTACK_STOP";
-            case Events::UPDATE_MOUSEOVER_UNIT: return "UPDATE_MOUSEOVER_UNIT";
-            case Events::SPELLCAST_START: return "SPELLCAST_START";
-            case Events::SPELLCAST_STOP: return "SPELLCAST_STOP";
-            case Events::SPELLCAST_FAILED: return "SPELLCAST_FAILED";
-            case Events::SPELLCAST_INTERRUPTED: return "SPELLCAST_INTERRUPTED";
-            case Events::SPELLCAST_DELAYED: return "SPELLCAST_DELAYED";
-            case Events::SPELLCAST_CHANNEL_START: return "SPELLCAST_CHANNEL_START";
-            case Events::SPELLCAST_CHANNEL_UPDATE: return "SPELLCAST_CHANNEL_UPDATE";
-            case Events::SPELLCAST_CHANNEL_STOP: return "SPELLCAST_CHANNEL_STOP";
-            case Events::PLAYER_GUILD_UPDATE: return "PLAYER_GUILD_UPDATE";
-            case Events::QUEST_ACCEPT_CONFIRM: return "QUEST_ACCEPT_CONFIRM";
-            case Events::PLAYERBANKSLOTS_CHANGED: return "PLAYERBANKSLOTS_CHANGED";
-            case Events::BANKFRAME_OPENED: return "BANKFRAME_OPENED";
-            case Events::BANKFRAME_CLOSED: return "BANKFRAME_CLOSED";
-            case Events::PLAYERBANKBAGSLOTS_CHANGED: return "PLAYERBANKBAGSLOTS_CHANGED";
-            case Events::FRIENDLIST_UPDATE: return "FRIENDLIST_UPDATE";
-            case Events::IGNORELIST_UPDATE: return "IGNORELIST_UPDATE";
-            case Events::PET_BAR_UPDATE: return "PET_BAR_UPDATE";
-            case Events::PET_BAR_UPDATE_COOLDOWN: return "PET_BAR_UPDATE_COOLDOWN";
-            case Events::PET_BAR_SHOWGRID: return "PET_BAR_SHOWGRID";
-            case Events::PET_BAR_HIDEGRID: return "PET_BAR_HIDEGRID";
-            case Events::MINIMAP_PING: return "MINIMAP_PING";
-            case Events::CHAT_MSG_COMBAT_MISC_INFO: return "CHAT_MSG_COMBAT_MISC_INFO";
-            case Events::CRAFT_SHOW: return "CRAFT_SHOW";
-            case Events::CRAFT_UPDATE: return "CRAFT_UPDATE";
-            case Events::CRAFT_CLOSE: return "CRAFT_CLOSE";
-            case Events::MIRROR_TIMER_START: return "MIRROR_TIMER_START";
-            case Events::MIRROR_TIMER_PAUSE: return "MIRROR_TIMER_PAUSE";
-            case Events::MIRROR_TIMER_STOP: return "MIRROR_TIMER_STOP";
-            case Events::WORLD_MAP_UPDATE: return "WORLD_MAP_UPDATE";
-            case Events::WORLD_MAP_NAME_UPDATE: return "WORLD_MAP_NAME_UPDATE";
-            case Events::AUTOFOLLOW_BEGIN: return "AUTOFOLLOW_BEGIN";
-            case Events::AUTOFOLLOW_END: return "AUTOFOLLOW_END";
-            case Events::SPELL_QUEUE_EVENT: return "SPELL_QUEUE_EVENT";
-            case Events::CINEMATIC_START: return "CINEMATIC_START";
-            case Events::CINEMATIC_STOP: return "CINEMATIC_STOP";
-            case Events::UPDATE_FACTION: return "UPDATE_FACTION";
-            case Events::CLOSE_WORLD_MAP: return "CLOSE_WORLD_MAP";
-            case Events::OPEN_TABARD_FRAME: return "OPEN_TABARD_FRAME";
-            case Events::CLOSE_TABARD_FRAME: return "CLOSE_TABARD_FRAME";
-            case Events::TABARD_CANSAVE_CHANGED: return "TABARD_CANSAVE_CHANGED";
-            case Events::SHOW_COMPARE_TOOLTIP: return "SHOW_COMPARE_TOOLTIP";
-            case Events::GUILD_REGISTRAR_SHOW: return "GUILD_REGISTRAR_SHOW";
-            case Events::GUILD_REGISTRAR_CLOSED: return "GUILD_REGISTRAR_CLOSED";
-            case Events::DUEL_REQUESTED: return "DUEL_REQUESTED";
-            case Events::DUEL_OUTOFBOUNDS: return "DUEL_OUTOFBOUNDS";
-            case Events::DUEL_INBOUNDS: return "DUEL_INBOUNDS";
-            case Events::DUEL_FINISHED: return "DUEL_FINISHED";
-            case Events::TUTORIAL_TRIGGER: return "TUTORIAL_TRIGGER";
-            case Events::PET_DISMISS_START: return "PET_DISMISS_START";
-            case Events::UPDATE_BINDINGS: return "UPDATE_BINDINGS";
-            case Events::UPDATE_SHAPESHIFT_FORMS: return "UPDATE_SHAPESHIFT_FORMS";
-            case Events::WHO_LIST_UPDATE: return "WHO_LIST_UPDATE";
-            case Events::UPDATE_LFG: return "UPDATE_LFG";
-            case Events::PETITION_SHOW: return "PETITION_SHOW";
-            case Events::PETITION_CLOSED: return "PETITION_CLOSED";
-            case Events::EXECUTE_CHAT_LINE: return "EXECUTE_CHAT_LINE";
-            case Events::UPDATE_MACROS: return "UPDATE_MACROS";
-            case Events::UPDATE_TICKET: return "UPDATE_TICKET";
-            case Events::UPDATE_CHAT_WINDOWS: return "UPDATE_CHAT_WINDOWS";
-            case Events::CONFIRM_XP_LOSS: return "CONFIRM_XP_LOSS";
-            case Events::CORPSE_IN_RANGE: return "CORPSE_IN_RANGE";
-            case Events::CORPSE_IN_INSTANCE: return "CORPSE_IN_INSTANCE";
-            case Events::CORPSE_OUT_OF_RANGE: return "CORPSE_OUT_OF_RANGE";
-            case Events::UPDATE_GM_STATUS: return "UPDATE_GM_STATUS";
-            case Events::PLAYER_UNGHOST: return "PLAYER_UNGHOST";
-            case Events::BIND_ENCHANT: return "BIND_ENCHANT";
-            case Events::REPLACE_ENCHANT: return "REPLACE_ENCHANT";
-            case Events::TRADE_REPLACE_ENCHANT: return "TRADE_REPLACE_ENCHANT";
-            case Events::PLAYER_UPDATE_RESTING: return "PLAYER_UPDATE_RESTING";
-            case Events::UPDATE_EXHAUSTION: return "UPDATE_EXHAUSTION";
-            case Events::PLAYER_FLAGS_CHANGED: return "PLAYER_FLAGS_CHANGED";
-            case Events::GUILD_ROSTER_UPDATE: return "GUILD_ROSTER_UPDATE";
-            case Events::GM_PLAYER_INFO: return "GM_PLAYER_INFO";
-            case Events::MAIL_SHOW: return "MAIL_SHOW";
-            case Events::MAIL_CLOSED: return "MAIL_CLOSED";
-            case Events::SEND_MAIL_MONEY_CHANGED: return "SEND_MAIL_MONEY_CHANGED";
-            case Events::SEND_MAIL_COD_CHANGED: return "SEND_MAIL_COD_CHANGED";
-            case Events::MAIL_SEND_INFO_UPDATE: return "MAIL_SEND_INFO_UPDATE";
-            case Events::MAIL_SEND_SUCCESS: return "MAIL_SEND_SUCCESS";
-            case Events::MAIL_INBOX_UPDATE: return "MAIL_INBOX_UPDATE";
-            case Events::BATTLEFIELDS_SHOW: return "BATTLEFIELDS_SHOW";
-            case Events::BATTLEFIELDS_CLOSED: return "BATTLEFIELDS_CLOSED";
-            case Events::UPDATE_BATTLEFIELD_STATUS: return "UPDATE_BATTLEFIELD_STATUS";
-            case Events::UPDATE_BATTLEFIELD_SCORE: return "UPDATE_BATTLEFIELD_SCORE";
-            case Events::AUCTION_HOUSE_SHOW: return "AUCTION_HOUSE_SHOW";
-            case Events::AUCTION_HOUSE_CLOSED: return "AUCTION_HOUSE_CLOSED";
-            case Events::NEW_AUCTION_UPDATE: return "NEW_AUCTION_UPDATE";
-            case Events::AUCTION_ITEM_LIST_UPDATE: return "AUCTION_ITEM_LIST_UPDATE";
-            case Events::AUCTION_OWNED_LIST_UPDATE: return "AUCTION_OWNED_LIST_UPDATE";
-            case Events::AUCTION_BIDDER_LIST_UPDATE: return "AUCTION_BIDDER_LIST_UPDATE";
-            case Events::PET_UI_UPDATE: return "PET_UI_UPDATE";
-            case Events::PET_UI_CLOSE: return "PET_UI_CLOSE";
-            case Events::ADDON_LOADED: return "ADDON_LOADED";
-            case Events::VARIABLES_LOADED: return "VARIABLES_LOADED";
-            case Events::MACRO_ACTION_FORBIDDEN: return "MACRO_ACTION_FORBIDDEN";
-            case Events::ADDON_ACTION_FORBIDDEN: return "ADDON_ACTION_FORBIDDEN";
-            case Events::MEMORY_EXHAUSTED: return "MEMORY_EXHAUSTED";
-            case Events::MEMORY_RECOVERED: return "MEMORY_RECOVERED";
-            case Events::START_AUTOREPEAT_SPELL: return "START_AUTOREPEAT_SPELL";
-            case Events::STOP_AUTOREPEAT_SPELL: return "STOP_AUTOREPEAT_SPELL";
-            case Events::PET_STABLE_SHOW: return "PET_STABLE_SHOW";
-            case Events::PET_STABLE_UPDATE: return "PET_STABLE_UPDATE";
-            case Events::PET_STABLE_UPDATE_PAPERDOLL: return "PET_STABLE_UPDATE_PAPERDOLL";
-            case Events::PET_STABLE_CLOSED: return "PET_STABLE_CLOSED";
-            case Events::CHAT_MSG_COMBAT_SELF_HITS: return "CHAT_MSG_COMBAT_SELF_HITS";
-            case Events::CHAT_MSG_COMBAT_SELF_MISSES: return "CHAT_MSG_COMBAT_SELF_MISSES";
-            case Events::CHAT_MSG_COMBAT_PET_HITS: return "CHAT_MSG_COMBAT_PET_HITS";
-            case Events::CHAT_MSG_COMBAT_PET_MISSES: return "CHAT_MSG_COMBAT_PET_MISSES";
-            case Events::CHAT_MSG_COMBAT_PARTY_HITS: return "CHAT_MSG_COMBAT_PARTY_HITS";
-            case Events::CHAT_MSG_COMBAT_PARTY_MISSES: return "CHAT_MSG_COMBAT_PARTY_MISSES";
-            case Events::CHAT_MSG_COMBAT_FRIENDLYPLAYER_HITS: return "CHAT_MSG_COMBAT_FRIENDLYPLAYER_HITS";
-            case Events::CHAT_MSG_COMBAT_FRIENDLYPLAYER_MISSES: return "CHAT_MSG_COMBAT_FRIENDLYPLAYER_MISSES";
-            case Events::CHAT_MSG_COMBAT_HOSTILEPLAYER_HITS: return "CHAT_MSG_COMBAT_HOSTILEPLAYER_HITS";
-            case Events::CHAT_MSG_COMBAT_HOSTILEPLAYER_MISSES: return "CHAT_MSG_COMBAT_HOSTILEPLAYER_MISSES";
-            case Events::CHAT_MSG_COMBAT_CREATURE_VS_SELF_HITS: return "CHAT_MSG_COMBAT_CREATURE_VS_SELF_HITS";
-            case Events::CHAT_MSG_COMBAT_CREATURE_VS_SELF_MISSES: return "CHAT_MSG_COMBAT_CREATURE_VS_SELF_MISSES";
-            case Events::CHAT_MSG_COMBAT_CREATURE_VS_PARTY_HITS: return "CHAT_MSG_COMBAT_CREATURE_VS_PARTY_HITS";
-            case Events::CHAT_MSG_COMBAT_CREATURE_VS_PARTY_MISSES: return "CHAT_MSG_COMBAT_CREATURE_VS_PARTY_MISSES";
-            case Events::CHAT_MSG_COMBAT_CREATURE_VS_CREATURE_HITS: return "CHAT_MSG_COMBAT_CREATURE_VS_CREATURE_HITS";
-            case Events::CHAT_MSG_COMBAT_CREATURE_VS_CREATURE_MISSES: return "CHAT_MSG_COMBAT_CREATURE_VS_CREATURE_MISSES";
-            case Events::CHAT_MSG_COMBAT_FRIENDLY_DEATH: return "CHAT_MSG_COMBAT_FRIENDLY_DEATH";
-            case Events::CHAT_MSG_COMBAT_HOSTILE_DEATH: return "CHAT_MSG_COMBAT_HOSTILE_DEATH";
-            case Events::CHAT_MSG_COMBAT_XP_GAIN: return "CHAT_MSG_COMBAT_XP_GAIN";
-            case Events::CHAT_MSG_COMBAT_HONOR_GAIN: return "CHAT_MSG_COMBAT_HONOR_GAIN";
-            case Events::CHAT_MSG_SPELL_SELF_DAMAGE: return "CHAT_MSG_SPELL_SELF_DAMAGE";
-            case Events::CHAT_MSG_SPELL_SELF_BUFF: return "CHAT_MSG_SPELL_SELF_BUFF";
-            case Events::CHAT_MSG_SPELL_PET_DAMAGE: return "CHAT_MSG_SPELL_PET_DAMAGE";
-            case Events::CHAT_MSG_SPELL_PET_BUFF: return "CHAT_MSG_SPELL_PET_BUFF";
-            case Events::CHAT_MSG_SPELL_PARTY_DAMAGE: return "CHAT_MSG_SPELL_PARTY_DAMAGE";
-            case Events::CHAT_MSG_SPELL_PARTY_BUFF: return "CHAT_MSG_SPELL_PARTY_BUFF";
-            case Events::CHAT_MSG_SPELL_FRIENDLYPLAYER_DAMAGE: return "CHAT_MSG_SPELL_FRIENDLYPLAYER_DAMAGE";
-            case Events::CHAT_MSG_SPELL_FRIENDLYPLAYER_BUFF: return "CHAT_MSG_SPELL_FRIENDLYPLAYER_BUFF";
-            case Events::CHAT_MSG_SPELL_HOSTILEPLAYER_DAMAGE: return "CHAT_MSG_SPELL_HOSTILEPLAYER_DAMAGE";
-            case Events::CHAT_MSG_SPELL_HOSTILEPLAYER_BUFF: return "CHAT_MSG_SPELL_HOSTILEPLAYER_BUFF";
-            case Events::CHAT_MSG_SPELL_CREATURE_VS_SELF_DAMAGE: return "CHAT_MSG_SPELL_CREATURE_VS_SELF_DAMAGE";
-            case Events::CHAT_MSG_SPELL_CREATURE_VS_SELF_BUFF: return "CHAT_MSG_SPELL_CREATURE_VS_SELF_BUFF";
-            case Events::CHAT_MSG_SPELL_CREATURE_VS_PARTY_DAMAGE: return "CHAT_MSG_SPELL_CREATURE_VS_PARTY_DAMAGE";
-            case Events::CHAT_MSG_SPELL_CREATURE_VS_PARTY_BUFF: return "CHAT_MSG_SPELL_CREATURE_VS_PARTY_BUFF";
-            case Events::CHAT_MSG_SPELL_CREATURE_VS_CREATURE_DAMAGE: return "CHAT_MSG_SPELL_CREATURE_VS_CREATURE_DAMAGE";
-            case Events::CHAT_MSG_SPELL_CREATURE_VS_CREATURE_BUFF: return "CHAT_MSG_SPELL_CREATURE_VS_CREATURE_BUFF";
-            case Events::CHAT_MSG_SPELL_TRADESKILLS: return "CHAT_MSG_SPELL_TRADESKILLS";
-            case Events::CHAT_MSG_SPELL_DAMAGESHIELDS_ON_SELF: return "CHAT_MSG_SPELL_DAMAGESHIELDS_ON_SELF";
-            case Events::CHAT_MSG_SPELL_DAMAGESHIELDS_ON_OTHERS: return "CHAT_MSG_SPELL_DAMAGESHIELDS_ON_OTHERS";
-            case Events::CHAT_MSG_SPELL_AURA_GONE_SELF: return "CHAT_MSG_SPELL_AURA_GONE_SELF";
-            case Events::CHAT_MSG_SPELL_AURA_GONE_PARTY: return "CHAT_MSG_SPELL_AURA_GONE_PARTY";
-            case Events::CHAT_MSG_SPELL_AURA_GONE_OTHER: return "CHAT_MSG_SPELL_AURA_GONE_OTHER";
-            case Events::CHAT_MSG_SPELL_ITEM_ENCHANTMENTS: return "CHAT_MSG_SPELL_ITEM_ENCHANTMENTS";
-            case Events::CHAT_MSG_SPELL_BREAK_AURA: return "CHAT_MSG_SPELL_BREAK_AURA";
-            case Events::CHAT_MSG_SPELL_PERIODIC_SELF_DAMAGE: return "CHAT_MSG_SPELL_PERIODIC_SELF_DAMAGE";
-            case Events::CHAT_MSG_SPELL_PERIODIC_SELF_BUFFS: return "CHAT_MSG_SPELL_PERIODIC_SELF_BUFFS";
-            case Events::CHAT_MSG_SPELL_PERIODIC_PARTY_DAMAGE: return "CHAT_MSG_SPELL_PERIODIC_PARTY_DAMAGE";
-            case Events::CHAT_MSG_SPELL_PERIODIC_PARTY_BUFFS: return "CHAT_MSG_SPELL_PERIODIC_PARTY_BUFFS";
-            case Events::CHAT_MSG_SPELL_PERIODIC_FRIENDLYPLAYER_DAMAGE: return "CHAT_MSG_SPELL_PERIODIC_FRIENDLYPLAYER_DAMAGE";
-            case Events::CHAT_MSG_SPELL_PERIODIC_FRIENDLYPLAYER_BUFFS: return "CHAT_MSG_SPELL_PERIODIC_FRIENDLYPLAYER_BUFFS";
-            case Events::CHAT_MSG_SPELL_PERIODIC_HOSTILEPLAYER_DAMAGE: return "CHAT_MSG_SPELL_PERIODIC_HOSTILEPLAYER_DAMAGE";
-            case Events::CHAT_MSG_SPELL_PERIODIC_HOSTILEPLAYER_BUFFS: return "CHAT_MSG_SPELL_PERIODIC_HOSTILEPLAYER_BUFFS";
-            case Events::CHAT_MSG_SPELL_PERIODIC_CREATURE_DAMAGE: return "CHAT_MSG_SPELL_PERIODIC_CREATURE_DAMAGE";
-            case Events::CHAT_MSG_SPELL_PERIODIC_CREATURE_BUFFS: return "CHAT_MSG_SPELL_PERIODIC_CREATURE_BUFFS";
-            case Events::CHAT_MSG_SPELL_FAILED_LOCALPLAYER: return "CHAT_MSG_SPELL_FAILED_LOCALPLAYER";
-            case Events::CHAT_MSG_BG_SYSTEM_NEUTRAL: return "CHAT_MSG_BG_SYSTEM_NEUTRAL";
-            case Events::CHAT_MSG_BG_SYSTEM_ALLIANCE: return "CHAT_MSG_BG_SYSTEM_ALLIANCE";
-            case Events::CHAT_MSG_BG_SYSTEM_HORDE: return "CHAT_MSG_BG_SYSTEM_HORDE";
-            case Events::RAID_ROSTER_UPDATE: return "RAID_ROSTER_UPDATE";
-            case Events::UPDATE_PENDING_MAIL: return "UPDATE_PENDING_MAIL";
-            case Events::UPDATE_INVENTORY_ALERTS: return "UPDATE_INVENTORY_ALERTS";
-            case Events::UPDATE_TRADESKILL_RECAST: return "UPDATE_TRADESKILL_RECAST";
-            case Events::OPEN_MASTER_LOOT_LIST: return "OPEN_MASTER_LOOT_LIST";
-            case Events::UPDATE_MASTER_LOOT_LIST: return "UPDATE_MASTER_LOOT_LIST";
-            case Events::START_LOOT_ROLL: return "START_LOOT_ROLL";
-            case Events::CANCEL_LOOT_ROLL: return "CANCEL_LOOT_ROLL";
-            case Events::CONFIRM_LOOT_ROLL: return "CONFIRM_LOOT_ROLL";
-            case Events::INSTANCE_BOOT_START: return "INSTANCE_BOOT_START";
-            case Events::INSTANCE_BOOT_STOP: return "INSTANCE_BOOT_STOP";
-            case Events::LEARNED_SPELL_IN_TAB: return "LEARNED_SPELL_IN_TAB";
-            case Events::DISPLAY_SIZE_CHANGED: return "DISPLAY_SIZE_CHANGED";
-            case Events::CONFIRM_TALENT_WIPE: return "CONFIRM_TALENT_WIPE";
-            case Events::CONFIRM_BINDER: return "CONFIRM_BINDER";
-            case Events::MAIL_FAILED: return "MAIL_FAILED";
-            case Events::CLOSE_INBOX_ITEM: return "CLOSE_INBOX_ITEM";
-            case Events::CONFIRM_SUMMON: return "CONFIRM_SUMMON";
-            case Events::BILLING_NAG_DIALOG: return "BILLING_NAG_DIALOG";
-            case Events::IGR_BILLING_NAG_DIALOG: return "IGR_BILLING_NAG_DIALOG";
-            case Events::MEETINGSTONE_CHANGED: return "MEETINGSTONE_CHANGED";
-            case Events::PLAYER_SKINNED: return "PLAYER_SKINNED";
-            case Events::TABARD_SAVE_PENDING: return "TABARD_SAVE_PENDING";
-            case Events::UNIT_QUEST_LOG_CHANGED: return "UNIT_QUEST_LOG_CHANGED";
-            case Events::PLAYER_PVP_KILLS_CHANGED: return "PLAYER_PVP_KILLS_CHANGED";
-            case Events::PLAYER_PVP_RANK_CHANGED: return "PLAYER_PVP_RANK_CHANGED";
-            case Events::INSPECT_HONOR_UPDATE: return "INSPECT_HONOR_UPDATE";
-            case Events::UPDATE_WORLD_STATES: return "UPDATE_WORLD_STATES";
-            case Events::AREA_SPIRIT_HEALER_IN_RANGE: return "AREA_SPIRIT_HEALER_IN_RANGE";
-            case Events::AREA_SPIRIT_HEALER_OUT_OF_RANGE: return "AREA_SPIRIT_HEALER_OUT_OF_RANGE";
-            case Events::CONFIRM_PET_UNLEARN: return "CONFIRM_PET_UNLEARN";
-            case Events::PLAYTIME_CHANGED: return "PLAYTIME_CHANGED";
-            case Events::UPDATE_LFG_TYPES: return "UPDATE_LFG_TYPES";
-            case Events::UPDATE_LFG_LIST: return "UPDATE_LFG_LIST";
-            case Events::CHAT_MSG_COMBAT_FACTION_CHANGE: return "CHAT_MSG_COMBAT_FACTION_CHANGE";
-            case Events::START_MINIGAME: return "START_MINIGAME";
-            case Events::MINIGAME_UPDATE: return "MINIGAME_UPDATE";
-            case Events::READY_CHECK: return "READY_CHECK";
-            case Events::RAID_TARGET_UPDATE: return "RAID_TARGET_UPDATE";
-            case Events::GMSURVEY_DISPLAY: return "GMSURVEY_DISPLAY";
-            case Events::UPDATE_INSTANCE_INFO: return "UPDATE_INSTANCE_INFO";
-            case Events::SPELL_CAST_EVENT: return "SPELL_CAST_EVENT";
-            case Events::CHAT_MSG_RAID_BOSS_EMOTE: return "CHAT_MSG_RAID_BOSS_EMOTE";
-            case Events::COMBAT_TEXT_UPDATE: return "COMBAT_TEXT_UPDATE";
-            case Events::LOTTERY_SHOW: return "LOTTERY_SHOW";
-            case Events::CHAT_MSG_FILTERED: return "CHAT_MSG_FILTERED";
-            case Events::QUEST_WATCH_UPDATE: return "QUEST_WATCH_UPDATE";
-            case Events::CHAT_MSG_BATTLEGROUND: return "CHAT_MSG_BATTLEGROUND";
-            case Events::CHAT_MSG_BATTLEGROUND_LEADER: return "CHAT_MSG_BATTLEGROUND_LEADER";
-            case Events::LOTTERY_ITEM_UPDATE: return "LOTTERY_ITEM_UPDATE";
-            case Events::SPELL_DAMAGE_EVENT_SELF: return "SPELL_DAMAGE_EVENT_SELF";
-            case Events::SPELL_DAMAGE_EVENT_OTHER: return "SPELL_DAMAGE_EVENT_OTHER";
-            case Events::UNIT_CASTEVENT: return "UNIT_CASTEVENT";
-            case Events::RAW_COMBATLOG: return "RAW_COMBATLOG";
-            case Events::CREATE_CHATBUBBLE: return "CREATE_CHATBUBBLE";
-            case Events::OTHER_UI_EVENTS: return "OTHER_UI_EVENTS";
-            default: return "UNKNOWN_EVENT_" + std::to_string(eventCode);
+    std::ostream &operator<<(std::ostream &os, EventNameOf event) {
+        const char *name = GetEventName(event.eventCode);
+        if (name != nullptr) {
+            return os << name;
         }
+        return os << "UNKNOWN_EVENT_" << event.eventCode;
     }
-}
\ No newline at end of file
+}
@@ -1,15 +1,14 @@
 #pragma once
 
 #include "stats.hpp"
-#include <map>
 #include <string>
-#include <queue>
 #include <vector>
 #include <cstdint>
 #include <chrono>
+#include <iosfwd>
 
 namespace perf_monitor {
-    typedef enum EVENT_ID {
+    typedef enum EVENT_ID : int {
         EVENT_ID_CAPTURECHANGED = 0,
         EVENT_ID_CHAR = 1,
         EVENT_ID_FOCUS = 2,
@@ -478,20 +477,34 @@ namespace perf_monitor {
     };
 
     // Event tracking globals
-    extern std::map<EVENT_ID, FunctionStats> gEventStats;
-    extern std::map<std::string, FunctionStats> gAddonStats;
-    extern std::map<std::string, FunctionStats> gAddonScriptEventStats;
-    extern std::map<std::string, FunctionStats> gAddonOnUpdateStats;
-    extern std::map<std::string, std::priority_queue<EventStats>> gAddonSlowEvents;
     extern int gLastEventCode;
     
     // Per-event code duration tracking
-    extern std::map<int, FunctionStats> gEventCodeStats;
-    extern std::map<int, std::chrono::high_resolution_clock::time_point> gEventCodeStartTimes;
+    // Event codes are stored in flat arrays: codes 0..MAX_EVENT_CODE index directly, OTHER_UI_EVENTS
+    // and anything else the client sends get the two slots after that
+    constexpr int MAX_EVENT_CODE = Events::CREATE_CHATBUBBLE;
+    constexpr int OTHER_UI_EVENTS_SLOT = MAX_EVENT_CODE + 1;
+    constexpr int UNKNOWN_EVENT_SLOT = MAX_EVENT_CODE + 2;
+    constexpr int EVENT_CODE_SLOTS = MAX_EVENT_CODE + 3;
 
-    // Event initialization
+    constexpr int EventCodeSlot(int eventCode) {
+        return eventCode >= 0 && eventCode <= MAX_EVENT_CODE ? eventCode
+                                                             : eventCode == static_cast<int>(Events::OTHER_UI_EVENTS)
+                                                               ? OTHER_UI_EVENTS_SLOT : UNKNOWN_EVENT_SLOT;
+    }
+
+    extern uint64_t gEventCodeStartTimes[EVENT_CODE_SLOTS]; // start timestamps in timer ticks, 0 when not running
+
+    // Seeds the named event and event code stats in both stats windows
     void initializeEventStats();
 
-    // Get event name from event code
-    std::string GetEventName(int eventCode);
+    // Static name for an event code, nullptr if the code isn't known
+    const char *GetEventName(int eventCode);
+
+    // Streams the event name, or UNKNOWN_EVENT_<code>, without building a string
+    struct EventNameOf {
+        int eventCode;
+    };
+
+    std::ostream &operator<<(std::ostream &os, EventNameOf event);
 }
\ No newline at end of file
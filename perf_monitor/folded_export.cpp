@@ -0,0 +1,244 @@
+#include "folded_export.hpp"
+#include "timing.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+namespace perf_monitor {
+    static const char *WINDOW_FOLDED_PATH_FORMAT = "perf_monitor_window_%04u.folded";
+    static const char *WINDOW_FOLDED_PREFIX = "perf_monitor_window_";
+    static const char *FOLDED_SUFFIX = ".folded";
+    static const char *SESSION_FOLDED_PATH = "perf_monitor_session.folded";
+    static const char *SPEEDSCOPE_PATH = "perf_monitor.speedscope.json";
+
+    // Per window files kept on disk, the last 10 minutes
+    constexpr unsigned FOLDED_WINDOWS_KEPT = 20;
+    static unsigned gFoldedWindowCount = 0;
+
+    // perf_monitor_window_<number>.folded, anything else in the directory is left alone
+    static bool IsWindowFoldedFile(const char *name) {
+        size_t prefixLength = std::strlen(WINDOW_FOLDED_PREFIX);
+        size_t suffixLength = std::strlen(FOLDED_SUFFIX);
+        size_t length = std::strlen(name);
+        if (length <= prefixLength + suffixLength || std::strncmp(name, WINDOW_FOLDED_PREFIX, prefixLength) != 0 ||
+            std::strcmp(name + length - suffixLength, FOLDED_SUFFIX) != 0) {
+            return false;
+        }
+        for (size_t i = prefixLength; i < length - suffixLength; ++i) {
+            if (!std::isdigit(static_cast<unsigned char>(name[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Window files of earlier sessions, numbering starts over every session and the retention cap
+    // only ever reaches files of this one
+    static void RemoveEarlierWindowFiles() {
+#ifdef _WIN32
+        WIN32_FIND_DATAA found;
+        HANDLE search = FindFirstFileA("perf_monitor_window_*.folded", &found);
+        if (search == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        do {
+            if (IsWindowFoldedFile(found.cFileName)) {
+                std::remove(found.cFileName);
+            }
+        } while (FindNextFileA(search, &found));
+        FindClose(search);
+#else
+        DIR *directory = opendir(".");
+        if (directory == nullptr) {
+            return;
+        }
+        while (dirent *entry = readdir(directory)) {
+            if (IsWindowFoldedFile(entry->d_name)) {
+                std::remove(entry->d_name);
+            }
+        }
+        closedir(directory);
+#endif
+    }
+
+    // Self time of every call tree node in the window being exported and summed over all reported
+    // windows, in ticks
+    static uint64_t gWindowSelfTime[MAX_CALL_TREE_NODES];
+    static uint64_t gSessionSelfTime[MAX_CALL_TREE_NODES];
+
+    // A call path with self time, frames are indexes into FoldedProfile::frameNames, outermost first
+    struct FoldedStack {
+        std::vector<size_t> frames;
+        CallTreeNodeId node;
+    };
+
+    struct FoldedProfile {
+        std::vector<std::string> frameNames;
+        std::vector<FoldedStack> stacks;
+    };
+
+    static void CollectStacks(CallTreeNodeId node, std::vector<size_t> &path, FoldedProfile &profile,
+                              std::unordered_map<CallFrameKey, size_t> &frameIndexes) {
+        for (CallTreeNodeId child = GetCallTreeFirstChild(node);
+             child != CALL_TREE_ROOT; child = GetCallTreeNextSibling(child)) {
+            CallFrameKey key = GetCallTreeNodeKey(child);
+            auto frame = frameIndexes.find(key);
+            if (frame == frameIndexes.end()) {
+                frame = frameIndexes.emplace(key, profile.frameNames.size()).first;
+                profile.frameNames.push_back(GetCallFrameName(key));
+            }
+
+            path.push_back(frame->second);
+            profile.stacks.push_back({path, child});
+            CollectStacks(child, path, profile, frameIndexes);
+            path.pop_back();
+        }
+    }
+
+    // ';' separates frames in the folded format
+    static std::string FoldedFrameName(std::string name) {
+        for (char &c: name) {
+            if (c == ';') {
+                c = ':';
+            }
+        }
+        return name;
+    }
+
+    static void WriteFoldedFile(const char *path, const FoldedProfile &profile, const uint64_t *selfTime) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) {
+            return;
+        }
+
+        for (const auto &stack: profile.stacks) {
+            auto selfUs = static_cast<uint64_t>(TicksToUs(selfTime[stack.node]) + 0.5);
+            if (selfUs == 0) {
+                continue;
+            }
+            for (size_t i = 0; i < stack.frames.size(); ++i) {
+                if (i > 0) {
+                    file << ';';
+                }
+                file << FoldedFrameName(profile.frameNames[stack.frames[i]]);
+            }
+            file << ' ' << selfUs << '\n';
+        }
+    }
+
+    static void WriteJsonString(std::ostream &out, const std::string &text) {
+        out << '"';
+        for (char c: text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                    << std::dec << std::setfill(' ');
+            } else {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+
+    // A "sampled" speedscope profile, one sample per call path weighted by its self time
+    static void WriteSpeedscopeProfile(std::ostream &out, const char *name, const FoldedProfile &profile,
+                                       const uint64_t *selfTime) {
+        double totalUs = 0;
+        out << "{\"type\":\"sampled\",\"name\":\"" << name << "\",\"unit\":\"microseconds\",\"startValue\":0,";
+
+        out << "\"samples\":[";
+        bool first = true;
+        for (const auto &stack: profile.stacks) {
+            if (selfTime[stack.node] == 0) {
+                continue;
+            }
+            out << (first ? "[" : ",[");
+            for (size_t i = 0; i < stack.frames.size(); ++i) {
+                out << (i > 0 ? "," : "") << stack.frames[i];
+            }
+            out << ']';
+            first = false;
+        }
+
+        out << "],\"weights\":[";
+        first = true;
+        for (const auto &stack: profile.stacks) {
+            if (selfTime[stack.node] == 0) {
+                continue;
+            }
+            double selfUs = TicksToUs(selfTime[stack.node]);
+            totalUs += selfUs;
+            out << (first ? "" : ",") << selfUs;
+            first = false;
+        }
+
+        out << "],\"endValue\":" << totalUs << '}';
+    }
+
+    static void WriteSpeedscopeFile(const FoldedProfile &profile) {
+        std::ofstream file(SPEEDSCOPE_PATH, std::ios::trunc);
+        if (!file) {
+            return;
+        }
+
+        file << std::fixed << std::setprecision(3);
+        file << "{\"$schema\":\"https://www.speedscope.app/file-format-schema.json\","
+                "\"name\":\"perf_monitor\",\"exporter\":\"perf_monitor\",\"activeProfileIndex\":0,"
+                "\"shared\":{\"frames\":[";
+        for (size_t i = 0; i < profile.frameNames.size(); ++i) {
+            file << (i > 0 ? ",{\"name\":" : "{\"name\":");
+            WriteJsonString(file, profile.frameNames[i]);
+            file << '}';
+        }
+        file << "]},\"profiles\":[\n";
+        WriteSpeedscopeProfile(file, "Last window", profile, gWindowSelfTime);
+        file << ",\n";
+        WriteSpeedscopeProfile(file, "Session", profile, gSessionSelfTime);
+        file << "\n]}\n";
+    }
+
+    void ExportFoldedStacks(const CallTreeWindow &tree) {
+        size_t nodeCount = GetCallTreeNodeCount();
+
+        // Node ids are stable for the whole session, so windows add up node by node
+        for (size_t node = 1; node < nodeCount; ++node) {
+            gWindowSelfTime[node] = tree.nodes[node].selfTime;
+            gSessionSelfTime[node] += tree.nodes[node].selfTime;
+        }
+
+        // Nodes added by the game thread while walking have no time in this window yet
+        FoldedProfile profile;
+        std::vector<size_t> path;
+        std::unordered_map<CallFrameKey, size_t> frameIndexes;
+        CollectStacks(CALL_TREE_ROOT, path, profile, frameIndexes);
+
+        // Numbered from 1 every session, the file that falls out of the retention cap is removed
+        char windowPath[64];
+        if (gFoldedWindowCount == 0) {
+            RemoveEarlierWindowFiles();
+        }
+        ++gFoldedWindowCount;
+        std::snprintf(windowPath, sizeof(windowPath), WINDOW_FOLDED_PATH_FORMAT, gFoldedWindowCount);
+        WriteFoldedFile(windowPath, profile, gWindowSelfTime);
+        if (gFoldedWindowCount > FOLDED_WINDOWS_KEPT) {
+            std::snprintf(windowPath, sizeof(windowPath), WINDOW_FOLDED_PATH_FORMAT,
+                          gFoldedWindowCount - FOLDED_WINDOWS_KEPT);
+            std::remove(windowPath);
+        }
+        WriteFoldedFile(SESSION_FOLDED_PATH, profile, gSessionSelfTime);
+        WriteSpeedscopeFile(profile);
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "call_tree.hpp"
+
+namespace perf_monitor {
+    // Writes the self time of every call path of a retired window, and of the session so far, as
+    // flamegraph input:
+    //   perf_monitor_window_NNNN.folded  window NNNN of the session, Brendan Gregg folded stacks
+    //                                    ("a;b;c us"), only the last 20 are kept and the first
+    //                                    window removes those of earlier sessions
+    //   perf_monitor_session.folded      every window so far
+    //   perf_monitor.speedscope.json     the latest window and the session as speedscope profiles
+    // Stats worker only.
+    void ExportFoldedStacks(const CallTreeWindow &tree);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "addon_names.hpp"
+
+namespace perf_monitor {
+    // Open addressing cache from (frame object, script addon pointer) to the addon id it resolved to,
+    // so the hooks only walk the frame's strings the first time they see it.  Entries are hashed by
+    // frame alone so every entry for a frame shares one probe run and can be dropped together.
+    // Game thread only.
+    class FrameAddonCache {
+    public:
+        static constexpr size_t SLOTS = 4096;
+        static constexpr size_t MAX_PROBES = 8;
+
+        bool lookup(const uintptr_t *frame, const uintptr_t *addonNamePtr, AddonId &addonId) const {
+            size_t slot = homeSlot(frame);
+            for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+                const Entry &entry = entries[(slot + probe) & (SLOTS - 1)];
+                if (entry.generation != generation) {
+                    return false;
+                }
+                if (entry.frame == frame && entry.addonNamePtr == addonNamePtr) {
+                    addonId = entry.addonId;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void insert(const uintptr_t *frame, const uintptr_t *addonNamePtr, AddonId addonId) {
+            size_t slot = homeSlot(frame);
+            Entry *target = nullptr;
+            for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+                Entry &entry = entries[(slot + probe) & (SLOTS - 1)];
+                bool empty = entry.generation != generation;
+                if (!empty && entry.frame == frame && entry.addonNamePtr == addonNamePtr) {
+                    target = &entry;
+                    break;
+                }
+                if (target == nullptr && (empty || entry.frame == nullptr)) {
+                    target = &entry;
+                }
+                if (empty) {
+                    break;
+                }
+            }
+            // Probe run is full, evict the home slot
+            if (target == nullptr) {
+                target = &entries[slot];
+            }
+
+            target->frame = frame;
+            target->addonNamePtr = addonNamePtr;
+            target->generation = generation;
+            target->addonId = addonId;
+        }
+
+        // Leaves a tombstone (null frame, current generation) for every entry of frame
+        void erase(const uintptr_t *frame) {
+            size_t slot = homeSlot(frame);
+            for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+                Entry &entry = entries[(slot + probe) & (SLOTS - 1)];
+                if (entry.generation != generation) {
+                    return;
+                }
+                if (entry.frame == frame) {
+                    entry.frame = nullptr;
+                }
+            }
+        }
+
+        // Drops every entry (and tombstone) at once
+        void invalidateAll() {
+            ++generation;
+        }
+
+    private:
+        struct Entry {
+            const uintptr_t *frame = nullptr;
+            const uintptr_t *addonNamePtr = nullptr;
+            uint32_t generation = 0; // anything but the cache's current generation is an empty slot
+            AddonId addonId = ADDON_NONE;
+        };
+
+        static size_t homeSlot(const uintptr_t *frame) {
+            // Frames are at least 8 byte aligned, fibonacci hash the rest
+            auto bits = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(frame) >> 3);
+            return static_cast<size_t>((bits * 2654435761u) >> 20) & (SLOTS - 1);
+        }
+
+        Entry entries[SLOTS];
+        uint32_t generation = 1;
+    };
+}
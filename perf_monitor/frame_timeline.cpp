@@ -0,0 +1,52 @@
+#include "frame_timeline.hpp"
+#include "call_tree.hpp"
+
+#include <atomic>
+#include <cstring>
+
+namespace perf_monitor {
+    static FrameRecord gFrameRing[FRAME_RING_SIZE];
+    static std::atomic<uint64_t> gRecordedFrameCount{0};
+
+    // Game thread state for the frame being built
+    static uint64_t gFrameSplits[FRAME_SPLIT_COUNT] = {};
+    static uint64_t gPreviousFrameEnd = 0;
+
+    void AddFrameSplit(FrameSplit split, uint64_t duration) {
+        gFrameSplits[split] += CallTreeSplitSelfTime(duration);
+    }
+
+    const FrameRecord &RecordFrame(uint64_t startTicks, uint64_t paintScreenDuration) {
+        uint64_t count = gRecordedFrameCount.load(std::memory_order_relaxed);
+        FrameRecord &record = gFrameRing[count & (FRAME_RING_SIZE - 1)];
+
+        record.startTicks = startTicks;
+        uint64_t endTicks = startTicks + paintScreenDuration;
+        record.frameTime = gPreviousFrameEnd != 0 ? endTicks - gPreviousFrameEnd : 0;
+        record.paintScreen = paintScreenDuration;
+        std::memcpy(record.splits, gFrameSplits, sizeof(gFrameSplits));
+
+        gPreviousFrameEnd = endTicks;
+        std::memset(gFrameSplits, 0, sizeof(gFrameSplits));
+
+        // Publish the record before the count that covers it
+        gRecordedFrameCount.store(count + 1, std::memory_order_release);
+        return record;
+    }
+
+    uint64_t GetRecordedFrameCount() {
+        return gRecordedFrameCount.load(std::memory_order_acquire);
+    }
+
+    void CopyFrames(uint64_t first, uint64_t end, ArenaVector<FrameRecord> &frames) {
+        frames.clear();
+        // Anything older than one ring has been overwritten
+        if (end - first > FRAME_RING_SIZE) {
+            first = end - FRAME_RING_SIZE;
+        }
+        frames.reserve(static_cast<size_t>(end - first));
+        for (uint64_t frame = first; frame < end; ++frame) {
+            frames.push_back(gFrameRing[frame & (FRAME_RING_SIZE - 1)]);
+        }
+    }
+}
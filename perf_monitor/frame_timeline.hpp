@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "monitor_arena.hpp"
+
+namespace perf_monitor {
+    // Subsystems whose time is split out per frame
+    enum FrameSplit : uint8_t {
+        FRAME_SPLIT_WORLD_RENDER,
+        FRAME_SPLIT_WORLD_UPDATE,
+        FRAME_SPLIT_UI_UPDATE,
+        FRAME_SPLIT_SCRIPT_EVENTS,
+        FRAME_SPLIT_GARBAGE_COLLECTION,
+
+        FRAME_SPLIT_COUNT
+    };
+
+    constexpr const char *kFrameSplitNames[FRAME_SPLIT_COUNT] = {
+            "World render",
+            "World update",
+            "UI update",
+            "Script events",
+            "Garbage collection",
+    };
+
+    // One frame, running from the end of the previous PaintScreen to the end of this one so the
+    // frame time and the splits cover the same span.  Durations in timer ticks.
+    struct FrameRecord {
+        uint64_t startTicks;                // PaintScreen start
+        uint64_t frameTime;                 // 0 for the first frame
+        uint64_t paintScreen;
+        uint64_t splits[FRAME_SPLIT_COUNT]; // self time in each subsystem, see AddFrameSplit
+    };
+
+    static_assert(sizeof(FrameRecord) == 64, "FrameRecord should stay one cache line");
+
+    // 4MB, a little over 18 minutes at 60 fps
+    constexpr size_t FRAME_RING_SIZE = 1 << 16;
+
+    // Game thread only.  Adds hooked time to the frame currently being built, called before the
+    // hook's CallTreeLeave.  Split hooks nest (script events run inside UI and world update), so
+    // only the time not already charged to a nested split is added and the splits of a frame sum to
+    // at most the frame time.
+    void AddFrameSplit(FrameSplit split, uint64_t duration);
+
+    // Game thread only.  Closes the current frame and publishes it to the ring.
+    const FrameRecord &RecordFrame(uint64_t startTicks, uint64_t paintScreenDuration);
+
+    // Number of frames recorded so far, frame n lives in ring slot n % FRAME_RING_SIZE
+    uint64_t GetRecordedFrameCount();
+
+    // Copies frames [first, end) that are still in the ring, oldest first.  Safe from any thread as
+    // long as end was read from GetRecordedFrameCount.
+    void CopyFrames(uint64_t first, uint64_t end, ArenaVector<FrameRecord> &frames);
+}
@@ -0,0 +1,238 @@
+#include "hitch_capture.hpp"
+#include "config.hpp"
+#include "events.hpp"
+#include "stats.hpp"
+#include "thread_shards.hpp"
+#include "trace_export.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
+namespace perf_monitor {
+    struct SpanBuffer {
+        Span spans[MAX_FRAME_SPANS];
+        size_t count = 0;
+        size_t dropped = 0;        // spans past MAX_FRAME_SPANS
+        FrameRecord frame = {};
+        size_t skippedHitches = 0; // earlier hitches lost while the writer was busy
+    };
+
+    // The hooks fill the active buffer, a captured hitch swaps in the other one
+    static SpanBuffer gSpanBuffers[2];
+    static SpanBuffer *gActiveSpans = &gSpanBuffers[0];
+    static bool gHitchCaptureEnabled = false;
+    static uint64_t gHitchThresholdTicks = 0;
+    static size_t gSkippedHitches = 0;
+
+    // Writer handoff, leaked for the same reason as the stats worker's
+    static std::mutex &gHitchWriterMutex = *new std::mutex;
+    static std::condition_variable &gHitchWriterCondition = *new std::condition_variable;
+    static SpanBuffer *gPendingHitch = nullptr;
+    static std::atomic<bool> gHitchWriteInFlight{false};
+    static std::FILE *gHitchFile = nullptr;
+
+    static void RecordSpan(const Span &span) {
+        // The span buffers and the trace ring have a single producer, the game thread
+        if (!IsGameThread()) {
+            return;
+        }
+        if (gHitchCaptureEnabled) {
+            SpanBuffer &buffer = *gActiveSpans;
+            if (buffer.count < MAX_FRAME_SPANS) {
+                buffer.spans[buffer.count++] = span;
+            } else {
+                buffer.dropped++;
+            }
+        }
+        if (IsTraceRunning()) {
+            PushTraceSpan(span);
+        }
+    }
+
+    void RecordHookSpan(MetricId metric, uint64_t start, uint64_t duration) {
+        if (!gHitchCaptureEnabled && !IsTraceRunning()) {
+            return;
+        }
+        Span span;
+        span.start = start;
+        span.duration = duration;
+        span.eventCode = 0;
+        span.memoryDelta = 0;
+        span.metric = metric;
+        span.addonId = ADDON_NONE;
+        span.kind = SPAN_HOOK;
+        RecordSpan(span);
+    }
+
+    void RecordAddonSpan(SpanKind kind, AddonId addonId, int eventCode, uint64_t start, uint64_t duration,
+                         int memoryDelta) {
+        if (!gHitchCaptureEnabled && !IsTraceRunning()) {
+            return;
+        }
+        Span span;
+        span.start = start;
+        span.duration = duration;
+        span.eventCode = eventCode;
+        span.memoryDelta = memoryDelta;
+        span.metric = METRIC_NONE;
+        span.addonId = addonId;
+        span.kind = kind;
+        RecordSpan(span);
+    }
+
+    void RecordEventSpan(int eventCode, uint64_t start, uint64_t duration) {
+        RecordAddonSpan(SPAN_SIGNAL_EVENT, ADDON_NONE, eventCode, start, duration, 0);
+    }
+
+    void EndFrameSpans(const FrameRecord &frame) {
+        UpdateTraceWindow(frame.startTicks + frame.paintScreen);
+        if (!gHitchCaptureEnabled) {
+            return;
+        }
+
+        if (frame.frameTime != 0 && frame.frameTime >= gHitchThresholdTicks) {
+            if (!gHitchWriteInFlight.load(std::memory_order_acquire)) {
+                SpanBuffer *hitch = gActiveSpans;
+                hitch->frame = frame;
+                hitch->skippedHitches = gSkippedHitches;
+                gSkippedHitches = 0;
+
+                gHitchWriteInFlight.store(true, std::memory_order_relaxed);
+                {
+                    std::lock_guard<std::mutex> lock(gHitchWriterMutex);
+                    gPendingHitch = hitch;
+                }
+                gHitchWriterCondition.notify_one();
+
+                // The writer is idle, so the other buffer is free
+                gActiveSpans = hitch == &gSpanBuffers[0] ? &gSpanBuffers[1] : &gSpanBuffers[0];
+            } else {
+                gSkippedHitches++;
+            }
+        }
+
+        gActiveSpans->count = 0;
+        gActiveSpans->dropped = 0;
+    }
+
+    static void WriteSpanLabel(std::FILE *file, const Span &span) {
+        if (span.kind == SPAN_HOOK) {
+            std::fputs(kMetricInfo[span.metric].name, file);
+            return;
+        }
+
+        if (span.kind == SPAN_ADDON_ON_UPDATE) {
+            std::fprintf(file, "[%s] OnUpdate", GetAddonName(span.addonId));
+        } else {
+            if (span.kind == SPAN_SIGNAL_EVENT) {
+                std::fputs("SignalEvent ", file);
+            } else {
+                std::fprintf(file, "[%s] OnEvent ", GetAddonName(span.addonId));
+            }
+            const char *eventName = GetEventName(span.eventCode);
+            if (eventName != nullptr) {
+                std::fputs(eventName, file);
+            } else {
+                std::fprintf(file, "UNKNOWN_EVENT_%d", span.eventCode);
+            }
+        }
+        if (span.memoryDelta != 0) {
+            std::fprintf(file, "  lua %+d KB", span.memoryDelta);
+        }
+    }
+
+    static void WriteHitch(SpanBuffer &hitch) {
+        const FrameRecord &frame = hitch.frame;
+        uint64_t frameStart = frame.startTicks + frame.paintScreen - frame.frameTime;
+
+        std::time_t now = std::time(nullptr);
+        std::tm now_tm;
+#ifdef _WIN32
+        localtime_s(&now_tm, &now);
+#else
+        localtime_r(&now, &now_tm);
+#endif
+        char timestamp[32];
+        std::strftime(timestamp, sizeof(timestamp), "%m-%d %H:%M:%S", &now_tm);
+
+        std::fprintf(gHitchFile, "--- HITCH %s: %.2f ms frame, PaintScreen %.2f ms, %zu spans",
+                     timestamp, TicksToMs(frame.frameTime), TicksToMs(frame.paintScreen), hitch.count);
+        if (hitch.dropped > 0) {
+            std::fprintf(gHitchFile, ", %zu not captured", hitch.dropped);
+        }
+        if (hitch.skippedHitches > 0) {
+            std::fprintf(gHitchFile, ", %zu earlier hitches skipped", hitch.skippedHitches);
+        }
+        std::fputs(" ---\n", gHitchFile);
+
+        for (int i = 0; i < FRAME_SPLIT_COUNT; ++i) {
+            std::fprintf(gHitchFile, "%s%s: %.2f ms", i == 0 ? "" : "  ", kFrameSplitNames[i],
+                         TicksToMs(frame.splits[i]));
+        }
+        std::fputs("\n", gHitchFile);
+
+        // Spans are recorded when they end, put parents before their children
+        std::sort(hitch.spans, hitch.spans + hitch.count, [](const Span &a, const Span &b) {
+            return a.start != b.start ? a.start < b.start : a.duration > b.duration;
+        });
+
+        // Nesting depth from the intervals, the spans still open at each start
+        uint64_t openEnds[64];
+        size_t depth = 0;
+        for (size_t i = 0; i < hitch.count; ++i) {
+            const Span &span = hitch.spans[i];
+            while (depth > 0 && span.start >= openEnds[depth - 1]) {
+                --depth;
+            }
+
+            double offsetMs = span.start >= frameStart ? TicksToMs(span.start - frameStart) : 0.0;
+            std::fprintf(gHitchFile, "%9.3f ms %9.3f ms  %*s", offsetMs, TicksToMs(span.duration),
+                         static_cast<int>(depth * 2), "");
+            WriteSpanLabel(gHitchFile, span);
+            std::fputs("\n", gHitchFile);
+
+            if (depth < sizeof(openEnds) / sizeof(openEnds[0])) {
+                openEnds[depth++] = span.start + span.duration;
+            }
+        }
+        std::fputs("\n", gHitchFile);
+        std::fflush(gHitchFile);
+    }
+
+    static void HitchWriterThread() {
+        while (true) {
+            SpanBuffer *hitch;
+            {
+                std::unique_lock<std::mutex> lock(gHitchWriterMutex);
+                gHitchWriterCondition.wait(lock, [] { return gPendingHitch != nullptr; });
+                hitch = gPendingHitch;
+                gPendingHitch = nullptr;
+            }
+
+            WriteHitch(*hitch);
+            gHitchWriteInFlight.store(false, std::memory_order_release);
+        }
+    }
+
+    bool StartHitchCapture(const char *path) {
+        if (gHitchCaptureEnabled || gConfig.hitchThresholdMs <= 0) {
+            return gHitchCaptureEnabled;
+        }
+
+        gHitchFile = std::fopen(path, "wb");
+        if (!gHitchFile) {
+            return false;
+        }
+
+        gHitchThresholdTicks = UsToTicks(gConfig.hitchThresholdMs * 1000.0);
+        // Never joined, the writer lives as long as the client process
+        std::thread(HitchWriterThread).detach();
+        gHitchCaptureEnabled = true;
+        return true;
+    }
+}
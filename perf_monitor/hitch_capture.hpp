@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "addon_names.hpp"
+#include "frame_timeline.hpp"
+
+namespace perf_monitor {
+    // Forward declarations
+    enum MetricId : uint16_t;
+
+    enum SpanKind : uint8_t {
+        SPAN_HOOK,
+        SPAN_ADDON_EVENT,
+        SPAN_ADDON_ON_UPDATE,
+        SPAN_SIGNAL_EVENT,
+    };
+
+    // One timed call inside the current frame, timer ticks
+    struct Span {
+        uint64_t start;
+        uint64_t duration;
+        int32_t eventCode;   // SPAN_ADDON_EVENT and SPAN_SIGNAL_EVENT only
+        int32_t memoryDelta; // Lua memory change in KB, addon spans only
+        MetricId metric;     // SPAN_HOOK only
+        AddonId addonId;     // addon spans only
+        SpanKind kind;
+    };
+
+    // Spans past this in a single frame are only counted
+    constexpr size_t MAX_FRAME_SPANS = 32768;
+
+    // Every timed call of the current frame is appended to a flat span buffer, which is simply
+    // reset when the frame closes.  Only frames of at least gConfig.hitchThresholdMs are handed to
+    // a writer thread and serialized to the hitch log.  While a trace is running the same spans
+    // are also pushed to the trace exporter.  Game thread only.
+    void RecordHookSpan(MetricId metric, uint64_t start, uint64_t duration);
+
+    void RecordAddonSpan(SpanKind kind, AddonId addonId, int eventCode, uint64_t start, uint64_t duration,
+                         int memoryDelta);
+
+    // SignalEvent from start to the end of its last handler
+    void RecordEventSpan(int eventCode, uint64_t start, uint64_t duration);
+
+    // Closes the span buffer for a frame that was just recorded
+    void EndFrameSpans(const FrameRecord &frame);
+
+    // Opens the hitch log and starts its writer, nothing is recorded until this is called.  Call
+    // after CalibrateTimer and LoadConfigFile.
+    bool StartHitchCapture(const char *path);
+}
@@ -0,0 +1,59 @@
+#include "hook_tiers.hpp"
+#include "config.hpp"
+#include "logging.hpp"
+
+namespace perf_monitor {
+    uint32_t gHookTiers = HOOK_TIER_RENDER_DETAIL | HOOK_TIER_MEMORY;
+
+    struct HookTierInfo {
+        HookTier tier;
+        const char *name;
+        double Config::*enabled;
+    };
+
+    static const HookTierInfo kHookTiers[] = {
+            {HOOK_TIER_RENDER_DETAIL, "render detail", &Config::tierRenderDetail},
+            {HOOK_TIER_MEMORY,        "memory",        &Config::tierMemory},
+    };
+
+    static uint32_t gConfiguredHookTiers = HOOK_TIER_RENDER_DETAIL | HOOK_TIER_MEMORY;
+    static uint32_t gSuppressedHookTiers = 0;
+
+    static void UpdateHookTiers() {
+        uint32_t tiers = gConfiguredHookTiers & ~gSuppressedHookTiers;
+        for (const auto &info: kHookTiers) {
+            if ((tiers & info.tier) != (gHookTiers & info.tier)) {
+                DEBUG_LOG("Hook tier " << info.name << ((tiers & info.tier) != 0 ? " enabled" : " disabled"));
+            }
+        }
+        gHookTiers = tiers;
+    }
+
+    void ApplyHookTiers() {
+        gConfiguredHookTiers = 0;
+        for (const auto &info: kHookTiers) {
+            if (gConfig.*info.enabled > 0) {
+                gConfiguredHookTiers |= info.tier;
+            }
+        }
+        UpdateHookTiers();
+    }
+
+    void SuppressHookTiers(uint32_t tiers) {
+        gSuppressedHookTiers = tiers;
+        UpdateHookTiers();
+    }
+
+    uint32_t GetConfiguredHookTiers() {
+        return gConfiguredHookTiers;
+    }
+
+    const char *GetHookTierName(HookTier tier) {
+        for (const auto &info: kHookTiers) {
+            if (info.tier == tier) {
+                return info.name;
+            }
+        }
+        return "unknown";
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+namespace perf_monitor {
+    // Groups of hooks that can be switched off at runtime.  The minimal tier (frame time, events,
+    // addon OnUpdate/OnEvent totals, garbage collection) is always on.  Hooks stay installed, a
+    // disabled one calls straight through after a single branch on gHookTiers.
+    enum HookTier : uint32_t {
+        HOOK_TIER_RENDER_DETAIL = 1 << 0, // world/scene/model render and update hooks nested in the frame
+        HOOK_TIER_MEMORY = 1 << 1,        // Lua memory delta around every addon handler
+    };
+
+    // Only changed by the game thread at window boundaries, so a window never mixes tiers
+    extern uint32_t gHookTiers;
+
+    inline bool HookTierEnabled(HookTier tier) {
+        return (gHookTiers & tier) != 0;
+    }
+
+    // Sets gHookTiers from the tier_* config keys, minus any suppressed tiers, logging any change
+    void ApplyHookTiers();
+
+    // Tiers the overhead controller turned off regardless of the config, see monitor_overhead.hpp
+    void SuppressHookTiers(uint32_t tiers);
+
+    // Tiers the config asks for, whether or not they are suppressed
+    uint32_t GetConfiguredHookTiers();
+
+    const char *GetHookTierName(HookTier tier);
+}
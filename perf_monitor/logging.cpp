@@ -1,7 +1,142 @@
 
 #include <logging.hpp>
+#include "spsc_ring.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
 
 namespace perf_monitor {
-    std::ofstream debugLogFile;
     uint32_t gStartTime;
-}
\ No newline at end of file
+
+    constexpr size_t LOG_RING_SIZE = 1 << 20;     // several full stats reports
+    constexpr int LOG_WRITER_IDLE_MS = 5;
+
+    static SpscByteRing<LOG_RING_SIZE> gLogRing;
+    static std::FILE *gLogFile = nullptr;
+    static std::atomic<bool> gLogWriterRunning{false};
+
+    // How deep DEBUG_LOG can nest inside a streamed expression on one thread, lines nested any
+    // deeper are counted as dropped
+    constexpr int MAX_LOG_NESTING = 4;
+
+    struct LogLineFormatter {
+        LogLineBuffer buffer;
+        std::ostream stream{&buffer};
+    };
+
+    // Guards pushing into the ring, which has a single producer side, and gDroppedLogLines
+    static std::atomic_flag gLogProducerLock = ATOMIC_FLAG_INIT;
+    static size_t gDroppedLogLines = 0;
+
+    // Per thread, one formatter per nesting level and a last one whose lines are discarded
+    static thread_local LogLineFormatter tLogFormatters[MAX_LOG_NESTING + 1];
+    static thread_local int tLogDepth = 0;
+    static thread_local std::time_t tCachedTimestampSecond = 0;
+    static thread_local char tCachedTimestamp[32] = {};
+
+    // Formats "09-29 14:33:12" at most once per second
+    static const char *GetCachedTimestamp() {
+        std::time_t now = std::time(nullptr);
+        if (now != tCachedTimestampSecond) {
+            std::tm tm_buf;
+#ifdef _WIN32
+            localtime_s(&tm_buf, &now);
+#else
+            localtime_r(&now, &tm_buf);
+#endif
+            std::strftime(tCachedTimestamp, sizeof(tCachedTimestamp), "%m-%d %H:%M:%S", &tm_buf);
+            tCachedTimestampSecond = now;
+        }
+        return tCachedTimestamp;
+    }
+
+    static void LogWriterThread() {
+        bool pendingFlush = false;
+        while (true) {
+            const char *data;
+            size_t size = gLogRing.peek(&data);
+            if (size == 0) {
+                if (pendingFlush) {
+                    std::fflush(gLogFile);
+                    pendingFlush = false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(LOG_WRITER_IDLE_MS));
+                continue;
+            }
+
+            std::fwrite(data, 1, size, gLogFile);
+            gLogRing.consume(size);
+            pendingFlush = true;
+        }
+    }
+
+    bool OpenLogFile(const char *path) {
+        if (gLogWriterRunning.load()) {
+            return true;
+        }
+
+        gLogFile = std::fopen(path, "wb");
+        if (!gLogFile) {
+            return false;
+        }
+
+        gLogWriterRunning.store(true);
+        // Never joined, the writer lives as long as the client process
+        std::thread(LogWriterThread).detach();
+        return true;
+    }
+
+    static void LockLogProducer() {
+        while (gLogProducerLock.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    LogLineScope::LogLineScope(bool withTimestamp) {
+        int depth = tLogDepth++;
+        formatter = &tLogFormatters[depth < MAX_LOG_NESTING ? depth : MAX_LOG_NESTING];
+
+        formatter->buffer.reset();
+        if (withTimestamp) {
+            formatter->stream << GetCachedTimestamp() << ": ";
+        }
+    }
+
+    LogLineScope::~LogLineScope() {
+        if (--tLogDepth >= MAX_LOG_NESTING) {
+            LockLogProducer();
+            ++gDroppedLogLines;
+            gLogProducerLock.clear(std::memory_order_release);
+            return;
+        }
+
+        LogLineBuffer &buffer = formatter->buffer;
+        size_t size = buffer.size();
+        buffer.data()[size++] = '\n';
+
+        LockLogProducer();
+        if (gDroppedLogLines > 0 && gLogWriterRunning.load(std::memory_order_relaxed)) {
+            char note[64];
+            int noteSize = std::snprintf(note, sizeof(note), "[%zu log lines dropped]\n", gDroppedLogLines);
+            if (gLogRing.tryPush(note, static_cast<size_t>(noteSize))) {
+                gDroppedLogLines = 0;
+            }
+        }
+
+        // Only wait for space while the writer is draining, otherwise the ring never empties
+        while (!gLogRing.tryPush(buffer.data(), size)) {
+            if (!gLogWriterRunning.load(std::memory_order_relaxed)) {
+                ++gDroppedLogLines;
+                break;
+            }
+            std::this_thread::yield();
+        }
+
+        gLogProducerLock.clear(std::memory_order_release);
+    }
+
+    std::ostream &LogLineScope::stream() {
+        return formatter->stream;
+    }
+}
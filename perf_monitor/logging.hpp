@@ -9,33 +9,64 @@
 #include <iomanip>
 #include <sstream>
 #include <ctime>
+#include <streambuf>
+#include <ostream>
+#include <cstdint>
 
 namespace perf_monitor {
-    extern std::ofstream debugLogFile;
-
     extern uint32_t gStartTime;
     extern uint32_t GetTime();
 
-    // Returns a human-readable timestamp string, e.g. "2024-09-29 14:33:12"
-    inline std::string GetHumanTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-        std::tm tm_buf;
-    #ifdef _WIN32
-        localtime_s(&tm_buf, &now_c);
-    #else
-        localtime_r(&now_c, &tm_buf);
-    #endif
-        std::ostringstream oss;
-        oss << std::put_time(&tm_buf, "%m-%d %H:%M:%S");
-        return oss.str();
-    }
+    // Opens the log file and starts the background writer thread.  Lines logged before this
+    // are kept in the ring and written once the file is open.
+    bool OpenLogFile(const char *path);
+
+    // Fixed size stream buffer a single log line is formatted into, text past the end is dropped
+    class LogLineBuffer : public std::streambuf {
+    public:
+        static constexpr size_t CAPACITY = 2048;
+
+        LogLineBuffer() { reset(); }
+
+        // Leaves room for the trailing newline
+        void reset() { setp(buffer, buffer + CAPACITY - 1); }
+
+        char *data() { return buffer; }
+
+        size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+
+    protected:
+        int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+
+    private:
+        char buffer[CAPACITY];
+    };
+
+    struct LogLineFormatter;
+
+    // One DEBUG_LOG statement.  The line is formatted into a buffer of the calling thread with no
+    // lock held, so a streamed expression can take its time or log itself (its line is written
+    // first).  The destructor only takes the producer lock to copy the finished line into the
+    // lock-free ring, the file write itself happens on the log writer thread.
+    class LogLineScope {
+    public:
+        explicit LogLineScope(bool withTimestamp);
+        ~LogLineScope();
+
+        LogLineScope(const LogLineScope &) = delete;
+        LogLineScope &operator=(const LogLineScope &) = delete;
+
+        std::ostream &stream();
+
+    private:
+        LogLineFormatter *formatter;
+    };
 
 #ifndef DEBUG_LOG_H
 #define DEBUG_LOG_H
 
-#define DEBUG_LOG(msg) debugLogFile << perf_monitor::GetHumanTimestamp() << ": " << msg << std::endl
-#define NEWLINE_LOG() debugLogFile << std::endl
+#define DEBUG_LOG(msg) do { perf_monitor::LogLineScope logLine_(true); logLine_.stream() << msg; } while (0)
+#define NEWLINE_LOG() do { perf_monitor::LogLineScope logLine_(false); } while (0)
 
 #endif  // DEBUG_LOG_H
-}
\ No newline at end of file
+}
@@ -31,14 +31,26 @@
 #include "offsets.hpp"
 #include "main.hpp"
 #include "stats.hpp"
+#include "timing.hpp"
+#include "addon_names.hpp"
+#include "frame_cache.hpp"
+#include "frame_timeline.hpp"
+#include "hitch_capture.hpp"
+#include "trace_export.hpp"
+#include "config.hpp"
+#include "metric_sampler.hpp"
+#include "hook_tiers.hpp"
+#include "monitor_overhead.hpp"
+#include "thread_shards.hpp"
+#include "stat_records.hpp"
 #include "events.hpp"
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <atomic>
-#include <map>
-#include <set>
 #include <string>
+#include <cstring>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
@@ -57,38 +69,25 @@ namespace perf_monitor {
     // Keep SpellVisualsInitDetour as it's used specifically in DllMain
     std::unique_ptr<hadesmem::PatchDetour<SpellVisualsInitializeT >> gSpellVisualsInitDetour;
 
-    // Track 5 slowest events for each addon
-    std::map<std::string, std::vector<EventStats>> gAddonEventStats;
-
-    // Track addon OnUpdate performance
-    std::map<std::string, FunctionStats> gAddonOnUpdateStats;
-
-
-    // Track spell visual performance by spell ID
-    std::map<uint32_t, FunctionStats> gSpellVisualStatsById;
-
-    // Track addon memory usage for OnEvent and OnUpdate
-    std::map<std::string, MemoryStats> gAddonOnEventMemoryStats;
-    std::map<std::string, MemoryStats> gAddonOnUpdateMemoryStats;
-
     // Early alphabetical Ace addons that are likely to get associated with other addons events
-    std::set<std::string> gAceAddonBlacklist = {
+    const char *const gAceAddonBlacklist[] = {
             "pfUI",
             "AI_VoiceOver",
             "AtlasLoot",
             "BigWigs"
     };
+    AddonId gAceAddonBlacklistIds[sizeof(gAceAddonBlacklist) / sizeof(gAceAddonBlacklist[0])];
 
-    // Total events stats
-    FunctionStats gTotalEventsStats("All Events");
+    // Frame/script pointers already resolved to an addon
+    FrameAddonCache gFrameAddonCache;
 
     // Track event counts
-    std::map<EVENT_ID, size_t> gEventCounts;
+    size_t gEventCounts[EVENTIDS] = {};
     uint64_t gLastEventStatsTime = 0;
-    std::chrono::high_resolution_clock::time_point gCWorldSceneRenderEndTime;
+    uint64_t gCWorldSceneRenderEndTime = 0; // timer ticks
 
-    // Track when we're drawing the world scene
-    bool gIsDrawingWorldScene = false;
+    // Track when we're drawing the world scene, per thread like the scene draw it brackets
+    thread_local bool gIsDrawingWorldScene = false;
 
     // Scene draw loop timing variables
     std::chrono::high_resolution_clock::time_point gSceneDrawLoopStartTime;
@@ -115,94 +114,111 @@ namespace perf_monitor {
 
         uintptr_t *luaState = GetLuaStatePtr();
         if (luaState != nullptr) {
-            return lua_getgccount(luaState);
+            // Counted as monitor overhead, it only runs to measure addon memory
+            auto start = ReadTicks();
+            int memoryKB = lua_getgccount(luaState);
+            ActiveStats().overhead.luaMemoryTicks += ReadTicks() - start;
+            return memoryKB;
         }
         return 0;
     }
 
 
-    // Helper function to track slowest events for an addon
-    std::string getAddonOrFrameName(uintptr_t *framescriptObj, uintptr_t *addonNamePtr) {
-        std::string addonName;
-        std::string frameNameStr;
+    static bool StartsWith(const char *str, size_t length, const char *prefix, size_t prefixLength) {
+        return length >= prefixLength && std::memcmp(str, prefix, prefixLength) == 0;
+    }
+
+    static bool EndsWith(const char *str, size_t length, const char *suffix, size_t suffixLength) {
+        return length >= suffixLength && std::memcmp(str + length - suffixLength, suffix, suffixLength) == 0;
+    }
+
+    // Normalizes a frame name into buffer (grouping known frame families and stripping digits),
+    // returns the normalized length or 0 if the frame should be ignored
+    static size_t NormalizeFrameName(const char *frameName, char *buffer, size_t bufferSize) {
+        size_t length = strnlen(frameName, bufferSize);
+
+        const char *group = nullptr;
+        // Ignore frame names ending with .dll
+        if (EndsWith(frameName, length, ".dll", 4)) {
+            return 0;
+        // comment if you want to see individual pfui frame performance
+//        } else if (StartsWith(frameName, length, "pf", 2)) {
+//            // Special handling for pfUI
+//            group = "pfUI";
+        } else if (StartsWith(frameName, length, "Cursive", 7)) {
+            group = "Cursive";
+        } else if (StartsWith(frameName, length, "BigWigs", 7)) {
+            group = "BigWigs";
+        } else if (StartsWith(frameName, length, "MSBT", 4) || StartsWith(frameName, length, "MCEH", 4)) {
+            group = "MSBT";
+        } else if (length >= 13 && StartsWith(frameName, length, "Character", 9) &&
+                   EndsWith(frameName, length, "Slot", 4)) {
+            group = "CharacterSlot";
+        } else if (length >= 11 && StartsWith(frameName, length, "Inspect", 7) &&
+                   EndsWith(frameName, length, "Slot", 4)) {
+            group = "InspectSlot";
+        } else if (StartsWith(frameName, length, "RABFrame", 8)) {
+            group = "Rabuffs";
+        }
 
-        // Try to get addon name
+        if (group != nullptr) {
+            size_t groupLength = std::strlen(group);
+            std::memcpy(buffer, group, groupLength);
+            return groupLength;
+        }
+
+        // Strip numbers from frame name
+        size_t normalizedLength = 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (!isdigit(static_cast<unsigned char>(frameName[i]))) {
+                buffer[normalizedLength++] = frameName[i];
+            }
+        }
+        return normalizedLength;
+    }
+
+    static bool IsBlacklistedAddon(AddonId id) {
+        return std::find(std::begin(gAceAddonBlacklistIds), std::end(gAceAddonBlacklistIds), id) !=
+               std::end(gAceAddonBlacklistIds);
+    }
+
+    // Resolves the addon (or failing that the normalized frame name) a script belongs to
+    AddonId getAddonOrFrameId(uintptr_t *framescriptObj, uintptr_t *addonNamePtr) {
+        // Prioritize addon name if it exists and is not blacklisted
         if (addonNamePtr != nullptr && addonNamePtr[1] != 0) {
             const char *namePtr = reinterpret_cast<const char *>(addonNamePtr[1]);
             if (namePtr != nullptr && IsBadReadPtr(namePtr, 1) == 0) {
-                addonName = std::string(namePtr);
+                AddonId addonId = InternAddonName(namePtr, std::strlen(namePtr));
+                if (addonId != ADDON_NONE && !IsBlacklistedAddon(addonId)) {
+                    return addonId;
+                }
             }
         }
 
-        // Try to get frame name
+        // Fall back to frame name if addon name is not available
         if (framescriptObj != nullptr && IsBadReadPtr(framescriptObj, sizeof(uintptr_t) * 39) == 0 &&
             framescriptObj[38] != 0) {
             auto frameName = reinterpret_cast<char *>(framescriptObj[38]);
             if (frameName != nullptr && IsValidAsciiString(frameName)) {
-                frameNameStr = std::string(frameName);
-
-                // comment if you want to see individual pfui frame performance
-//                if (frameNameStr.length() >= 2 && frameNameStr.substr(0, 2) == "pf") {
-//                    // Special handling for pfUI
-//                    frameNameStr = "pfUI";
-//                }
-
-                // Ignore frame names ending with .dll
-                if (frameNameStr.length() >= 4 && frameNameStr.substr(frameNameStr.length() - 4) == ".dll") {
-                    frameNameStr = "";
-                } else if (frameNameStr.length() >= 7 && frameNameStr.substr(0, 7) == "Cursive") {
-                    frameNameStr = "Cursive";
-                } else if (frameNameStr.length() >= 7 && frameNameStr.substr(0, 7) == "BigWigs") {
-                    frameNameStr = "BigWigs";
-                } else if ((frameNameStr.length() >= 4 && frameNameStr.substr(0, 4) == "MSBT") ||
-                           (frameNameStr.length() >= 4 && frameNameStr.substr(0, 4) == "MCEH")) {
-                    frameNameStr = "MSBT";
-                } else if (frameNameStr.length() >= 13 && frameNameStr.substr(0, 9) == "Character" &&
-                           frameNameStr.substr(frameNameStr.length() - 4) == "Slot") {
-                    frameNameStr = "CharacterSlot";
-                } else if (frameNameStr.length() >= 11 && frameNameStr.substr(0, 7) == "Inspect" &&
-                           frameNameStr.substr(frameNameStr.length() - 4) == "Slot") {
-                    frameNameStr = "InspectSlot";
-                } else if (frameNameStr.length() >= 8 && frameNameStr.substr(0, 8) == "RABFrame") {
-                    frameNameStr = "Rabuffs";
-                } else {
-                    // Strip numbers from frame name
-                    frameNameStr.erase(std::remove_if(frameNameStr.begin(), frameNameStr.end(), ::isdigit),
-                                       frameNameStr.end());
-                }
+                char normalized[256];
+                size_t length = NormalizeFrameName(frameName, normalized, sizeof(normalized));
+                return InternAddonName(normalized, length);
             }
         }
 
-        // Prioritize addon name if it exists and is not blacklisted
-        if (!addonName.empty() && gAceAddonBlacklist.find(addonName) == gAceAddonBlacklist.end()) {
-            return addonName;
-        }
-
-        // Fall back to frame name if addon name is not available
-        if (!frameNameStr.empty()) {
-            return frameNameStr;
-        }
-
-        return "";
+        return ADDON_NONE;
     }
 
-    void TrackEvent(const std::string &addonName, int eventCode, double duration) {
-        auto &eventStats = gAddonEventStats[addonName];
-
-        // Find existing event with same code
-        auto it = std::find_if(eventStats.begin(), eventStats.end(),
-                               [eventCode](const EventStats &event) {
-                                   return event.eventCode == eventCode;
-                               });
-
-        if (it != eventStats.end()) {
-            // Combine durations and increment count for existing event
-            it->duration += duration;
-            it->count++;
-        } else {
-            // Add new event code
-            eventStats.emplace_back(eventCode, duration);
+    // Cached getAddonOrFrameId, the steady state is a single hash probe
+    AddonId resolveAddonId(uintptr_t *framescriptObj, uintptr_t *addonNamePtr) {
+        AddonId addonId;
+        if (!gFrameAddonCache.lookup(framescriptObj, addonNamePtr, addonId)) {
+            auto start = ReadTicks();
+            addonId = getAddonOrFrameId(framescriptObj, addonNamePtr);
+            gFrameAddonCache.insert(framescriptObj, addonNamePtr, addonId);
+            ActiveStats().overhead.nameResolutionTicks += ReadTicks() - start;
         }
+        return addonId;
     }
 
     // IEvtQueueDispatch hook to track events
@@ -221,18 +237,21 @@ namespace perf_monitor {
         gEventCounts[eventId]++;
 
         // Time the event dispatch
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_TOTAL_EVENTS);
+        auto start = ReadTicks();
 
         // Call original function
         IEvtQueueDispatch(eventContext, eventId, unk);
 
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        uint64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(end.time_since_epoch()).count();
+        auto end = ReadTicks();
+        auto duration = end - start;
+        uint64_t nowMs = static_cast<uint64_t>(TicksToMs(end));
 
         // Update event stats
-        gEventStats[eventId].update(duration);
-        gTotalEventsStats.update(duration);
+        RecordStat(STAT_RECORD_EVENT, static_cast<uint16_t>(eventId), 0, duration);
+        RecordMetric(METRIC_TOTAL_EVENTS, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_TOTAL_EVENTS, start, duration);
 
         // Check if it's time to output event stats (every minute)
         if (gLastEventStatsTime == 0 || nowMs - gLastEventStatsTime >= STATS_OUTPUT_INTERVAL_MS) {
@@ -243,146 +262,208 @@ namespace perf_monitor {
     // RenderWorld hook - this is the main hook that will output stats
     void RenderWorldHook(hadesmem::PatchDetourBase *detour, uintptr_t *worldFrame) {
         auto const RenderWorld = detour->GetTrampolineT<FastcallFrameT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_RENDER_WORLD);
+        auto start = ReadTicks();
         RenderWorld(worldFrame);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        uint64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(end.time_since_epoch()).count();
+        auto duration = end - start;
+        uint64_t nowMs = static_cast<uint64_t>(TicksToMs(end));
 
         // Update frame stats
-        gRenderWorldStats.update(duration);
-
-        // Only output stats in the RenderWorldHook (once per minute)
-        if (gRenderWorldStats.checkAndOutputStats(nowMs)) {
-            uint64_t previousPeriodStart = gRenderWorldStats.periodStartTime;
-            uint64_t previousPeriodEnd = nowMs;
-            OutputStats(previousPeriodStart, previousPeriodEnd);
-            gRenderWorldStats.periodStartTime = nowMs;
+        RecordMetric(METRIC_RENDER_WORLD, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_RENDER_WORLD, start, duration);
+
+        // Only close windows in the RenderWorldHook, the report itself is written by the stats worker
+        if (ShouldOutputStats(nowMs) && RetireStatsWindow(nowMs)) {
+            // Re-resolve frame owners once per window in case a frame was reused
+            gFrameAddonCache.invalidateAll();
+            // Tier and sampling changes take effect here so a window is measured with one set of hooks
+            if (ReloadConfigFileIfChanged("perf_monitor.cfg")) {
+                ApplyHookTiers();
+            }
         }
     }
 
     void OnWorldRenderHook(hadesmem::PatchDetourBase *detour, uintptr_t *worldFrame) {
         auto const OnWorldRender = detour->GetTrampolineT<FastcallFrameT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_ON_WORLD_RENDER);
+        auto start = ReadTicks();
         OnWorldRender(worldFrame);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update frame stats
-        gOnWorldRenderStats.update(duration);
+        RecordMetric(METRIC_ON_WORLD_RENDER, duration);
+        AddFrameSplit(FRAME_SPLIT_WORLD_RENDER, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_ON_WORLD_RENDER, start, duration);
     }
 
     void OnWorldUpdateHook(hadesmem::PatchDetourBase *detour, uintptr_t *worldFrame) {
         auto const OnWorldUpdate = detour->GetTrampolineT<FastcallFrameT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_ON_WORLD_UPDATE);
+        auto start = ReadTicks();
         OnWorldUpdate(worldFrame);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update frame stats
-        gOnWorldUpdateStats.update(duration);
+        RecordMetric(METRIC_ON_WORLD_UPDATE, duration);
+        AddFrameSplit(FRAME_SPLIT_WORLD_UPDATE, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_ON_WORLD_UPDATE, start, duration);
     }
 
     // CWorldRender hook
     void CWorldRenderHook(hadesmem::PatchDetourBase *detour) {
         auto const CWorldRender = detour->GetTrampolineT<StdcallT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            CWorldRender();
+            return;
+        }
+        CallTreeEnter(METRIC_CWORLD_RENDER);
+        auto start = ReadTicks();
 
-        if (gCWorldSceneRenderEndTime.time_since_epoch().count() != 0) {
-            auto timeBetween = std::chrono::duration_cast<std::chrono::microseconds>(
-                    start - gCWorldSceneRenderEndTime).count();
-            gTimeBetweenRenderStats.update(timeBetween);
+        if (gCWorldSceneRenderEndTime != 0) {
+            auto timeBetween = start - gCWorldSceneRenderEndTime;
+            RecordMetric(METRIC_TIME_BETWEEN_RENDER, timeBetween);
         }
 
         CWorldRender();
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gCWorldRenderStats.update(duration);
+        RecordMetric(METRIC_CWORLD_RENDER, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_CWORLD_RENDER, start, duration);
     }
 
     void CWorldSceneRenderHook(hadesmem::PatchDetourBase *detour) {
         auto const CWorldSceneRender = detour->GetTrampolineT<StdcallT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            CWorldSceneRender();
+            gCWorldSceneRenderEndTime = 0; // don't measure time between renders across a disabled stretch
+            return;
+        }
+        CallTreeEnter(METRIC_CWORLD_SCENE_RENDER);
+        auto start = ReadTicks();
         CWorldSceneRender();
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
         gCWorldSceneRenderEndTime = end;
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gCWorldSceneRenderStats.update(duration);
+        RecordMetric(METRIC_CWORLD_SCENE_RENDER, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_CWORLD_SCENE_RENDER, start, duration);
     }
 
     // CWorldUnknownRender hook
     void CWorldUnknownRenderHook(hadesmem::PatchDetourBase *detour) {
         auto const CWorldUnknownRender = detour->GetTrampolineT<StdcallT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            CWorldUnknownRender();
+            return;
+        }
+        CallTreeEnter(METRIC_CWORLD_UNKNOWN_RENDER);
+        auto start = ReadTicks();
         CWorldUnknownRender();
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gCWorldUnknownRenderStats.update(duration);
+        RecordMetric(METRIC_CWORLD_UNKNOWN_RENDER, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_CWORLD_UNKNOWN_RENDER, start, duration);
     }
 
     // CWorldUpdate hook
     void CWorldUpdateHook(hadesmem::PatchDetourBase *detour, float *param_1, float *param_2, float *param_3) {
         auto const CWorldUpdate = detour->GetTrampolineT<WorldUpdateT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            CWorldUpdate(param_1, param_2, param_3);
+            return;
+        }
+        CallTreeEnter(METRIC_CWORLD_UPDATE);
+        auto start = ReadTicks();
         CWorldUpdate(param_1, param_2, param_3);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gCWorldUpdateStats.update(duration);
+        RecordMetric(METRIC_CWORLD_UPDATE, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_CWORLD_UPDATE, start, duration);
     }
 
     // SpellVisualsRender hook
     void SpellVisualsRenderHook(hadesmem::PatchDetourBase *detour) {
         auto const SpellVisualsRender = detour->GetTrampolineT<StdcallT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            SpellVisualsRender();
+            return;
+        }
+        CallTreeEnter(METRIC_SPELL_VISUALS_RENDER);
+        auto start = ReadTicks();
         SpellVisualsRender();
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gSpellVisualsRenderStats.update(duration);
+        RecordMetric(METRIC_SPELL_VISUALS_RENDER, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_SPELL_VISUALS_RENDER, start, duration);
     }
 
     // SpellVisualsTick hook
     void SpellVisualsTickHook(hadesmem::PatchDetourBase *detour) {
         auto const SpellVisualsTick = detour->GetTrampolineT<StdcallT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            SpellVisualsTick();
+            return;
+        }
+        CallTreeEnter(METRIC_SPELL_VISUALS_TICK);
+        auto start = ReadTicks();
         SpellVisualsTick();
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gSpellVisualsTickStats.update(duration);
+        RecordMetric(METRIC_SPELL_VISUALS_TICK, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_SPELL_VISUALS_TICK, start, duration);
     }
 
     // UnitUpdate hook
     void UnitUpdateHook(hadesmem::PatchDetourBase *detour, uintptr_t *worldFrame) {
         auto const UnitUpdate = detour->GetTrampolineT<FastcallFrameT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            UnitUpdate(worldFrame);
+            return;
+        }
+        CallTreeEnter(METRIC_UNIT_UPDATE);
+        auto start = ReadTicks();
         UnitUpdate(worldFrame);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gUnitUpdateStats.update(duration);
+        RecordMetric(METRIC_UNIT_UPDATE, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_UNIT_UPDATE, start, duration);
     }
 
     typedef enum OBJECT_TYPE_ID {
@@ -403,14 +484,17 @@ namespace perf_monitor {
     // ObjectUpdateHandler hook
     int ObjectUpdateHandlerHook(hadesmem::PatchDetourBase *detour, uintptr_t *param_1, CDataStore *dataStore) {
         auto const ObjectUpdateHandler = detour->GetTrampolineT<PacketHandlerT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_OBJECT_UPDATE_HANDLER);
+        auto start = ReadTicks();
         auto result = ObjectUpdateHandler(param_1, dataStore);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gObjectUpdateHandlerStats.update(duration);
+        RecordMetric(METRIC_OBJECT_UPDATE_HANDLER, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_OBJECT_UPDATE_HANDLER, start, duration);
 
         return result;
     }
@@ -419,65 +503,85 @@ namespace perf_monitor {
     void PlaySpellVisualHook(hadesmem::PatchDetourBase *detour, uintptr_t *unit, uintptr_t *unk, uintptr_t *spellRec,
                              uintptr_t *visualKit, void *param_3, void *param_4) {
         auto const PlaySpellVisual = detour->GetTrampolineT<PlaySpellVisualT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_PLAY_SPELL_VISUAL);
+        auto start = ReadTicks();
 
         auto spellId = spellRec ? spellRec[0] : 0;
 
         PlaySpellVisual(unit, unk, spellRec, visualKit, param_3, param_4);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update overall stats
-        gPlaySpellVisualStats.update(duration);
+        RecordMetric(METRIC_PLAY_SPELL_VISUAL, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_PLAY_SPELL_VISUAL, start, duration);
 
         // Update spell-specific stats
         if (spellId != 0) {
-            if (gSpellVisualStatsById.find(spellId) == gSpellVisualStatsById.end()) {
-                std::string spellName = "Spell ID " + std::to_string(spellId);
-                gSpellVisualStatsById[spellId] = FunctionStats(spellName);
-            }
-            gSpellVisualStatsById[spellId].update(duration);
+            RecordStat(STAT_RECORD_SPELL_VISUAL, 0, static_cast<uint32_t>(spellId), duration);
         }
     }
 
     // UnknownOnRender1 hook
     void UnknownOnRender1Hook(hadesmem::PatchDetourBase *detour) {
         auto const UnknownOnRender1 = detour->GetTrampolineT<UnknownOnRender1T>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            UnknownOnRender1();
+            return;
+        }
+        CallTreeEnter(METRIC_UNKNOWN_ON_RENDER1);
+        auto start = ReadTicks();
         UnknownOnRender1();
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gUnknownOnRender1Stats.update(duration);
+        RecordMetric(METRIC_UNKNOWN_ON_RENDER1, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_UNKNOWN_ON_RENDER1, start, duration);
     }
 
     // UnknownOnRender2 hook
     void UnknownOnRender2Hook(hadesmem::PatchDetourBase *detour) {
         auto const UnknownOnRender2 = detour->GetTrampolineT<UnknownOnRender2T>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            UnknownOnRender2();
+            return;
+        }
+        CallTreeEnter(METRIC_UNKNOWN_ON_RENDER2);
+        auto start = ReadTicks();
         UnknownOnRender2();
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gUnknownOnRender2Stats.update(duration);
+        RecordMetric(METRIC_UNKNOWN_ON_RENDER2, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_UNKNOWN_ON_RENDER2, start, duration);
     }
 
     // UnknownOnRender3 hook
     void UnknownOnRender3Hook(hadesmem::PatchDetourBase *detour) {
         auto const UnknownOnRender3 = detour->GetTrampolineT<UnknownOnRender3T>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            UnknownOnRender3();
+            return;
+        }
+        CallTreeEnter(METRIC_UNKNOWN_ON_RENDER3);
+        auto start = ReadTicks();
         UnknownOnRender3();
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gUnknownOnRender3Stats.update(duration);
+        RecordMetric(METRIC_UNKNOWN_ON_RENDER3, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_UNKNOWN_ON_RENDER3, start, duration);
     }
 
     // CM2Scene::AdvanceTime hook - only track performance if this pointer equals Offsets::ActiveWorldScene
@@ -488,15 +592,18 @@ namespace perf_monitor {
         auto worldScenePtr = *reinterpret_cast<uintptr_t **>(0x00c7b298);
 
         // Check if this pointer matches the specific address
-        if (this_ptr == worldScenePtr) {
-            auto start = std::chrono::high_resolution_clock::now();
+        if (HookTierEnabled(HOOK_TIER_RENDER_DETAIL) && this_ptr == worldScenePtr) {
+            CallTreeEnter(METRIC_CM2_SCENE_ADVANCE_TIME);
+            auto start = ReadTicks();
             CM2SceneAdvanceTime(this_ptr, dummy_edx, param_1);
-            auto end = std::chrono::high_resolution_clock::now();
+            auto end = ReadTicks();
 
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            auto duration = end - start;
 
             // Update stats without outputting
-            gCM2SceneAdvanceTimeStats.update(duration);
+            RecordMetric(METRIC_CM2_SCENE_ADVANCE_TIME, duration);
+            CallTreeLeave(duration);
+            RecordHookSpan(METRIC_CM2_SCENE_ADVANCE_TIME, start, duration);
         } else {
             // Call original function without timing
             CM2SceneAdvanceTime(this_ptr, dummy_edx, param_1);
@@ -510,15 +617,18 @@ namespace perf_monitor {
         auto worldScenePtr = *reinterpret_cast<uintptr_t **>(0x00c7b298);
 
         // Check if this pointer matches the specific address
-        if (this_ptr == worldScenePtr) {
-            auto start = std::chrono::high_resolution_clock::now();
+        if (HookTierEnabled(HOOK_TIER_RENDER_DETAIL) && this_ptr == worldScenePtr) {
+            CallTreeEnter(METRIC_CM2_SCENE_ANIMATE);
+            auto start = ReadTicks();
             CM2SceneAnimate(this_ptr, dummy_edx, param_1);
-            auto end = std::chrono::high_resolution_clock::now();
+            auto end = ReadTicks();
 
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            auto duration = end - start;
 
             // Update stats without outputting
-            gCM2SceneAnimateStats.update(duration);
+            RecordMetric(METRIC_CM2_SCENE_ANIMATE, duration);
+            CallTreeLeave(duration);
+            RecordHookSpan(METRIC_CM2_SCENE_ANIMATE, start, duration);
         } else {
             // Call original function without timing
             CM2SceneAnimate(this_ptr, dummy_edx, param_1);
@@ -532,17 +642,20 @@ namespace perf_monitor {
         auto worldScenePtr = *reinterpret_cast<uintptr_t **>(0x00c7b298);
 
         // Check if this pointer matches the specific address
-        if (this_ptr == worldScenePtr) {
+        if (HookTierEnabled(HOOK_TIER_RENDER_DETAIL) && this_ptr == worldScenePtr) {
             gIsDrawingWorldScene = true;
-            auto start = std::chrono::high_resolution_clock::now();
+            CallTreeEnter(METRIC_CM2_SCENE_DRAW);
+            auto start = ReadTicks();
             CM2SceneDraw(this_ptr, dummy_edx, param_1);
-            auto end = std::chrono::high_resolution_clock::now();
+            auto end = ReadTicks();
             gIsDrawingWorldScene = false;
 
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            auto duration = end - start;
 
             // Update stats without outputting
-            gCM2SceneDrawStats.update(duration);
+            RecordMetric(METRIC_CM2_SCENE_DRAW, duration);
+            CallTreeLeave(duration);
+            RecordHookSpan(METRIC_CM2_SCENE_DRAW, start, duration);
         } else {
             // Call original function without timing
             CM2SceneDraw(this_ptr, dummy_edx, param_1);
@@ -552,68 +665,110 @@ namespace perf_monitor {
     // DrawBatchProj hook
     void DrawBatchProjHook(hadesmem::PatchDetourBase *detour, uintptr_t *this_ptr, void *dummy_edx) {
         auto const DrawBatchProj = detour->GetTrampolineT<DrawBatchProjT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL) || !SampleMetricCall(METRIC_DRAW_BATCH_PROJ)) {
+            DrawBatchProj(this_ptr, dummy_edx);
+            return;
+        }
+        CallTreeEnter(METRIC_DRAW_BATCH_PROJ);
+        auto start = ReadTicks();
         DrawBatchProj(this_ptr, dummy_edx);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gDrawBatchProjStats.update(duration);
+        auto duration = end - start;
+        RecordSampledMetric(METRIC_DRAW_BATCH_PROJ, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_DRAW_BATCH_PROJ, start, duration);
     }
 
     // DrawBatch hook
     void DrawBatchHook(hadesmem::PatchDetourBase *detour, uintptr_t *this_ptr, void *dummy_edx) {
         auto const DrawBatch = detour->GetTrampolineT<DrawBatchT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL) || !SampleMetricCall(METRIC_DRAW_BATCH)) {
+            DrawBatch(this_ptr, dummy_edx);
+            return;
+        }
+        CallTreeEnter(METRIC_DRAW_BATCH);
+        auto start = ReadTicks();
         DrawBatch(this_ptr, dummy_edx);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gDrawBatchStats.update(duration);
+        auto duration = end - start;
+        RecordSampledMetric(METRIC_DRAW_BATCH, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_DRAW_BATCH, start, duration);
     }
 
     // DrawBatchDoodad hook
     void DrawBatchDoodadHook(hadesmem::PatchDetourBase *detour, uintptr_t *this_ptr, void *dummy_edx, int param_1,
                              int param_2) {
         auto const DrawBatchDoodad = detour->GetTrampolineT<DrawBatchDoodadT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL) || !SampleMetricCall(METRIC_DRAW_BATCH_DOODAD)) {
+            DrawBatchDoodad(this_ptr, dummy_edx, param_1, param_2);
+            return;
+        }
+        CallTreeEnter(METRIC_DRAW_BATCH_DOODAD);
+        auto start = ReadTicks();
         DrawBatchDoodad(this_ptr, dummy_edx, param_1, param_2);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gDrawBatchDoodadStats.update(duration);
+        auto duration = end - start;
+        RecordSampledMetric(METRIC_DRAW_BATCH_DOODAD, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_DRAW_BATCH_DOODAD, start, duration);
     }
 
     // DrawRibbon hook
     void DrawRibbonHook(hadesmem::PatchDetourBase *detour, uintptr_t *this_ptr, void *dummy_edx) {
         auto const DrawRibbon = detour->GetTrampolineT<DrawRibbonT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL) || !SampleMetricCall(METRIC_DRAW_RIBBON)) {
+            DrawRibbon(this_ptr, dummy_edx);
+            return;
+        }
+        CallTreeEnter(METRIC_DRAW_RIBBON);
+        auto start = ReadTicks();
         DrawRibbon(this_ptr, dummy_edx);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gDrawRibbonStats.update(duration);
+        auto duration = end - start;
+        RecordSampledMetric(METRIC_DRAW_RIBBON, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_DRAW_RIBBON, start, duration);
     }
 
     // DrawParticle hook
     void DrawParticleHook(hadesmem::PatchDetourBase *detour, uintptr_t *this_ptr, void *dummy_edx) {
         auto const DrawParticle = detour->GetTrampolineT<DrawParticleT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL) || !SampleMetricCall(METRIC_DRAW_PARTICLE)) {
+            DrawParticle(this_ptr, dummy_edx);
+            return;
+        }
+        CallTreeEnter(METRIC_DRAW_PARTICLE);
+        auto start = ReadTicks();
         DrawParticle(this_ptr, dummy_edx);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gDrawParticleStats.update(duration);
+        auto duration = end - start;
+        RecordSampledMetric(METRIC_DRAW_PARTICLE, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_DRAW_PARTICLE, start, duration);
     }
 
     // DrawCallback hook
     void DrawCallbackHook(hadesmem::PatchDetourBase *detour, uintptr_t *this_ptr, void *dummy_edx) {
         auto const DrawCallback = detour->GetTrampolineT<DrawCallbackT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL) || !SampleMetricCall(METRIC_DRAW_CALLBACK)) {
+            DrawCallback(this_ptr, dummy_edx);
+            return;
+        }
+        CallTreeEnter(METRIC_DRAW_CALLBACK);
+        auto start = ReadTicks();
         DrawCallback(this_ptr, dummy_edx);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gDrawCallbackStats.update(duration);
+        auto duration = end - start;
+        RecordSampledMetric(METRIC_DRAW_CALLBACK, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_DRAW_CALLBACK, start, duration);
     }
 
     // CM2SceneRender::Draw hook - only track stats when drawing world scene
@@ -622,14 +777,18 @@ namespace perf_monitor {
                            int param_2, int param_3, uint32_t param_4) {
         auto const CM2SceneRenderDraw = detour->GetTrampolineT<CM2SceneRenderDrawT>();
 
-        // Only track performance when drawing world scene
+        // Only track performance when drawing world scene, which is only flagged by a timed
+        // CM2Scene::Draw so this follows the render detail tier too
         if (gIsDrawingWorldScene) {
-            auto start = std::chrono::high_resolution_clock::now();
+            CallTreeEnter(METRIC_CM2_SCENE_RENDER_DRAW);
+            auto start = ReadTicks();
             CM2SceneRenderDraw(this_ptr, dummy_edx, param_1, param_2, param_3, param_4);
-            auto end = std::chrono::high_resolution_clock::now();
+            auto end = ReadTicks();
 
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-            gCM2SceneRenderDrawStats.update(duration);
+            auto duration = end - start;
+            RecordMetric(METRIC_CM2_SCENE_RENDER_DRAW, duration);
+            CallTreeLeave(duration);
+            RecordHookSpan(METRIC_CM2_SCENE_RENDER_DRAW, start, duration);
         } else {
             // Call original function without timing when not drawing world scene
             CM2SceneRenderDraw(this_ptr, dummy_edx, param_1, param_2, param_3, param_4);
@@ -639,12 +798,16 @@ namespace perf_monitor {
     // luaC_collectgarbage hook
     void luaC_collectgarbageHook(hadesmem::PatchDetourBase *detour, int param_1) {
         auto const luaC_collectgarbage = detour->GetTrampolineT<luaC_collectgarbageT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_LUA_COLLECT_GARBAGE);
+        auto start = ReadTicks();
         luaC_collectgarbage(param_1);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gLuaCCollectgarbageStats.update(duration);
+        auto duration = end - start;
+        RecordMetric(METRIC_LUA_COLLECT_GARBAGE, duration);
+        AddFrameSplit(FRAME_SPLIT_GARBAGE_COLLECTION, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_LUA_COLLECT_GARBAGE, start, duration);
     }
 
 
@@ -652,35 +815,53 @@ namespace perf_monitor {
                                float *param_2, float *param_3, float *param_4) {
 
         auto const CM2ModelAnimateMT = detour->GetTrampolineT<CM2ModelAnimateMTT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL) || !SampleMetricCall(METRIC_CM2_MODEL_ANIMATE_MT)) {
+            CM2ModelAnimateMT(this_ptr, dummy_edx, param_1, param_2, param_3, param_4);
+            return;
+        }
+        CallTreeEnter(METRIC_CM2_MODEL_ANIMATE_MT);
+        auto start = ReadTicks();
         CM2ModelAnimateMT(this_ptr, dummy_edx, param_1, param_2, param_3, param_4);
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gCM2ModelAnimateMTStats.update(duration);
+        auto end = ReadTicks();
+        auto duration = end - start;
+        RecordSampledMetric(METRIC_CM2_MODEL_ANIMATE_MT, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_CM2_MODEL_ANIMATE_MT, start, duration);
     }
 
     void ObjectFreeHook(hadesmem::PatchDetourBase *detour, int param_1, uint32_t param_2) {
         auto const ObjectFree = detour->GetTrampolineT<ObjectFreeT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_OBJECT_FREE);
+        auto start = ReadTicks();
         ObjectFree(param_1, param_2);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
+
+        // The freed object may have been a cached frame
+        gFrameAddonCache.erase(reinterpret_cast<const uintptr_t *>(param_1));
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gObjectFreeStats.update(duration);
+        auto duration = end - start;
+        RecordMetric(METRIC_OBJECT_FREE, duration);
+        AddFrameSplit(FRAME_SPLIT_GARBAGE_COLLECTION, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_OBJECT_FREE, start, duration);
     }
 
 
     // PaintScreen hook
     void PaintScreenHook(hadesmem::PatchDetourBase *detour, uint32_t param_1, uint32_t param_2) {
         auto const PaintScreen = detour->GetTrampolineT<PaintScreenT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_PAINT_SCREEN);
+        auto start = ReadTicks();
         PaintScreen(param_1, param_2);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gPaintScreenStats.update(duration);
+        RecordMetric(METRIC_PAINT_SCREEN, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_PAINT_SCREEN, start, duration);
+        EndFrameSpans(RecordFrame(start, duration));
     }
 
     // Add these new hook functions
@@ -688,64 +869,92 @@ namespace perf_monitor {
     CSimpleFrameOnFrameRender1Hook(hadesmem::PatchDetourBase *detour, uintptr_t *frame, void *param_1, uint32_t param_2,
                                    int unk) {
         auto const CSimpleFrameOnFrameRender1 = detour->GetTrampolineT<FrameBatchT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            CSimpleFrameOnFrameRender1(frame, param_1, param_2, unk);
+            return;
+        }
+        CallTreeEnter(METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER1);
+        auto start = ReadTicks();
         CSimpleFrameOnFrameRender1(frame, param_1, param_2, unk);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gCSimpleFrameOnFrameRender1Stats.update(duration);
+        RecordMetric(METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER1, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER1, start, duration);
     }
 
     void
     CSimpleModelOnFrameRenderHook(hadesmem::PatchDetourBase *detour, uintptr_t *frame, void *param_1, uint32_t param_2,
                                   int unk) {
         auto const CSimpleModelOnFrameRender = detour->GetTrampolineT<FrameBatchT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            CSimpleModelOnFrameRender(frame, param_1, param_2, unk);
+            return;
+        }
+        CallTreeEnter(METRIC_CSIMPLE_MODEL_ON_FRAME_RENDER);
+        auto start = ReadTicks();
         CSimpleModelOnFrameRender(frame, param_1, param_2, unk);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gCSimpleModelOnFrameRenderStats.update(duration);
+        RecordMetric(METRIC_CSIMPLE_MODEL_ON_FRAME_RENDER, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_CSIMPLE_MODEL_ON_FRAME_RENDER, start, duration);
     }
 
     void CSimpleFrameOnFrameRender2Hook(hadesmem::PatchDetourBase *detour, uintptr_t *frame) {
         auto const CSimpleFrameOnFrameRender2 = detour->GetTrampolineT<FastcallFrameT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        if (!HookTierEnabled(HOOK_TIER_RENDER_DETAIL)) {
+            CSimpleFrameOnFrameRender2(frame);
+            return;
+        }
+        CallTreeEnter(METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER2);
+        auto start = ReadTicks();
         CSimpleFrameOnFrameRender2(frame);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gCSimpleFrameOnFrameRender2Stats.update(duration);
+        RecordMetric(METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER2, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER2, start, duration);
     }
 
     void CSimpleTopOnLayerUpdateHook(hadesmem::PatchDetourBase *detour, uintptr_t *frame, uint8_t unk, int unk2) {
         auto const CSimpleTopOnLayerUpdate = detour->GetTrampolineT<FrameOnLayerUpdateT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_UIPARENT_ON_UPDATE);
+        auto start = ReadTicks();
         CSimpleTopOnLayerUpdate(frame, unk, unk2);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gCSimpleTopOnLayerUpdateStats.update(duration);
+        RecordMetric(METRIC_UIPARENT_ON_UPDATE, duration);
+        AddFrameSplit(FRAME_SPLIT_UI_UPDATE, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_UIPARENT_ON_UPDATE, start, duration);
     }
 
     void CSimpleTopOnLayerRenderHook(hadesmem::PatchDetourBase *detour, uintptr_t *frame) {
         auto const CSimpleTopOnLayerRender = detour->GetTrampolineT<FastcallFrameT>();
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_UIPARENT_ON_RENDER);
+        auto start = ReadTicks();
         CSimpleTopOnLayerRender(frame);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update stats without outputting
-        gCSimpleTopOnLayerRenderStats.update(duration);
+        RecordMetric(METRIC_UIPARENT_ON_RENDER, duration);
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_UIPARENT_ON_RENDER, start, duration);
     }
 
     // FrameOnLayerUpdate hook
@@ -758,38 +967,42 @@ namespace perf_monitor {
         } else {
             // try to get addon name
             auto const addonNamePtr = reinterpret_cast<uintptr_t *>(frame + 74);
-            auto addonName = getAddonOrFrameName(frame, addonNamePtr);
+            auto addonId = resolveAddonId(frame, addonNamePtr);
 
-            if (addonName.empty()) {
+            if (addonId == ADDON_NONE) {
                 FrameOnLayerUpdate(frame, unk, unk2);
             } else {
                 // Get memory before OnUpdate
-                int memoryBefore = GetLuaMemoryKB();
+                bool trackMemory = HookTierEnabled(HOOK_TIER_MEMORY);
+                int memoryBefore = trackMemory ? GetLuaMemoryKB() : 0;
 
-                auto start = std::chrono::high_resolution_clock::now();
+                CallTreeEnter(METRIC_FRAME_ON_LAYER_UPDATE);
+                CallTreeEnterAddon(CALL_FRAME_ADDON_ON_UPDATE, addonId);
+                auto start = ReadTicks();
                 FrameOnLayerUpdate(frame, unk, unk2);
-                auto end = std::chrono::high_resolution_clock::now();
+                auto end = ReadTicks();
 
                 // Get memory after OnUpdate
-                int memoryAfter = GetLuaMemoryKB();
+                int memoryAfter = trackMemory ? GetLuaMemoryKB() : 0;
                 int memoryDelta = memoryAfter - memoryBefore;
 
-                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+                auto duration = end - start;
 
                 // Update overall stats
-                gFrameOnLayerUpdateStats.update(duration);
+                RecordMetric(METRIC_FRAME_ON_LAYER_UPDATE, duration);
+                CallTreeLeave(duration); // addon handler
+                CallTreeLeave(duration);
+                RecordHookSpan(METRIC_FRAME_ON_LAYER_UPDATE, start, duration);
 
                 // Update addon-specific stats
-                if (gAddonOnUpdateStats.find(addonName) == gAddonOnUpdateStats.end()) {
-                    gAddonOnUpdateStats[addonName] = FunctionStats(addonName + " OnUpdate");
-                }
-                gAddonOnUpdateStats[addonName].update(duration);
+                RecordStat(STAT_RECORD_ADDON_ON_UPDATE, addonId, 0, duration);
 
                 // Update memory stats for OnUpdate
-                if (gAddonOnUpdateMemoryStats.find(addonName) == gAddonOnUpdateMemoryStats.end()) {
-                    gAddonOnUpdateMemoryStats[addonName] = MemoryStats(addonName + " OnUpdate Memory");
+                if (trackMemory) {
+                    RecordStat(STAT_RECORD_ADDON_ON_UPDATE_MEMORY, addonId, 0, static_cast<uint64_t>(memoryDelta));
                 }
-                gAddonOnUpdateMemoryStats[addonName].update(memoryDelta);
+
+                RecordAddonSpan(SPAN_ADDON_ON_UPDATE, addonId, 0, start, duration, memoryDelta);
             }
         }
     }
@@ -799,42 +1012,50 @@ namespace perf_monitor {
         auto const FrameScriptObjectOnScriptEvent = detour->GetTrampolineT<FrameOnScriptEventT>();
         auto lastEventCode = gLastEventCode;
 
+        // Resolved up front so the handler is nested under its addon in the call tree
+        AddonId addonId = ADDON_NONE;
+        if (param_2 != nullptr && param_2[1] != 0) {
+            addonId = resolveAddonId(reinterpret_cast<uintptr_t *>(param_1), reinterpret_cast<uintptr_t *>(param_2));
+        }
+
         // Get memory before event
-        int memoryBefore = GetLuaMemoryKB();
+        bool trackMemory = HookTierEnabled(HOOK_TIER_MEMORY);
+        int memoryBefore = trackMemory ? GetLuaMemoryKB() : 0;
 
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_FRAME_ON_SCRIPT_EVENT);
+        if (addonId != ADDON_NONE) {
+            CallTreeEnterAddon(CALL_FRAME_ADDON_ON_EVENT, addonId);
+        }
+        auto start = ReadTicks();
         FrameScriptObjectOnScriptEvent(param_1, param_2);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
         // Get memory after event
-        int memoryAfter = GetLuaMemoryKB();
+        int memoryAfter = trackMemory ? GetLuaMemoryKB() : 0;
         int memoryDelta = memoryAfter - memoryBefore;
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Update overall stats
-        gFrameOnScriptEventStats.update(duration);
-
-        if (param_2 != nullptr && param_2[1] != 0 && gLastEventCode != 0) {
-            std::string addonName = getAddonOrFrameName(reinterpret_cast<uintptr_t *>(param_1),
-                                                        reinterpret_cast<uintptr_t *>(param_2));
-            if (!addonName.empty()) {
-
-                // Update addon-specific stats
-                if (gAddonScriptEventStats.find(addonName) == gAddonScriptEventStats.end()) {
-                    gAddonScriptEventStats[addonName] = FunctionStats(addonName + " All Events");
-                }
-                gAddonScriptEventStats[addonName].update(duration);
+        RecordMetric(METRIC_FRAME_ON_SCRIPT_EVENT, duration);
+        AddFrameSplit(FRAME_SPLIT_SCRIPT_EVENTS, duration);
+        if (addonId != ADDON_NONE) {
+            CallTreeLeave(duration); // addon handler
+        }
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_FRAME_ON_SCRIPT_EVENT, start, duration);
 
-                TrackEvent(addonName, lastEventCode, static_cast<double>(duration));
+        if (addonId != ADDON_NONE && gLastEventCode != 0) {
+            // Update addon-specific stats
+            RecordStat(STAT_RECORD_ADDON_ON_EVENT, addonId, static_cast<uint32_t>(EventCodeSlot(lastEventCode)),
+                       duration);
 
-                // Update memory stats for OnEvent
-                if (gAddonOnEventMemoryStats.find(addonName) == gAddonOnEventMemoryStats.end()) {
-                    gAddonOnEventMemoryStats[addonName] = MemoryStats(addonName + " OnEvent Memory");
-                }
-
-                gAddonOnEventMemoryStats[addonName].update(memoryDelta);
+            // Update memory stats for OnEvent
+            if (trackMemory) {
+                RecordStat(STAT_RECORD_ADDON_ON_EVENT_MEMORY, addonId, 0, static_cast<uint64_t>(memoryDelta));
             }
+
+            RecordAddonSpan(SPAN_ADDON_EVENT, addonId, lastEventCode, start, duration, memoryDelta);
         }
     }
 
@@ -851,63 +1072,67 @@ namespace perf_monitor {
             return;
         }
 
+        // Resolved up front so the handler is nested under its addon in the call tree
+        AddonId addonId = ADDON_NONE;
+        if (framescriptObj != nullptr && param_2 != nullptr) {
+            addonId = resolveAddonId(reinterpret_cast<uintptr_t *>(framescriptObj),
+                                     reinterpret_cast<uintptr_t *>(param_2));
+        }
+
         // Get memory before event
-        int memoryBefore = GetLuaMemoryKB();
+        bool trackMemory = HookTierEnabled(HOOK_TIER_MEMORY);
+        int memoryBefore = trackMemory ? GetLuaMemoryKB() : 0;
 
-        auto start = std::chrono::high_resolution_clock::now();
+        CallTreeEnter(METRIC_FRAME_ON_SCRIPT_EVENT);
+        if (addonId != ADDON_NONE) {
+            CallTreeEnterAddon(CALL_FRAME_ADDON_ON_EVENT, addonId);
+        }
+        auto start = ReadTicks();
         FrameOnScriptEventParam(framescriptObj, param_2, param_3, args);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = ReadTicks();
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto duration = end - start;
 
         // Get memory after event
-        int memoryAfter = GetLuaMemoryKB();
+        int memoryAfter = trackMemory ? GetLuaMemoryKB() : 0;
         int memoryDelta = memoryAfter - memoryBefore;
 
         // Update overall stats
-        gFrameOnScriptEventStats.update(duration);
-
-        if (framescriptObj != nullptr && param_2 != nullptr && gLastEventCode != 0) {
-            auto addonName = getAddonOrFrameName(reinterpret_cast<uintptr_t *>(framescriptObj),
-                                                 reinterpret_cast<uintptr_t *>(param_2));
-            if (!addonName.empty()) {
-                // Update addon-specific stats
-                if (gAddonScriptEventStats.find(addonName) == gAddonScriptEventStats.end()) {
-                    gAddonScriptEventStats[addonName] = FunctionStats(addonName + " All Events");
-                }
-                gAddonScriptEventStats[addonName].update(duration);
+        RecordMetric(METRIC_FRAME_ON_SCRIPT_EVENT, duration);
+        AddFrameSplit(FRAME_SPLIT_SCRIPT_EVENTS, duration);
+        if (addonId != ADDON_NONE) {
+            CallTreeLeave(duration); // addon handler
+        }
+        CallTreeLeave(duration);
+        RecordHookSpan(METRIC_FRAME_ON_SCRIPT_EVENT, start, duration);
 
-                TrackEvent(addonName, lastEventCode, static_cast<double>(duration));
+        if (addonId != ADDON_NONE && gLastEventCode != 0) {
+            // Update addon-specific stats
+            RecordStat(STAT_RECORD_ADDON_ON_EVENT, addonId, static_cast<uint32_t>(EventCodeSlot(lastEventCode)),
+                       duration);
 
-                // Update memory stats for OnEvent
-                if (gAddonOnEventMemoryStats.find(addonName) == gAddonOnEventMemoryStats.end()) {
-                    gAddonOnEventMemoryStats[addonName] = MemoryStats(addonName + " OnEvent Memory");
-                }
-
-                gAddonOnEventMemoryStats[addonName].update(memoryDelta);
+            // Update memory stats for OnEvent
+            if (trackMemory) {
+                RecordStat(STAT_RECORD_ADDON_ON_EVENT_MEMORY, addonId, 0, static_cast<uint64_t>(memoryDelta));
             }
+
+            RecordAddonSpan(SPAN_ADDON_EVENT, addonId, lastEventCode, start, duration, memoryDelta);
         }
     }
 
     // Helper function to log debug info safely
     void SignalEventEnd(int eventCode) {
-        // Find and remove the start time for this event
-        auto startTimeIt = gEventCodeStartTimes.find(eventCode);
-        if (startTimeIt != gEventCodeStartTimes.end()) {
-            auto endTime = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTimeIt->second);
+        // Find and clear the start time for this event
+        int slot = EventCodeSlot(eventCode);
+        uint64_t startTime = gEventCodeStartTimes[slot];
+        if (startTime != 0) {
+            auto duration = ReadTicks() - startTime;
 
             // Update statistics for this event code
-            auto it = gEventCodeStats.find(eventCode);
-            if (it == gEventCodeStats.end()) {
-                // Create new entry with proper name
-                std::string eventName = GetEventName(eventCode);
-                gEventCodeStats[eventCode] = FunctionStats(eventName);
-            }
-            gEventCodeStats[eventCode].update(duration.count());
+            RecordStat(STAT_RECORD_EVENT_CODE, static_cast<uint16_t>(slot), 0, duration);
+            RecordEventSpan(eventCode, startTime, duration);
 
-            // Remove the start time entry
-            gEventCodeStartTimes.erase(startTimeIt);
+            gEventCodeStartTimes[slot] = 0;
         }
 
         // Reset the global event code after processing
@@ -919,7 +1144,7 @@ namespace perf_monitor {
         auto const SignalEvent = detour->GetTrampolineT<SignalEventT>();
 
         gLastEventCode = eventCode;
-        gEventCodeStartTimes[eventCode] = std::chrono::high_resolution_clock::now();
+        gEventCodeStartTimes[EventCodeSlot(eventCode)] = ReadTicks();
 
         SignalEvent(eventCode);
 
@@ -927,6 +1152,8 @@ namespace perf_monitor {
     }
 
 
+    // The naked hooks below are MSVC x86 inline assembly, the host test build leaves them out
+#if defined(_MSC_VER) && defined(_M_IX86)
     // Original FrameScript_Execute function pointer
     FrameScript_ExecuteT pOriginalFrameScript_Execute = nullptr;
 
@@ -940,6 +1167,7 @@ namespace perf_monitor {
                 jmp pOriginalFrameScript_Execute
         }
     }
+#endif
 
     // Original SignalEventParam function pointer
     SignalEventParamT pOriginalSignalEventParam = nullptr;
@@ -968,9 +1196,10 @@ namespace perf_monitor {
         gLastEventCode = eventCode;
 
         // Record start time for this event code
-        gEventCodeStartTimes[eventCode] = std::chrono::high_resolution_clock::now();
+        gEventCodeStartTimes[EventCodeSlot(eventCode)] = ReadTicks();
     }
 
+#if defined(_MSC_VER) && defined(_M_IX86)
     // called after the original function returns
     __declspec(naked) void PostSignalEventParamHook() {
         __asm {
@@ -1042,8 +1271,13 @@ namespace perf_monitor {
                 jmp pOriginalSignalEventParam
         }
     }
+#endif
 
     void loadConfig() {
+        // Called from SpellVisualsInitialize on the game thread, hooks on any other thread record
+        // into their own stats shard
+        SetGameThread();
+
         gStartTime = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::high_resolution_clock::now().time_since_epoch()).count());
 
@@ -1054,12 +1288,40 @@ namespace perf_monitor {
         rename("perf_monitor.log", "perf_monitor.log.1");
 
         // open new log file
-        debugLogFile.open("perf_monitor.log");
+        OpenLogFile("perf_monitor.log");
 
         DEBUG_LOG("Loading perf_monitor");
 
+        CalibrateTimer();
+        DEBUG_LOG("Timer backend: " << GetTimerBackendName() << ", " << gTicksPerUs << " ticks/us");
+
+        if (!LoadConfigFile("perf_monitor.cfg")) {
+            DEBUG_LOG("No perf_monitor.cfg found, using defaults");
+        }
+        ApplyHookTiers();
+
         // Initialize event stats
         initializeEventStats();
+        StartStatsWorker();
+        // After initializeEventStats, the aggregator writes the event stats from then on
+        if (StartStatAggregator()) {
+            DEBUG_LOG("Game thread hooks queue their stats for the aggregator thread");
+        }
+        // With the aggregator up so its ring is what gets timed, and before hitch capture and
+        // tracing, which would record the calibration calls
+        CalibrateHookOverhead();
+
+        if (StartHitchCapture("perf_monitor_hitches.log")) {
+            DEBUG_LOG("Writing frames of at least " << gConfig.hitchThresholdMs << " ms to perf_monitor_hitches.log");
+        }
+        if (StartTraceExport("perf_monitor_trace.json")) {
+            DEBUG_LOG("Tracing " << gConfig.traceSeconds << " seconds to perf_monitor_trace.json starting in "
+                                 << gConfig.traceStartSeconds << " seconds");
+        }
+
+        for (size_t i = 0; i < sizeof(gAceAddonBlacklist) / sizeof(gAceAddonBlacklist[0]); ++i) {
+            gAceAddonBlacklistIds[i] = InternAddonName(gAceAddonBlacklist[i], std::strlen(gAceAddonBlacklist[i]));
+        }
 
         // Initialize last event stats time
         gLastEventStatsTime = 0;
@@ -1182,6 +1444,7 @@ namespace perf_monitor {
         // Hook luaC_collectgarbage
         initializeHook<luaC_collectgarbageT>(process, Offsets::luaC_collectgarbage, &luaC_collectgarbageHook);
 
+#if defined(_MSC_VER) && defined(_M_IX86)
         // Hook SignalEventParam using Microsoft Detours
         pOriginalSignalEventParam = reinterpret_cast<SignalEventParamT>(Offsets::SignalEventParam);
         DetourTransactionBegin();
@@ -1195,6 +1458,7 @@ namespace perf_monitor {
         DetourUpdateThread(GetCurrentThread());
         DetourAttach(&(PVOID &) pOriginalFrameScript_Execute, FrameScript_ExecuteHook);
         DetourTransactionCommit();
+#endif
     }
 
     void SpellVisualsInitializeHook(hadesmem::PatchDetourBase *detour) {
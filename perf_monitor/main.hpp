@@ -21,6 +21,7 @@
 #include <fstream>
 #include "events.hpp"
 #include "cdatastore.hpp"
+#include "frame_cache.hpp"
 
 namespace perf_monitor {
 
@@ -174,4 +175,11 @@ namespace perf_monitor {
         }
     }
 
-}
\ No newline at end of file
+    // Frame to addon resolution, defined in main.cpp.  Declared here for the host tests and benchmarks.
+    extern FrameAddonCache gFrameAddonCache;
+
+    // Uncached, walks the frame's strings and interns the name
+    AddonId getAddonOrFrameId(uintptr_t *framescriptObj, uintptr_t *addonNamePtr);
+
+    AddonId resolveAddonId(uintptr_t *framescriptObj, uintptr_t *addonNamePtr);
+}
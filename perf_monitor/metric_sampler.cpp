@@ -0,0 +1,84 @@
+#include "metric_sampler.hpp"
+#include "config.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace perf_monitor {
+    MetricSampler gMetricSamplers[METRIC_COUNT];
+    thread_local uint32_t tSampleCountdowns[METRIC_COUNT];
+
+    // Leaf hooks only, skipping a call also drops it from the call tree so sampling anything
+    // with hooked children would misplace their time
+    static const MetricId kSampledMetrics[] = {
+            METRIC_CM2_MODEL_ANIMATE_MT,
+            METRIC_DRAW_BATCH_PROJ,
+            METRIC_DRAW_BATCH,
+            METRIC_DRAW_BATCH_DOODAD,
+            METRIC_DRAW_RIBBON,
+            METRIC_DRAW_PARTICLE,
+            METRIC_DRAW_CALLBACK,
+    };
+
+    static thread_local uint64_t tSampleRandomState = 0x2545f4914f6cdd1dull;
+
+    // xorshift64, only needs to be cheap and not line up with the order things are drawn in
+    static double NextSampleRandom() {
+        tSampleRandomState ^= tSampleRandomState << 13;
+        tSampleRandomState ^= tSampleRandomState >> 7;
+        tSampleRandomState ^= tSampleRandomState << 17;
+        // (0, 1] so the log below is finite
+        return static_cast<double>((tSampleRandomState >> 11) + 1) * (1.0 / 9007199254740992.0);
+    }
+
+    uint32_t NextSampleCountdown(const MetricSampler &sampler) {
+        if (gConfig.sampleRandom == 0) {
+            return sampler.sampleEvery;
+        }
+        // Geometric skip, the same as flipping a 1/N coin on every call but one log per timed call
+        double skip = std::floor(std::log(NextSampleRandom()) / sampler.logSkip);
+        return skip < 4294967294.0 ? static_cast<uint32_t>(skip) + 1 : UINT32_MAX;
+    }
+
+    static uint32_t gSampleFloor = 1;
+
+    static void UpdateSampleEvery(MetricSampler &sampler) {
+        sampler.sampleEvery = std::max(std::max(sampler.configured, gSampleFloor), 1u);
+        sampler.logSkip = sampler.sampleEvery > 1 ? std::log(1.0 - 1.0 / sampler.sampleEvery) : 0;
+    }
+
+    bool SetMetricSampleEvery(const std::string &name, uint32_t sampleEvery) {
+        for (MetricId id: kSampledMetrics) {
+            if (name != kMetricInfo[id].name) {
+                continue;
+            }
+            gMetricSamplers[id].configured = sampleEvery;
+            UpdateSampleEvery(gMetricSamplers[id]);
+            return true;
+        }
+        return false;
+    }
+
+    void ResetMetricSampling() {
+        for (MetricId id: kSampledMetrics) {
+            gMetricSamplers[id].configured = 1;
+            UpdateSampleEvery(gMetricSamplers[id]);
+        }
+    }
+
+    void SetMetricSampleFloor(uint32_t floor) {
+        gSampleFloor = floor;
+        for (MetricId id: kSampledMetrics) {
+            UpdateSampleEvery(gMetricSamplers[id]);
+        }
+    }
+
+    bool IsSampledMetric(MetricId id) {
+        for (MetricId sampled: kSampledMetrics) {
+            if (sampled == id) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "stats.hpp"
+#include "thread_shards.hpp"
+
+namespace perf_monitor {
+    // Call sampling for the render hooks that run thousands of times a frame.  A sampled hook
+    // still counts every call but only reads the clock for one in sampleEvery of them (every Nth
+    // call, or each call with probability 1/N when sample_random is set), the report scales the
+    // timed calls back up to the full call count.
+    struct MetricSampler {
+        uint32_t sampleEvery = 1; // 1 times every call
+        uint32_t configured = 1;  // sampleEvery from the config, before the overhead controller's floor
+        double logSkip = 0;       // log(1 - 1/sampleEvery), for random skip lengths
+    };
+
+    extern MetricSampler gMetricSamplers[METRIC_COUNT];
+
+    // Per thread, calls left up to and including the next timed one.  0 or 1 times the next call.
+    extern thread_local uint32_t tSampleCountdowns[METRIC_COUNT];
+
+    // Calls until the next timed one, after one was just timed
+    uint32_t NextSampleCountdown(const MetricSampler &sampler);
+
+    // True if this call should be timed, otherwise it is counted as skipped and the hook should
+    // call straight through.
+    inline bool SampleMetricCall(MetricId id) {
+        const MetricSampler &sampler = gMetricSamplers[id];
+        if (sampler.sampleEvery == 1) {
+            return true;
+        }
+        uint32_t &countdown = tSampleCountdowns[id];
+        if (countdown > 1) {
+            --countdown;
+            SkipThreadMetric(id);
+            return false;
+        }
+        countdown = NextSampleCountdown(sampler);
+        return true;
+    }
+
+    // Sets the sample interval of a hook by its report name, from the sample.<name> config keys.
+    // Returns false for names that aren't a sampled hook.
+    bool SetMetricSampleEvery(const std::string &name, uint32_t sampleEvery);
+
+    // Every hook back to its configured interval of 1, before the config is read again
+    void ResetMetricSampling();
+
+    // Lowest interval of every sampled hook, raised by the overhead controller, 1 for none
+    void SetMetricSampleFloor(uint32_t floor);
+
+    bool IsSampledMetric(MetricId id);
+}
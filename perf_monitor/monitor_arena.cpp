@@ -0,0 +1,66 @@
+#include "monitor_arena.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace perf_monitor {
+    constexpr size_t MonitorArena::CHUNK_SIZE;
+    constexpr size_t MonitorArena::MAX_CHUNKS;
+
+    MonitorArena::MonitorArena(size_t maxBytes)
+            : chunkLimit(std::min((maxBytes + CHUNK_SIZE - 1) / CHUNK_SIZE, MAX_CHUNKS)) {}
+
+    MonitorArena::~MonitorArena() {
+        for (size_t i = 0; i < chunkCount; ++i) {
+            ::operator delete(chunks[i]);
+        }
+    }
+
+    void *MonitorArena::allocate(size_t size, size_t alignment) {
+        while (true) {
+            if (current < chunkCount) {
+                auto base = reinterpret_cast<uintptr_t>(chunks[current]);
+                uintptr_t start = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+                if (start + size <= base + CHUNK_SIZE) {
+                    offset = start + size - base;
+                    return reinterpret_cast<void *>(start);
+                }
+                if (offset == 0) {
+                    return nullptr; // doesn't fit in an empty chunk either
+                }
+                // Rest of this chunk stays unused until the next rewind
+                ++current;
+                offset = 0;
+                continue;
+            }
+
+            if (chunkCount == chunkLimit) {
+                return nullptr;
+            }
+            auto *chunk = static_cast<char *>(::operator new(CHUNK_SIZE, std::nothrow));
+            if (chunk == nullptr) {
+                return nullptr;
+            }
+            chunks[chunkCount++] = chunk;
+            offset = 0;
+        }
+    }
+
+    bool MonitorArena::owns(const void *memory) const {
+        auto *byte = static_cast<const char *>(memory);
+        for (size_t i = 0; i < chunkCount; ++i) {
+            // std::less gives a total order even across unrelated chunks
+            if (!std::less<const char *>()(byte, chunks[i]) && std::less<const char *>()(byte, chunks[i] + CHUNK_SIZE)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t MonitorArena::usedBytes() const {
+        if (current >= chunkCount) {
+            return chunkCount * CHUNK_SIZE;
+        }
+        return current * CHUNK_SIZE + offset;
+    }
+}
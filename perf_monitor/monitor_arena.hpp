@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace perf_monitor {
+    // Monotonic arena for memory the monitor owns.  Allocations bump a pointer through fixed size
+    // chunks that come from the heap the first time they are needed and are kept after that, so
+    // once the session has had its busiest window the monitor stops touching the client's heap and
+    // can't fragment it any further.  Nothing is freed on its own, rewind() drops everything
+    // allocated since a mark in one step without running destructors, so only trivially
+    // destructible things go in here.  One owner at a time, like the stats window it belongs to.
+    class MonitorArena {
+    public:
+        static constexpr size_t CHUNK_SIZE = 256 * 1024;
+        static constexpr size_t MAX_CHUNKS = 128;
+
+        struct Mark {
+            size_t chunk;
+            size_t offset;
+        };
+
+        // Never holds more than maxBytes of chunks, rounded up to whole chunks
+        explicit MonitorArena(size_t maxBytes);
+
+        MonitorArena(const MonitorArena &) = delete;
+
+        MonitorArena &operator=(const MonitorArena &) = delete;
+
+        ~MonitorArena();
+
+        // nullptr once the arena is at its limit, or for anything bigger than a chunk
+        void *allocate(size_t size, size_t alignment);
+
+        // Value initialized T, nullptr like allocate()
+        template<typename T>
+        T *create() {
+            void *memory = allocate(sizeof(T), alignof(T));
+            return memory != nullptr ? new(memory) T() : nullptr;
+        }
+
+        Mark mark() const {
+            return {current, offset};
+        }
+
+        void rewind(Mark mark) {
+            current = mark.chunk;
+            offset = mark.offset;
+        }
+
+        // Back to empty, the chunks are kept for next time
+        void reset() {
+            rewind({0, 0});
+        }
+
+        // True if memory came out of one of this arena's chunks
+        bool owns(const void *memory) const;
+
+        // Handed out since the last reset
+        size_t usedBytes() const;
+
+        // Taken from the heap so far
+        size_t reservedBytes() const {
+            return chunkCount * CHUNK_SIZE;
+        }
+
+    private:
+        char *chunks[MAX_CHUNKS] = {};
+        size_t chunkCount = 0;
+        size_t chunkLimit;
+        size_t current = 0; // chunk being bumped through
+        size_t offset = 0;  // first free byte of it
+    };
+
+    // Standard allocator on top of a MonitorArena for the report's scratch containers.  Freeing is
+    // a no-op, the memory comes back when the arena is reset.  Falls back to the heap once the
+    // arena is full rather than failing halfway through a report.
+    template<typename T>
+    class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        ArenaAllocator(MonitorArena &arena) : arena(&arena) {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+        T *allocate(size_t count) {
+            void *memory = arena->allocate(count * sizeof(T), alignof(T));
+            if (memory == nullptr) {
+                memory = ::operator new(count * sizeof(T));
+            }
+            return static_cast<T *>(memory);
+        }
+
+        void deallocate(T *memory, size_t) {
+            if (!arena->owns(memory)) {
+                ::operator delete(memory);
+            }
+        }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U> &other) const {
+            return arena == other.arena;
+        }
+
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U> &other) const {
+            return arena != other.arena;
+        }
+
+        MonitorArena *arena;
+    };
+
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
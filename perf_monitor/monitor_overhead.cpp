@@ -0,0 +1,230 @@
+#include "monitor_overhead.hpp"
+#include "config.hpp"
+#include "hitch_capture.hpp"
+#include "hook_tiers.hpp"
+#include "logging.hpp"
+#include "metric_sampler.hpp"
+#include "stat_records.hpp"
+#include "stats.hpp"
+#include "thread_shards.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace perf_monitor {
+    constexpr int CALIBRATION_ROUNDS = 15;
+    constexpr int CALIBRATION_CALLS = 2000;
+    // A full ring would drop records and time as cheaper than a push that fits
+    static_assert(CALIBRATION_ROUNDS * CALIBRATION_CALLS * sizeof(StatRecord) < STAT_RECORD_RING_SIZE,
+                  "calibration must fit in the stat record ring");
+    constexpr uint32_t OVERHEAD_SAMPLE_FLOOR = 16;
+    // A step is only undone if the overhead stays under this much of the budget with it back
+    constexpr double OVERHEAD_RESTORE_MARGIN = 0.75;
+
+    // Metrics of the hooks gated on HOOK_TIER_RENDER_DETAIL in main.cpp
+    static const MetricId kRenderDetailMetrics[] = {
+            METRIC_UNKNOWN_ON_RENDER1, METRIC_UNKNOWN_ON_RENDER2, METRIC_UNKNOWN_ON_RENDER3,
+            METRIC_CM2_SCENE_ADVANCE_TIME, METRIC_CM2_SCENE_ANIMATE, METRIC_CM2_MODEL_ANIMATE_MT,
+            METRIC_CM2_SCENE_DRAW, METRIC_DRAW_BATCH_PROJ, METRIC_DRAW_BATCH, METRIC_DRAW_BATCH_DOODAD,
+            METRIC_DRAW_RIBBON, METRIC_DRAW_PARTICLE, METRIC_DRAW_CALLBACK, METRIC_CM2_SCENE_RENDER_DRAW,
+            METRIC_CWORLD_SCENE_RENDER, METRIC_UNIT_UPDATE, METRIC_CWORLD_UPDATE, METRIC_CWORLD_RENDER,
+            METRIC_CWORLD_UNKNOWN_RENDER, METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER1,
+            METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER2, METRIC_CSIMPLE_MODEL_ON_FRAME_RENDER,
+            METRIC_SPELL_VISUALS_RENDER, METRIC_SPELL_VISUALS_TICK,
+    };
+
+    enum OverheadStepKind {
+        OVERHEAD_STEP_SAMPLING,
+        OVERHEAD_STEP_TIER,
+    };
+
+    struct OverheadStep {
+        OverheadStepKind kind;
+        HookTier tier;  // OVERHEAD_STEP_TIER only
+        double percent; // estimated overhead it removed, % of the window it was taken in
+    };
+
+    static double gHookCallTicks = 0;
+    // At most one sampling step and one per tier
+    static OverheadStep gOverheadSteps[3];
+    static size_t gOverheadStepCount = 0;
+    static uint32_t gSampleFloor = 1;
+    static uint32_t gSuppressedTiers = 0;
+
+    void CalibrateHookOverhead() {
+        // Fastest round, the others include whatever else the machine was doing
+        uint64_t best = UINT64_MAX;
+        for (int round = 0; round < CALIBRATION_ROUNDS; ++round) {
+            auto roundStart = ReadTicks();
+            for (int i = 0; i < CALIBRATION_CALLS; ++i) {
+                CallTreeEnter(METRIC_PAINT_SCREEN);
+                auto start = ReadTicks();
+                auto end = ReadTicks();
+                auto duration = end - start;
+                // The hooks' own path, a ring push when the aggregator is running
+                RecordMetric(METRIC_PAINT_SCREEN, duration);
+                CallTreeLeave(duration);
+                RecordHookSpan(METRIC_PAINT_SCREEN, start, duration);
+            }
+            best = std::min(best, ReadTicks() - roundStart);
+        }
+        // Nothing of the calibration may still be on its way into the window being cleared
+        FlushStatRecords();
+        ActiveStats().clear();
+
+        gHookCallTicks = static_cast<double>(best) / CALIBRATION_CALLS;
+        DEBUG_LOG(std::fixed << std::setprecision(1)
+                             << "Hook bookkeeping: " << gHookCallTicks / gTicksPerUs * 1000.0 << " ns per timed call");
+    }
+
+    static double ToPercent(double ticks, uint64_t windowTicks) {
+        return windowTicks > 0 ? ticks / static_cast<double>(windowTicks) * 100.0 : 0.0;
+    }
+
+    static bool IsTierActive(HookTier tier) {
+        return (GetConfiguredHookTiers() & tier) != 0 && (gSuppressedTiers & tier) == 0;
+    }
+
+    // Over budget, take the first step that is still available
+    static const char *RaiseOverheadStep(const MetricTable &metrics, const MonitorOverhead &overhead,
+                                         uint64_t windowTicks) {
+        // Calls the sampling floor would no longer time
+        double samplingTicks = 0;
+        double renderDetailTicks = 0;
+        for (MetricId id: kRenderDetailMetrics) {
+            renderDetailTicks += static_cast<double>(metrics.counts[id]) * gHookCallTicks;
+            if (IsSampledMetric(id)) {
+                double timedAfter = static_cast<double>(metrics.calls(id)) / OVERHEAD_SAMPLE_FLOOR;
+                samplingTicks += std::max(0.0, static_cast<double>(metrics.counts[id]) - timedAfter) * gHookCallTicks;
+            }
+        }
+
+        if (gSampleFloor == 1 && IsTierActive(HOOK_TIER_RENDER_DETAIL) && samplingTicks > 0) {
+            gOverheadSteps[gOverheadStepCount++] = {OVERHEAD_STEP_SAMPLING, HOOK_TIER_RENDER_DETAIL,
+                                                    ToPercent(samplingTicks, windowTicks)};
+            gSampleFloor = OVERHEAD_SAMPLE_FLOOR;
+            SetMetricSampleFloor(gSampleFloor);
+            return "raised render hook sampling to at least 1 in 16";
+        }
+
+        // Otherwise whichever tier costs the most
+        double memoryTicks = static_cast<double>(overhead.luaMemoryTicks);
+        HookTier tier;
+        double tierTicks;
+        if (IsTierActive(HOOK_TIER_MEMORY) &&
+            (!IsTierActive(HOOK_TIER_RENDER_DETAIL) || memoryTicks >= renderDetailTicks)) {
+            tier = HOOK_TIER_MEMORY;
+            tierTicks = memoryTicks;
+        } else if (IsTierActive(HOOK_TIER_RENDER_DETAIL)) {
+            tier = HOOK_TIER_RENDER_DETAIL;
+            tierTicks = renderDetailTicks;
+        } else {
+            return nullptr;
+        }
+
+        gOverheadSteps[gOverheadStepCount++] = {OVERHEAD_STEP_TIER, tier, ToPercent(tierTicks, windowTicks)};
+        gSuppressedTiers |= tier;
+        SuppressHookTiers(gSuppressedTiers);
+        return tier == HOOK_TIER_MEMORY ? "turned off the memory tier" : "turned off the render detail tier";
+    }
+
+    static const char *LowerOverheadStep() {
+        const OverheadStep &step = gOverheadSteps[--gOverheadStepCount];
+        if (step.kind == OVERHEAD_STEP_SAMPLING) {
+            gSampleFloor = 1;
+            SetMetricSampleFloor(gSampleFloor);
+            return "restored configured render hook sampling";
+        }
+        gSuppressedTiers &= ~static_cast<uint32_t>(step.tier);
+        SuppressHookTiers(gSuppressedTiers);
+        return step.tier == HOOK_TIER_MEMORY ? "turned the memory tier back on" : "turned the render detail tier back on";
+    }
+
+    void UpdateOverheadController(StatsWindow &window) {
+        MonitorOverhead &overhead = window.overhead;
+        const MetricTable &metrics = window.metrics;
+
+        overhead.hookCalls = 0;
+        for (int i = 0; i < METRIC_COUNT; ++i) {
+            overhead.hookCalls += metrics.counts[i];
+        }
+        for (const auto &stats: window.eventCodeStats) {
+            overhead.hookCalls += stats.callCount;
+        }
+        overhead.hookTicks = static_cast<uint64_t>(static_cast<double>(overhead.hookCalls) * gHookCallTicks);
+
+        uint64_t windowTicks = UsToTicks(static_cast<double>(window.endTime - window.startTime) * 1000.0);
+        uint64_t totalTicks = overhead.hookTicks + overhead.nameResolutionTicks + overhead.luaMemoryTicks;
+        overhead.percent = ToPercent(static_cast<double>(totalTicks), windowTicks);
+        overhead.budgetPercent = gConfig.overheadBudgetPercent;
+        overhead.sampleFloor = gSampleFloor;
+        overhead.suppressedTiers = gSuppressedTiers;
+        overhead.action = nullptr;
+
+        double budget = overhead.budgetPercent;
+        if (budget <= 0) {
+            // Controller switched off since the last window, give back anything it took
+            while (gOverheadStepCount > 0) {
+                overhead.action = LowerOverheadStep();
+            }
+            return;
+        }
+
+        if (overhead.percent > budget) {
+            overhead.action = RaiseOverheadStep(metrics, overhead, windowTicks);
+        } else if (gOverheadStepCount > 0 &&
+                   overhead.percent + gOverheadSteps[gOverheadStepCount - 1].percent <=
+                   budget * OVERHEAD_RESTORE_MARGIN) {
+            overhead.action = LowerOverheadStep();
+        }
+
+        if (overhead.action != nullptr) {
+            DEBUG_LOG(std::fixed << std::setprecision(2) << "Overhead controller: " << overhead.percent
+                                 << "% of the window against a " << budget << "% budget, " << overhead.action);
+        }
+    }
+
+    void OutputMonitorOverhead(const StatsWindow &window) {
+        const MonitorOverhead &overhead = window.overhead;
+        uint64_t totalTicks = overhead.hookTicks + overhead.nameResolutionTicks + overhead.luaMemoryTicks;
+
+        DEBUG_LOG(std::fixed << std::setprecision(2)
+                             << "[Overhead] Monitor: " << TicksToMs(totalTicks) << " ms (" << overhead.percent
+                             << "% of the window).  Hooks: " << TicksToMs(overhead.hookTicks) << " ms for "
+                             << overhead.hookCalls << " timed calls, name resolution: "
+                             << TicksToMs(overhead.nameResolutionTicks) << " ms, Lua memory: "
+                             << TicksToMs(overhead.luaMemoryTicks) << " ms");
+        if (gStatRecordChannel) {
+            DEBUG_LOG("[Overhead] Aggregator thread: " << overhead.droppedRecords
+                                                       << " hook records dropped because the ring was full");
+        }
+        DEBUG_LOG("[Overhead] Window memory: " << window.arena.usedBytes() / 1024 << " KB used of "
+                                               << window.arena.reservedBytes() / 1024 << " KB held, "
+                                               << overhead.arenaFullDrops << " addon updates dropped because it was full");
+        if (window.addonEvictions > 0 || window.spellVisualStats.evictions() > 0) {
+            DEBUG_LOG("[Overhead] Heavy hitter slots: " << window.addonEvictions << " addon/frame and "
+                                                        << window.spellVisualStats.evictions()
+                                                        << " spell visual slots taken over by new ids");
+        }
+
+        std::stringstream state;
+        if (overhead.budgetPercent <= 0) {
+            state << "off";
+        } else {
+            state << std::fixed << std::setprecision(2) << "budget " << overhead.budgetPercent << "%";
+            if (overhead.sampleFloor > 1) {
+                state << ", render hooks sampled at least 1 in " << overhead.sampleFloor;
+            }
+            for (HookTier tier: {HOOK_TIER_RENDER_DETAIL, HOOK_TIER_MEMORY}) {
+                if ((overhead.suppressedTiers & tier) != 0) {
+                    state << ", " << GetHookTierName(tier) << " tier off";
+                }
+            }
+        }
+        if (overhead.action != nullptr) {
+            state << ".  Next window: " << overhead.action;
+        }
+        DEBUG_LOG("[Overhead] Controller: " << state.str());
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace perf_monitor {
+    struct StatsWindow;
+
+    // What the monitor itself cost during one window, in timer ticks, and the overhead
+    // controller's state while it ran
+    struct MonitorOverhead {
+        uint64_t nameResolutionTicks = 0; // frame -> addon lookups that missed the frame cache
+        uint64_t luaMemoryTicks = 0;      // GetLuaMemoryKB around addon handlers
+        uint64_t droppedRecords = 0;      // hook records lost to a full ring, aggregator_thread only
+        uint64_t arenaFullDrops = 0;      // addon updates lost because the window's arena was full
+
+        // Filled in when the window closes
+        uint64_t hookCalls = 0;           // timed hook calls
+        uint64_t hookTicks = 0;           // hookCalls times the calibrated cost of one
+        double percent = 0;               // everything above as a share of the window
+        double budgetPercent = 0;         // overhead_budget_percent at the time, 0 with the controller off
+        uint32_t sampleFloor = 1;
+        uint32_t suppressedTiers = 0;
+        const char *action = nullptr;     // what the controller changed for the next window, if anything
+    };
+
+    // Times the bookkeeping around one hook call (clock reads, RecordMetric, call tree and span
+    // check) in a loop.  Call once before the hooks are installed, after StartStatAggregator so a
+    // ring push is what gets timed when the aggregator runs, and before hitch capture or tracing
+    // start.  It uses and then clears the active window.
+    void CalibrateHookOverhead();
+
+    // Game thread, when a window closes.  Works out the window's overhead and, with
+    // overhead_budget_percent set, takes one step while over budget: render hook sampling of at
+    // least 1 in 16 first, then turning off the most expensive hook tier.  The last step is undone
+    // once the overhead it removed fits back under the budget with some margin.
+    void UpdateOverheadController(StatsWindow &window);
+
+    // The [Overhead] lines of the report
+    void OutputMonitorOverhead(const StatsWindow &window);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+namespace perf_monitor {
+    // Bounded single producer / single consumer byte ring.  Head and tail are free running
+    // counters, only masked when indexing, so full and empty never need a spare slot.
+    template<size_t Capacity>
+    class SpscByteRing {
+        static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        // Producer side: copies the whole span or nothing
+        bool tryPush(const char *data, size_t size) {
+            size_t head = writePos.load(std::memory_order_relaxed);
+            // Only look at the consumer's cache line when the ring seems full
+            if (size > Capacity - (head - cachedReadPos)) {
+                cachedReadPos = readPos.load(std::memory_order_acquire);
+                if (size > Capacity - (head - cachedReadPos)) {
+                    return false;
+                }
+            }
+
+            size_t offset = head & (Capacity - 1);
+            size_t firstPart = Capacity - offset < size ? Capacity - offset : size;
+            std::memcpy(buffer + offset, data, firstPart);
+            std::memcpy(buffer, data + firstPart, size - firstPart);
+
+            writePos.store(head + size, std::memory_order_release);
+            return true;
+        }
+
+        // Producer side for rings of fixed size records, which then never straddle the wrap.  Same
+        // as tryPush but a constant size copy the compiler turns into plain stores.
+        template<typename T>
+        bool tryPushRecord(const T &record) {
+            static_assert(Capacity % sizeof(T) == 0, "Records must never straddle the ring wrap");
+            size_t head = writePos.load(std::memory_order_relaxed);
+            if (sizeof(T) > Capacity - (head - cachedReadPos)) {
+                cachedReadPos = readPos.load(std::memory_order_acquire);
+                if (sizeof(T) > Capacity - (head - cachedReadPos)) {
+                    return false;
+                }
+            }
+
+            std::memcpy(buffer + (head & (Capacity - 1)), &record, sizeof(T));
+            writePos.store(head + sizeof(T), std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side: returns the contiguous readable span up to the wrap point
+        size_t peek(const char **data) const {
+            size_t tail = readPos.load(std::memory_order_relaxed);
+            size_t head = writePos.load(std::memory_order_acquire);
+            size_t offset = tail & (Capacity - 1);
+            size_t available = head - tail;
+            *data = buffer + offset;
+            return Capacity - offset < available ? Capacity - offset : available;
+        }
+
+        void consume(size_t size) {
+            readPos.store(readPos.load(std::memory_order_relaxed) + size, std::memory_order_release);
+        }
+
+    private:
+        alignas(64) std::atomic<size_t> writePos{0};
+        size_t cachedReadPos = 0; // producer only, readPos as of the last time the ring looked full
+        alignas(64) std::atomic<size_t> readPos{0};
+        alignas(64) char buffer[Capacity];
+    };
+}
@@ -0,0 +1,112 @@
+#include "stat_records.hpp"
+#include "config.hpp"
+#include "events.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace perf_monitor {
+    constexpr int STAT_AGGREGATOR_IDLE_MS = 1;
+
+    bool gStatRecordChannel = false;
+    SpscByteRing<STAT_RECORD_RING_SIZE> gStatRecordRing;
+
+    // Held by whoever consumes the ring, normally the aggregator.  The game thread takes it to
+    // drain the rest itself when a window closes instead of waiting for the aggregator to wake up.
+    // Leaked like the stats worker's, the detached aggregator never exits.
+    static std::mutex &gStatRecordConsumerMutex = *new std::mutex;
+
+    void ApplyStatRecord(const StatRecord &record) {
+        StatsWindow &window = gStatsWindows[record.epoch & 1];
+        switch (record.kind) {
+            case STAT_RECORD_METRIC:
+                window.metrics.update(static_cast<MetricId>(record.id), record.value);
+                break;
+            case STAT_RECORD_METRIC_SAMPLED:
+                window.metrics.updateSampled(static_cast<MetricId>(record.id), record.value);
+                break;
+            case STAT_RECORD_EVENT:
+                window.eventStats[static_cast<EVENT_ID>(record.id)].update(record.value);
+                break;
+            case STAT_RECORD_EVENT_CODE:
+                window.eventCodeStats[record.id].update(record.value);
+                break;
+            case STAT_RECORD_SPELL_VISUAL:
+                window.spellVisualStats.find(record.arg).update(record.value);
+                break;
+            case STAT_RECORD_ADDON_ON_EVENT:
+                if (AddonStats *addon = window.addon(record.id)) {
+                    addon->onEvent.update(record.value);
+                }
+                if (!window.addonEvents.record(record.id, static_cast<int>(record.arg), record.value)) {
+                    window.overhead.arenaFullDrops++;
+                }
+                break;
+            case STAT_RECORD_ADDON_ON_UPDATE:
+                if (AddonStats *addon = window.addon(record.id)) {
+                    addon->onUpdate.update(record.value);
+                }
+                break;
+            case STAT_RECORD_ADDON_ON_EVENT_MEMORY:
+                if (AddonStats *addon = window.addon(record.id)) {
+                    addon->onEventMemory.update(static_cast<int>(record.value));
+                }
+                break;
+            case STAT_RECORD_ADDON_ON_UPDATE_MEMORY:
+                if (AddonStats *addon = window.addon(record.id)) {
+                    addon->onUpdateMemory.update(static_cast<int>(record.value));
+                }
+                break;
+        }
+    }
+
+    // Caller holds gStatRecordConsumerMutex.  Applies the contiguous run of records up to the
+    // wrap point and returns how many there were.
+    static size_t DrainStatRecords() {
+        const char *data;
+        size_t size = gStatRecordRing.peek(&data);
+        size_t recordCount = size / sizeof(StatRecord);
+        for (size_t i = 0; i < recordCount; ++i) {
+            StatRecord record;
+            std::memcpy(&record, data + i * sizeof(StatRecord), sizeof(StatRecord));
+            ApplyStatRecord(record);
+        }
+        gStatRecordRing.consume(recordCount * sizeof(StatRecord));
+        return recordCount;
+    }
+
+    static void StatAggregatorThread() {
+        while (true) {
+            size_t applied;
+            {
+                std::lock_guard<std::mutex> lock(gStatRecordConsumerMutex);
+                applied = DrainStatRecords();
+            }
+            if (applied == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(STAT_AGGREGATOR_IDLE_MS));
+            }
+        }
+    }
+
+    bool StartStatAggregator() {
+        if (gStatRecordChannel || gConfig.aggregatorThread == 0) {
+            return false;
+        }
+        gStatRecordChannel = true;
+        // Never joined, the aggregator lives as long as the client process
+        std::thread(StatAggregatorThread).detach();
+        return true;
+    }
+
+    void FlushStatRecords() {
+        if (!gStatRecordChannel) {
+            return;
+        }
+        // The game thread is the only producer, nothing more can arrive for this window
+        std::lock_guard<std::mutex> lock(gStatRecordConsumerMutex);
+        while (DrainStatRecords() > 0) {
+        }
+    }
+}
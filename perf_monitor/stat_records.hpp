@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include "spsc_ring.hpp"
+#include "stats.hpp"
+#include "thread_shards.hpp"
+
+namespace perf_monitor {
+    // With aggregator_thread set the game thread's hooks don't update any stats themselves, they
+    // push one of these into a ring and the aggregator thread applies it to the window.  Without
+    // it the same record is applied straight away, so both modes share one code path.
+    enum StatRecordKind : uint8_t {
+        STAT_RECORD_METRIC,                // id: MetricId
+        STAT_RECORD_METRIC_SAMPLED,        // id: MetricId, timed call of a sampled hook
+        STAT_RECORD_EVENT,                 // id: EVENT_ID
+        STAT_RECORD_EVENT_CODE,            // id: event code slot
+        STAT_RECORD_SPELL_VISUAL,          // arg: spell id
+        STAT_RECORD_ADDON_ON_EVENT,        // id: AddonId, arg: event code slot
+        STAT_RECORD_ADDON_ON_UPDATE,       // id: AddonId
+        STAT_RECORD_ADDON_ON_EVENT_MEMORY, // id: AddonId, value: Lua KB delta
+        STAT_RECORD_ADDON_ON_UPDATE_MEMORY,
+    };
+
+    struct StatRecord {
+        uint8_t kind;
+        uint8_t epoch;  // low byte of gStatsEpoch when it was pushed, picks the window
+        uint16_t id;
+        uint32_t arg;
+        uint64_t value; // timer ticks, or a memory delta for the memory kinds
+    };
+
+    static_assert(sizeof(StatRecord) == 16, "StatRecord is meant to be 16 bytes");
+
+    constexpr size_t STAT_RECORD_RING_SIZE = 1 << 20; // 65536 records
+
+    // Game thread only, set once by StartStatAggregator before the hooks are installed
+    extern bool gStatRecordChannel;
+    extern SpscByteRing<STAT_RECORD_RING_SIZE> gStatRecordRing;
+
+    // Adds a record to the window it was pushed in
+    void ApplyStatRecord(const StatRecord &record);
+
+    inline void PushStatRecord(StatRecordKind kind, uint16_t id, uint32_t arg, uint64_t value) {
+        StatRecord record = {kind, static_cast<uint8_t>(gStatsEpoch.load(std::memory_order_relaxed)), id, arg,
+                             value};
+        if (!gStatRecordRing.tryPushRecord(record)) {
+            ActiveStats().overhead.droppedRecords++;
+        }
+    }
+
+    // Game thread only, for the stats that are never touched anywhere else
+    inline void RecordStat(StatRecordKind kind, uint16_t id, uint32_t arg, uint64_t value) {
+        if (gStatRecordChannel) {
+            PushStatRecord(kind, id, arg, value);
+            return;
+        }
+        StatRecord record = {kind, static_cast<uint8_t>(gStatsEpoch.load(std::memory_order_relaxed)), id, arg,
+                             value};
+        ApplyStatRecord(record);
+    }
+
+    // Any thread, the other threads always write their own shard
+    inline void RecordMetric(MetricId id, uint64_t duration) {
+        if (gStatRecordChannel && IsGameThread()) {
+            PushStatRecord(STAT_RECORD_METRIC, id, 0, duration);
+            return;
+        }
+        UpdateThreadMetric(id, duration);
+    }
+
+    inline void RecordSampledMetric(MetricId id, uint64_t duration) {
+        if (gStatRecordChannel && IsGameThread()) {
+            PushStatRecord(STAT_RECORD_METRIC_SAMPLED, id, 0, duration);
+            return;
+        }
+        UpdateThreadMetricSampled(id, duration);
+    }
+
+    // Starts the aggregator thread if aggregator_thread is set.  Call after LoadConfigFile and
+    // before the hooks are installed.
+    bool StartStatAggregator();
+
+    // Game thread, before the active window is retired.  Applies whatever is still in the ring so
+    // the window is complete when it is handed to the stats worker.
+    void FlushStatRecords();
+}
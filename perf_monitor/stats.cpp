@@ -1,244 +1,736 @@
 #include "stats.hpp"
 #include "logging.hpp"
 #include "events.hpp"
+#include "folded_export.hpp"
+#include "window_report.hpp"
+#include "stat_records.hpp"
+#include "thread_shards.hpp"
 #include <iomanip>
+#include <cstdio>
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <sstream>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace perf_monitor {
 
-    // Create stats objects for each monitored function
-    FunctionStats gRenderWorldStats("RenderWorld");
-    FunctionStats gOnWorldRenderStats("OnWorldRender");
-    FunctionStats gOnWorldUpdateStats("OnWorldUpdate");
-    FunctionStats gSpellVisualsRenderStats("SpellVisualsRender");
-    FunctionStats gSpellVisualsTickStats("SpellVisualsTick");
-    FunctionStats gUnitUpdateStats("UnitUpdate");
-    FunctionStats gFrameOnLayerUpdateStats("All OnUpdates");
-    FunctionStats gCWorldRenderStats("CWorldRender");
-    FunctionStats gCWorldUpdateStats("CWorldUpdate");
-    FunctionStats gCWorldSceneRenderStats("CWorldSceneRender");
-    FunctionStats gCWorldUnknownRenderStats("CWorldUnknownRender");
-    FunctionStats gTimeBetweenRenderStats("TimeBetweenRender");
-    FunctionStats gFrameOnScriptEventStats("All Event Handling");
-    FunctionStats gCSimpleFrameOnFrameRender1Stats("CSimpleFrameOnFrameRender1");
-    FunctionStats gCSimpleFrameOnFrameRender2Stats("CSimpleFrameOnFrameRender2");
-    FunctionStats gCSimpleModelOnFrameRenderStats("CSimpleModelOnFrameRender");
-    FunctionStats gCSimpleTopOnLayerUpdateStats("UIParent OnUpdate");
-    FunctionStats gCSimpleTopOnLayerRenderStats("UIParent OnRender");
-    FunctionStats gObjectUpdateHandlerStats("ObjectUpdateHandler");
-    FunctionStats gPlaySpellVisualStats("PlaySpellVisual");
-    FunctionStats gUnknownOnRender1Stats("UnknownOnRender1");
-    FunctionStats gUnknownOnRender2Stats("UnknownOnRender2");
-    FunctionStats gUnknownOnRender3Stats("UnknownOnRender3");
-    FunctionStats gCM2SceneAdvanceTimeStats("CM2Scene::AdvanceTime");
-    FunctionStats gCM2SceneAnimateStats("CM2Scene::Animate");
-    FunctionStats gCM2SceneDrawStats("CM2Scene::Draw");
-    FunctionStats gPaintScreenStats("PaintScreen");
-    FunctionStats gDrawBatchProjStats("CM2SceneRender::DrawBatchProj");
-    FunctionStats gDrawBatchStats("CM2SceneRender::DrawBatch");
-    FunctionStats gDrawBatchDoodadStats("CM2SceneRender::DrawBatchDoodad");
-    FunctionStats gDrawRibbonStats("CM2SceneRender::DrawRibbon");
-    FunctionStats gDrawParticleStats("CM2SceneRender::DrawParticle");
-    FunctionStats gDrawCallbackStats("CM2SceneRender::DrawCallback");
-    FunctionStats gCM2SceneRenderDrawStats("CM2SceneRender::Draw");
-    FunctionStats gCM2ModelAnimateMTStats("CM2Model::AnimateMT");
-    FunctionStats gLuaCCollectgarbageStats("Lua Garbage Collection");
-    FunctionStats gObjectFreeStats("World Object Garbage Collection");
-
-    void FunctionStats::update(long long duration) {
-        double d = static_cast<double>(duration);
+    StatsWindow gStatsWindows[2];
+    std::atomic<uint32_t> gStatsEpoch{0};
+    LatencyHistogram gMetricSessionHistograms[METRIC_COUNT];
+    uint64_t gStatsPeriodStartTime = 0;
+
+    // Stats worker handoff, gRetiredWindow is guarded by gStatsWorkerMutex.  The mutex and condition
+    // are leaked on purpose, the detached worker is still waiting on them during static destruction.
+    static std::mutex &gStatsWorkerMutex = *new std::mutex;
+    static std::condition_variable &gStatsWorkerCondition = *new std::condition_variable;
+    static StatsWindow *gRetiredWindow = nullptr;
+    static std::atomic<bool> gStatsWorkerRunning{false};
+    static std::atomic<bool> gReportInFlight{false};
+    // Game thread only, first frame of the window that is currently active
+    static uint64_t gNextWindowFirstFrame = 0;
+    // Scratch space for the report's sorting and slicing, reset after every report.  Only used by
+    // whoever reports, leaked like the worker's mutex.
+    static MonitorArena &gReportArena = *new MonitorArena(4 * 1024 * 1024);
+
+    constexpr double STUTTER_MEDIAN_MULTIPLE = 2.0; // frames slower than this many medians are stutters
+    constexpr double LONG_FRAME_MS = 100.0;
+    constexpr size_t ADDON_LABEL_SIZE = 128;
+
+    // "<addon name><suffix>" for the per addon report lines, cut short if it has to be
+    static const char *AddonLabel(char (&label)[ADDON_LABEL_SIZE], AddonId id, const char *suffix) {
+        std::snprintf(label, sizeof(label), "%s%s", GetAddonName(id), suffix);
+        return label;
+    }
+
+    uint64_t LatencyHistogram::bucketValue(int index) {
+        int group = index / static_cast<int>(SUB_BUCKETS);
+        if (group == 0) {
+            return static_cast<uint64_t>(index);
+        }
+        int shift = group - 1;
+        uint64_t subBucket = static_cast<uint64_t>(index) & (SUB_BUCKETS - 1);
+        uint64_t lowerBound = (SUB_BUCKETS + subBucket) << shift;
+        return lowerBound + ((1ULL << shift) >> 1);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram &other) {
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        totalCount += other.totalCount;
+    }
+
+    uint64_t LatencyHistogram::percentile(double percent) const {
+        if (totalCount == 0) {
+            return 0;
+        }
+
+        // Rank of the sample we're looking for, 1 based
+        auto rank = static_cast<uint64_t>(percent / 100.0 * static_cast<double>(totalCount) + 0.5);
+        if (rank < 1) rank = 1;
+        if (rank > totalCount) rank = totalCount;
+
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return bucketValue(i);
+            }
+        }
+        return bucketValue(BUCKET_COUNT - 1);
+    }
+
+    void LatencyHistogram::clear() {
+        std::fill(std::begin(buckets), std::end(buckets), 0u);
+        totalCount = 0;
+    }
+
+    void TimingStats::update(uint64_t duration) {
         // Update stats
         callCount++;
-        totalTime += d;
-        avgTime = static_cast<double>(totalTime) / callCount;
+        totalTime += duration;
 
         // Update fastest/slowest times
-        if (d > slowestTime) slowestTime = d;
-        if (d < fastestTime) fastestTime = d;
-    }
+        if (duration > slowestTime) slowestTime = duration;
+        if (duration < fastestTime) fastestTime = duration;
 
-    void FunctionStats::outputStats() {
-        outputStats(45);
+        histogram.record(duration);
     }
-    
-    void FunctionStats::outputStats(int nameWidth) {
+
+    void OutputStatsLine(const char *name, int nameWidth, size_t callCount, uint64_t totalTime, uint64_t slowestTime,
+                         uint64_t fastestTime, const LatencyHistogram &histogram) {
+        double totalMs = TicksToMs(totalTime);
+        double avgMs = callCount > 0 ? totalMs / callCount : 0.0;
+        // Bucket midpoints can fall outside the exact extremes we track, clamp them back in
+        auto percentile = [&](double percent) {
+            uint64_t value = histogram.percentile(percent);
+            return TicksToMs(std::min(std::max(value, fastestTime), slowestTime));
+        };
+
         DEBUG_LOG(
                 std::fixed << std::setprecision(3)
                            << "[" << std::left << std::setw(nameWidth) << name << "] "
                            << "Calls: " << std::right << std::setw(8) << callCount
-                           << ", Total: " << std::right << std::setw(8) << totalTime / 1000.0 << " ms"
-                           << ", Avg: " << std::right << std::setw(6) << avgTime / 1000.0 << " ms"
-                           << ", Slowest: " << std::right << std::setw(7) << slowestTime / 1000.0 << " ms"
-                           << ", Fastest: " << std::right << std::setw(6)
-                           << (fastestTime == 999999999LL ? 0 : fastestTime / 1000.0) << " ms"
+                           << ", Total: " << std::right << std::setw(8) << totalMs << " ms"
+                           << ", Avg: " << std::right << std::setw(6) << avgMs << " ms"
+                           << ", Slowest: " << std::right << std::setw(7) << TicksToMs(slowestTime) << " ms"
+                           << ", Fastest: " << std::right << std::setw(6) << TicksToMs(fastestTime) << " ms"
+                           << ", p50: " << std::right << std::setw(6) << percentile(50.0)
+                           << ", p95: " << std::right << std::setw(6) << percentile(95.0)
+                           << ", p99: " << std::right << std::setw(6) << percentile(99.0)
+                           << ", p99.9: " << std::right << std::setw(7) << percentile(99.9)
+                           << " ms"
         );
     }
 
-    void FunctionStats::clearStats() {
-        // Reset all stats after output
+    void OutputSessionStatsLine(const char *name, int nameWidth, const LatencyHistogram &sessionHistogram,
+                                const LatencyHistogram &windowHistogram) {
+        LatencyHistogram session = sessionHistogram;
+        session.merge(windowHistogram);
+        if (session.totalCount == 0) {
+            return;
+        }
+
+        DEBUG_LOG(
+                std::fixed << std::setprecision(3)
+                           << "[" << std::left << std::setw(nameWidth) << name << "] "
+                           << "Calls: " << std::right << std::setw(9) << session.totalCount
+                           << ", p50: " << std::right << std::setw(6) << TicksToMs(session.percentile(50.0))
+                           << ", p95: " << std::right << std::setw(6) << TicksToMs(session.percentile(95.0))
+                           << ", p99: " << std::right << std::setw(7) << TicksToMs(session.percentile(99.0))
+                           << ", p99.9: " << std::right << std::setw(7) << TicksToMs(session.percentile(99.9))
+                           << ", Max: " << std::right << std::setw(8) << TicksToMs(session.percentile(100.0))
+                           << " ms"
+        );
+    }
+
+    void TimingStats::outputStats(const char *name, int nameWidth) const {
+        OutputStatsLine(name, nameWidth, callCount, totalTime, slowestTime, callCount > 0 ? fastestTime : 0,
+                        histogram);
+    }
+
+    void TimingStats::merge(const TimingStats &other) {
+        totalTime += other.totalTime;
+        callCount += other.callCount;
+        slowestTime = std::max(slowestTime, other.slowestTime);
+        fastestTime = std::min(fastestTime, other.fastestTime);
+        histogram.merge(other.histogram);
+    }
+
+    void TimingStats::clear() {
         totalTime = 0;
         callCount = 0;
-        avgTime = 0.0;
         slowestTime = 0;
-        fastestTime = 999999999LL;
+        fastestTime = std::numeric_limits<uint64_t>::max();
+        histogram.clear();
+    }
+
+    void FunctionStats::outputStats() const {
+        outputStats(45);
+    }
+    
+    void FunctionStats::outputStats(int nameWidth) const {
+        outputStats(name.c_str(), nameWidth);
+    }
+
+    void FunctionStats::outputSessionStats(int nameWidth) {
+        OutputSessionStatsLine(name.c_str(), nameWidth, sessionHistogram, histogram);
+    }
+
+    void FunctionStats::clearStats() {
+        // Keep the window's distribution for the session level tail view
+        sessionHistogram.merge(histogram);
+
+        // Reset all stats after output
+        clear();
+    }
+
+    constexpr uint16_t SpellVisualTable::EMPTY;
+
+    SpellVisualTable::SpellVisualTable() : other("Other spells") {
+        std::fill(std::begin(indices), std::end(indices), EMPTY);
+        // Long enough for "Spell ID " and any 32 bit id, claim() never has to grow them
+        for (auto &entry: stats) {
+            entry.name.reserve(24);
+        }
+    }
+
+    FunctionStats &SpellVisualTable::claim(size_t index, uint32_t spellId) {
+        uint16_t slot;
+        if (count < SLOTS) {
+            slot = static_cast<uint16_t>(count++);
+            errors[slot] = 0;
+        } else {
+            slot = evict();
+            // The evicted id's entry may have been the gap this probe stopped at, look again
+            index = homeIndex(spellId);
+            while (indices[index] != EMPTY) {
+                index = (index + 1) & (INDEX_SLOTS - 1);
+            }
+        }
+        indices[index] = slot;
+        spellIds[slot] = spellId;
+
+        char name[24];
+        std::snprintf(name, sizeof(name), "Spell ID %u", spellId);
+        stats[slot].name.assign(name);
+        return stats[slot];
+    }
+
+    uint16_t SpellVisualTable::evict() {
+        // Only reached for a new spell id with every slot taken, scanning them then is cheaper
+        // than keeping the slots ordered on every update
+        size_t slot = 0;
+        uint64_t least = stats[0].totalTime + errors[0];
+        for (size_t i = 1; i < SLOTS; ++i) {
+            uint64_t weight = stats[i].totalTime + errors[i];
+            if (weight < least) {
+                least = weight;
+                slot = i;
+            }
+        }
+
+        other.merge(stats[slot]);
+        stats[slot].clear();
+        errors[slot] = least;
+        unindex(spellIds[slot]);
+        evictionCount++;
+        return static_cast<uint16_t>(slot);
+    }
+
+    void SpellVisualTable::unindex(uint32_t spellId) {
+        size_t hole = homeIndex(spellId);
+        while (spellIds[indices[hole]] != spellId) {
+            hole = (hole + 1) & (INDEX_SLOTS - 1);
+        }
+        // Backward shift: later entries of the same run move into the hole when that doesn't put
+        // them in front of their home index, so no probe ever stops short of them
+        for (size_t index = (hole + 1) & (INDEX_SLOTS - 1); indices[index] != EMPTY;
+             index = (index + 1) & (INDEX_SLOTS - 1)) {
+            size_t home = homeIndex(spellIds[indices[index]]);
+            if (((index - home) & (INDEX_SLOTS - 1)) >= ((index - hole) & (INDEX_SLOTS - 1))) {
+                indices[hole] = indices[index];
+                hole = index;
+            }
+        }
+        indices[hole] = EMPTY;
+    }
+
+    void SpellVisualTable::clear() {
+        for (size_t slot = 0; slot < count; ++slot) {
+            // The next window may give the slot to another spell, so nothing carries over and
+            // there's no session histogram to merge into
+            stats[slot].clear();
+        }
+        other.clearStats();
+        std::fill(std::begin(indices), std::end(indices), EMPTY);
+        count = 0;
+        evictionCount = 0;
+    }
+
+    void MetricTable::merge(const MetricTable &other) {
+        for (int i = 0; i < METRIC_COUNT; ++i) {
+            totals[i] += other.totals[i];
+            counts[i] += other.counts[i];
+            mins[i] = std::min(mins[i], other.mins[i]);
+            maxs[i] = std::max(maxs[i], other.maxs[i]);
+            histograms[i].merge(other.histograms[i]);
+            skipped[i] += other.skipped[i];
+            squares[i] += other.squares[i];
+        }
+    }
+
+    void MetricTable::reset() {
+        // Array by array, the histograms make the table non-trivial so no memset over all of it
+        std::fill(std::begin(totals), std::end(totals), 0u);
+        std::fill(std::begin(counts), std::end(counts), 0u);
+        std::fill(std::begin(mins), std::end(mins), std::numeric_limits<uint64_t>::max());
+        std::fill(std::begin(maxs), std::end(maxs), 0u);
+        for (auto &histogram: histograms) {
+            histogram.clear();
+        }
+        std::fill(std::begin(skipped), std::end(skipped), 0u);
+        std::fill(std::begin(squares), std::end(squares), 0.0);
+    }
+
+    uint64_t MetricTable::estimatedTotal(MetricId id) const {
+        if (skipped[id] == 0 || counts[id] == 0) {
+            return totals[id];
+        }
+        return static_cast<uint64_t>(static_cast<double>(totals[id]) * static_cast<double>(calls(id)) /
+                                     static_cast<double>(counts[id]));
+    }
+
+    double MetricTable::estimatedTotalErrorPercent(MetricId id) const {
+        if (skipped[id] == 0 || counts[id] < 2 || totals[id] == 0) {
+            return 0.0;
+        }
+        // Standard error of the mean of the timed calls, with the finite population correction
+        // since the timed calls are drawn from a known number of calls
+        auto timed = static_cast<double>(counts[id]);
+        double mean = static_cast<double>(totals[id]) / timed;
+        double variance = std::max(0.0, (squares[id] - timed * mean * mean) / (timed - 1));
+        double sampledFraction = timed / static_cast<double>(calls(id));
+        double standardError = std::sqrt(variance / timed * (1.0 - sampledFraction));
+        return 1.96 * standardError / mean * 100.0;
+    }
+
+    void MetricTable::outputStats(MetricId id, int nameWidth) const {
+        OutputStatsLine(kMetricInfo[id].name, nameWidth, static_cast<size_t>(calls(id)), estimatedTotal(id), maxs[id],
+                        counts[id] > 0 ? mins[id] : 0, histograms[id]);
+        if (skipped[id] > 0) {
+            DEBUG_LOG(std::fixed << std::setprecision(1)
+                                 << "    sampled: " << counts[id] << " of " << calls(id) << " calls timed, total +/- "
+                                 << estimatedTotalErrorPercent(id) << "% (95% confidence)");
+        }
+    }
+
+    bool ShouldOutputStats(uint64_t nowMs) {
+        if (gStatsPeriodStartTime == 0) {
+            gStatsPeriodStartTime = nowMs;
+            return false;
+        }
+        return nowMs - gStatsPeriodStartTime >= STATS_OUTPUT_INTERVAL_MS;
+    }
+
+    void StatsWindow::clear() {
+        metrics.reset();
+
+        for (auto &stats: eventStats) {
+            stats.clearStats();
+        }
+        for (auto it = eventCodeStats.begin(); it != eventCodeStats.end(); ++it) {
+            it->clearStats();
+        }
+        spellVisualStats.clear();
+        callTree.clear();
+        overhead = MonitorOverhead();
+        threadCount = 0;
+
+        // Per addon stats and the matrix are dropped wholesale, the arena keeps its chunks for
+        // the next window so the same addons showing up again costs nothing from the heap
+        std::fill(addons, addons + addonCount, nullptr);
+        addonCount = 0;
+        trackedAddonCount = 0;
+        otherAddons = AddonStats();
+        addonEvictions = 0;
+        addonEvents.clear();
+        arena.reset();
+    }
+
+    AddonStats *StatsWindow::addAddon(AddonId id) {
+        AddonStats *stats;
+        if (trackedAddonCount < MAX_WINDOW_ADDONS) {
+            stats = arena.create<AddonStats>();
+            if (stats == nullptr) {
+                overhead.arenaFullDrops++;
+                return nullptr;
+            }
+            trackedAddons[trackedAddonCount++] = id;
+        } else {
+            // Space-Saving like SpellVisualTable, the lightest addon hands its slot over.  A linear
+            // scan, it only runs for addons new to a window that already has MAX_WINDOW_ADDONS.
+            size_t slot = 0;
+            uint64_t least = addons[trackedAddons[0]]->weight();
+            for (size_t i = 1; i < MAX_WINDOW_ADDONS; ++i) {
+                uint64_t weight = addons[trackedAddons[i]]->weight();
+                if (weight < least) {
+                    least = weight;
+                    slot = i;
+                }
+            }
+            stats = addons[trackedAddons[slot]];
+            otherAddons.merge(*stats);
+            addons[trackedAddons[slot]] = nullptr;
+            *stats = AddonStats();
+            stats->error = least;
+            trackedAddons[slot] = id;
+            addonEvictions++;
+        }
+        addons[id] = stats;
+        if (id >= addonCount) {
+            addonCount = static_cast<size_t>(id) + 1;
+        }
+        return stats;
+    }
+
+    // Report a retired window, fold its histograms into the session view and clear it for reuse
+    static void ReportWindow(StatsWindow &window) {
+        OutputStats(window);
+        ExportWindowReport(window);
+        ExportFoldedStacks(window.callTree);
+
+        for (int i = 0; i < METRIC_COUNT; ++i) {
+            gMetricSessionHistograms[i].merge(window.metrics.histograms[i]);
+        }
+        window.clear();
+        gReportArena.reset();
     }
 
-    bool FunctionStats::checkAndOutputStats(uint64_t nowMs) {
-        if (periodStartTime == 0) {
-            periodStartTime = nowMs;
+    static void StatsWorkerThread() {
+        while (true) {
+            StatsWindow *window;
+            {
+                std::unique_lock<std::mutex> lock(gStatsWorkerMutex);
+                gStatsWorkerCondition.wait(lock, [] { return gRetiredWindow != nullptr; });
+                window = gRetiredWindow;
+                gRetiredWindow = nullptr;
+            }
+
+            ReportWindow(*window);
+            gReportInFlight.store(false, std::memory_order_release);
+        }
+    }
+
+    void StartStatsWorker() {
+        if (gStatsWorkerRunning.exchange(true)) {
+            return;
+        }
+        // Never joined, the worker lives as long as the client process
+        std::thread(StatsWorkerThread).detach();
+    }
+
+    bool RetireStatsWindow(uint64_t nowMs) {
+        if (gReportInFlight.load(std::memory_order_acquire)) {
             return false;
         }
-        if (nowMs - periodStartTime >= STATS_OUTPUT_INTERVAL_MS) {
+
+        // Everything the hooks queued for this window has to be in it before anyone looks at it
+        FlushStatRecords();
+
+        StatsWindow &window = ActiveStats();
+        window.epoch = gStatsEpoch.load(std::memory_order_relaxed);
+        window.startTime = gStatsPeriodStartTime;
+        window.endTime = nowMs;
+        window.endWallTime = std::time(nullptr);
+        window.firstFrame = gNextWindowFirstFrame;
+        window.endFrame = GetRecordedFrameCount();
+        gNextWindowFirstFrame = window.endFrame;
+        // The game thread may reload gConfig while the worker reports the window
+        window.config = gConfig;
+
+        // From here on the hooks write into the other window.  Sequentially consistent for the
+        // shard handshake in MergeThreadShards.
+        gStatsEpoch.store(window.epoch + 1);
+        // The other threads' calls count against the budget too, the controller sees them all.
+        // Any sampling or tier change applies from the next window on.
+        MergeThreadShards(window);
+        UpdateOverheadController(window);
+        gStatsPeriodStartTime = nowMs;
+        // Start times of events still in flight belong to the closed window
+        std::fill(std::begin(gEventCodeStartTimes), std::end(gEventCodeStartTimes), 0);
+
+        if (!gStatsWorkerRunning.load(std::memory_order_relaxed)) {
+            ReportWindow(window);
             return true;
         }
-        return false;
-    }
-
-    void OutputStats(uint64_t startTime, uint64_t endTime) {
-        auto callCount = gRenderWorldStats.callCount;
-
-        // Store the totals before clearing the stats
-        double totalCSimpleTopOnLayerUpdate = gCSimpleTopOnLayerUpdateStats.totalTime;
-        double totalCSimpleTopOnLayerRender = gCSimpleTopOnLayerRenderStats.totalTime;
-        double totalPaintScreen = gPaintScreenStats.totalTime;
-
-        double totalOnWorldRender = gOnWorldRenderStats.totalTime;
-        double totalOnWorldUpdate = gOnWorldUpdateStats.totalTime;
-        double totalSpellVisualsRender = gSpellVisualsRenderStats.totalTime;
-        double totalSpellVisualsTick = gSpellVisualsTickStats.totalTime;
-        double totalUnitUpdate = gUnitUpdateStats.totalTime;
-        double totalObjectUpdateHandler = gObjectUpdateHandlerStats.totalTime;
-        double totalPlaySpellVisual = gPlaySpellVisualStats.totalTime;
-        double totalUnknownOnRender1 = gUnknownOnRender1Stats.totalTime;
-        double totalUnknownOnRender2 = gUnknownOnRender2Stats.totalTime;
-        double totalUnknownOnRender3 = gUnknownOnRender3Stats.totalTime;
-        double totalCM2SceneAdvanceTime = gCM2SceneAdvanceTimeStats.totalTime;
-        double totalCM2SceneAnimate = gCM2SceneAnimateStats.totalTime;
-        double totalCM2SceneDraw = gCM2SceneDrawStats.totalTime;
-        double totalDrawBatchProj = gDrawBatchProjStats.totalTime;
-        double totalDrawBatch = gDrawBatchStats.totalTime;
-        double totalDrawBatchDoodad = gDrawBatchDoodadStats.totalTime;
-        double totalDrawRibbon = gDrawRibbonStats.totalTime;
-        double totalDrawParticle = gDrawParticleStats.totalTime;
-        double totalDrawCallback = gDrawCallbackStats.totalTime;
-        double totalCM2SceneRenderDraw = gCM2SceneRenderDrawStats.totalTime;
-        double totalFrameOnLayerUpdate = gFrameOnLayerUpdateStats.totalTime;
-        double totalCWorldRender = gCWorldRenderStats.totalTime;
-        double totalCWorldUpdate = gCWorldUpdateStats.totalTime;
-        double totalCWorldSceneRender = gCWorldSceneRenderStats.totalTime;
-        double totalCWorldUnknownRender = gCWorldUnknownRenderStats.totalTime;
-        double totalTimeBetweenRender = gTimeBetweenRenderStats.totalTime;
-
-        double totalFrameOnScriptEvent = gFrameOnScriptEventStats.totalTime;
-        double totalCSimpleFrameOnFrameRender1 = gCSimpleFrameOnFrameRender1Stats.totalTime;
-        double totalCSimpleFrameOnFrameRender2 = gCSimpleFrameOnFrameRender2Stats.totalTime;
-        double totalCSimpleModelOnFrameRender = gCSimpleModelOnFrameRenderStats.totalTime;
+
+        gReportInFlight.store(true, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(gStatsWorkerMutex);
+            gRetiredWindow = &window;
+        }
+        gStatsWorkerCondition.notify_one();
+        return true;
+    }
+
+    // Formats a "label: xx.xx% (   xx.xx ms)" summary line
+    static std::string FormatSummaryLine(const char *label, double percent, double totalUs) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << label
+           << std::right << std::setw(6) << percent << "% ("
+           << std::right << std::setw(8) << totalUs / 1000.0 << " ms)";
+        return ss.str();
+    }
+
+    struct AddonEventEntry {
+        AddonId addonId;
+        int eventSlot;
+        AddonEventCell cell;
+    };
+
+    static uint64_t SumTotalTime(const ArenaVector<AddonEventEntry> &entries) {
+        uint64_t total = 0;
+        for (const auto &entry: entries) {
+            total += entry.cell.totalTime;
+        }
+        return total;
+    }
+
+    // Keeps the limit slowest entries by total time, slowest first
+    static void KeepSlowest(ArenaVector<AddonEventEntry> &entries, size_t limit) {
+        size_t keep = entries.size() < limit ? entries.size() : limit;
+        std::partial_sort(entries.begin(), entries.begin() + keep, entries.end(),
+                          [](const AddonEventEntry &a, const AddonEventEntry &b) {
+                              return a.cell.totalTime > b.cell.totalTime;
+                          });
+        entries.resize(keep);
+    }
+
+    // Moves the limit largest pairs to the front, largest first, and returns how many that is.
+    // Only the ones shown need an order, the rest of the vector is left unsorted.
+    template<typename Pair>
+    static size_t SelectLargest(ArenaVector<Pair> &entries, size_t limit) {
+        size_t keep = entries.size() < limit ? entries.size() : limit;
+        std::partial_sort(entries.begin(), entries.begin() + keep, entries.end(), std::greater<Pair>());
+        return keep;
+    }
+
+    // Second line for a stat that took over an evicted slot mid window, see SpellVisualTable
+    static void OutputErrorBound(uint64_t error) {
+        if (error > 0) {
+            DEBUG_LOG(std::fixed << std::setprecision(3)
+                                 << "    took over an evicted slot, may be missing up to " << TicksToMs(error)
+                                 << " ms from before that");
+        }
+    }
+
+    template<typename Label>
+    static void OutputAddonEventLine(size_t rank, const Label &label, const AddonEventCell &cell) {
+        DEBUG_LOG("  " << std::right << std::setw(2) << (rank + 1) << ".  "
+                       << std::left << std::setw(50) << label
+                       << " Total Duration: " << std::right << std::setw(8) << std::fixed
+                       << std::setprecision(3)
+                       << TicksToMs(cell.totalTime) << " ms"
+                       << "      Count: " << std::right << std::setw(6) << cell.count
+                       << "      Max: " << std::right << std::setw(7) << TicksToMs(cell.maxTime) << " ms");
+    }
+
+    // Writes node and its children, slowest first, indented by depth
+    static void OutputCallTreeNode(const CallTreeWindow &tree, CallTreeNodeId node, int depth, uint64_t windowTicks,
+                                   uint64_t minTicks) {
+        const CallTreeNodeStats &stats = tree.nodes[node];
+        auto percentOfWindow = [&](uint64_t ticks) {
+            return windowTicks > 0 ? static_cast<double>(ticks) * 100.0 / static_cast<double>(windowTicks) : 0.0;
+        };
+
+        DEBUG_LOG(std::fixed << std::setprecision(2)
+                             << std::left << std::setw(50)
+                             << (std::string(static_cast<size_t>(depth) * 2, ' ') + GetCallFrameName(GetCallTreeNodeKey(node)))
+                             << " Incl: " << std::right << std::setw(9) << TicksToMs(stats.inclusiveTime) << " ms ("
+                             << std::right << std::setw(5) << percentOfWindow(stats.inclusiveTime) << "%)"
+                             << "  Self: " << std::right << std::setw(9) << TicksToMs(stats.selfTime) << " ms ("
+                             << std::right << std::setw(5) << percentOfWindow(stats.selfTime) << "%)"
+                             << "  Calls: " << std::right << std::setw(8) << stats.count);
+
+        ArenaVector<std::pair<uint64_t, CallTreeNodeId>> children(gReportArena);
+        for (CallTreeNodeId child = GetCallTreeFirstChild(node);
+             child != CALL_TREE_ROOT; child = GetCallTreeNextSibling(child)) {
+            if (tree.nodes[child].inclusiveTime >= minTicks) {
+                children.emplace_back(tree.nodes[child].inclusiveTime, child);
+            }
+        }
+        std::sort(children.rbegin(), children.rend());
+        for (const auto &child: children) {
+            OutputCallTreeNode(tree, child.second, depth + 1, windowTicks, minTicks);
+        }
+    }
+
+    // Mean frame time of the slowest fraction of frames as fps, frameTimes sorted ascending
+    static double LowFps(const ArenaVector<uint64_t> &frameTimes, double fraction) {
+        size_t count = static_cast<size_t>(static_cast<double>(frameTimes.size()) * fraction);
+        if (count == 0) {
+            count = 1;
+        }
+        uint64_t total = 0;
+        for (size_t i = frameTimes.size() - count; i < frameTimes.size(); ++i) {
+            total += frameTimes[i];
+        }
+        double meanMs = TicksToMs(total) / static_cast<double>(count);
+        return meanMs > 0 ? 1000.0 / meanMs : 0.0;
+    }
+
+    static void OutputFrameTimes(const StatsWindow &window) {
+        ArenaVector<FrameRecord> frames(gReportArena);
+        CopyFrames(window.firstFrame, window.endFrame, frames);
+
+        ArenaVector<uint64_t> frameTimes(gReportArena);
+        frameTimes.reserve(frames.size());
+        uint64_t splitTotals[FRAME_SPLIT_COUNT] = {};
+        const FrameRecord *slowest = nullptr;
+        for (const auto &frame: frames) {
+            if (frame.frameTime == 0) {
+                continue;
+            }
+            frameTimes.push_back(frame.frameTime);
+            for (int i = 0; i < FRAME_SPLIT_COUNT; ++i) {
+                splitTotals[i] += frame.splits[i];
+            }
+            if (slowest == nullptr || frame.frameTime > slowest->frameTime) {
+                slowest = &frame;
+            }
+        }
+
+        DEBUG_LOG("--- FRAME TIMES ---");
+        if (frameTimes.empty()) {
+            DEBUG_LOG("No frames recorded");
+            return;
+        }
+
+        std::sort(frameTimes.begin(), frameTimes.end());
+        auto percentile = [&](double percent) {
+            size_t rank = static_cast<size_t>(percent / 100.0 * static_cast<double>(frameTimes.size() - 1) + 0.5);
+            return TicksToMs(frameTimes[rank]);
+        };
+
+        double medianMs = percentile(50.0);
+        size_t stutters = 0;
+        size_t longFrames = 0;
+        for (uint64_t frameTime: frameTimes) {
+            double ms = TicksToMs(frameTime);
+            if (ms > medianMs * STUTTER_MEDIAN_MULTIPLE) {
+                stutters++;
+            }
+            if (ms > LONG_FRAME_MS) {
+                longFrames++;
+            }
+        }
+
+        DEBUG_LOG(std::fixed << std::setprecision(2)
+                             << "Frames: " << frameTimes.size()
+                             << "  p50: " << medianMs << " ms"
+                             << "  p90: " << percentile(90.0) << " ms"
+                             << "  p99: " << percentile(99.0) << " ms"
+                             << "  Max: " << TicksToMs(frameTimes.back()) << " ms");
+        DEBUG_LOG(std::fixed << std::setprecision(1)
+                             << "1% low: " << LowFps(frameTimes, 0.01) << " fps"
+                             << "  0.1% low: " << LowFps(frameTimes, 0.001) << " fps"
+                             << "  Stutters (>" << STUTTER_MEDIAN_MULTIPLE << "x median): " << stutters
+                             << "  Long frames (>" << LONG_FRAME_MS << " ms): " << longFrames);
+
+        std::ostringstream average, slowestSplit;
+        average << std::fixed << std::setprecision(2);
+        slowestSplit << std::fixed << std::setprecision(2);
+        for (int i = 0; i < FRAME_SPLIT_COUNT; ++i) {
+            average << "  " << kFrameSplitNames[i] << ": "
+                    << TicksToMs(splitTotals[i]) / static_cast<double>(frameTimes.size()) << " ms";
+            slowestSplit << "  " << kFrameSplitNames[i] << ": " << TicksToMs(slowest->splits[i]) << " ms";
+        }
+        DEBUG_LOG("Avg per frame (self time):" << average.str());
+        DEBUG_LOG(std::fixed << std::setprecision(2)
+                             << "Slowest frame (" << TicksToMs(slowest->frameTime) << " ms, PaintScreen "
+                             << TicksToMs(slowest->paintScreen) << " ms):" << slowestSplit.str());
+    }
+
+    // Metrics with calls from threads other than the game thread, split per thread
+    static void OutputThreadSplit(const StatsWindow &window) {
+        bool header = false;
+        for (int i = 0; i < METRIC_COUNT; ++i) {
+            uint64_t offThreadCalls = 0;
+            uint64_t offThreadTotal = 0;
+            uint64_t allTotal = window.threads[0].totals[i];
+            for (size_t t = 1; t < window.threadCount; ++t) {
+                offThreadCalls += window.threads[t].calls[i];
+                offThreadTotal += window.threads[t].totals[i];
+                allTotal += window.threads[t].totals[i];
+            }
+            if (offThreadCalls == 0) {
+                continue;
+            }
+            if (!header) {
+                DEBUG_LOG("--- THREADS (hooks called off the game thread) ---");
+                header = true;
+            }
+
+            std::stringstream line;
+            line << std::fixed << std::setprecision(2) << "[" << std::left << std::setw(45) << kMetricInfo[i].name
+                 << "] Off the game thread: " << std::right << std::setw(6)
+                 << (allTotal > 0 ? static_cast<double>(offThreadTotal) / allTotal * 100.0 : 0.0) << "% of the time.";
+            for (size_t t = 0; t < window.threadCount; ++t) {
+                const ThreadMetricTotals &thread = window.threads[t];
+                if (thread.calls[i] == 0) {
+                    continue;
+                }
+                if (t == 0) {
+                    line << "  Game thread";
+                } else if (thread.threadId == SHARED_SHARD_THREAD_ID) {
+                    line << "  Other threads";
+                } else {
+                    line << "  Thread " << thread.threadId;
+                }
+                line << ": " << thread.calls[i] << " calls, " << TicksToMs(thread.totals[i]) << " ms";
+            }
+            DEBUG_LOG(line.str());
+        }
+        if (header) {
+            NEWLINE_LOG();
+        }
+    }
+
+    void OutputStats(StatsWindow &window) {
+        const MetricTable &metrics = window.metrics;
+        auto callCount = metrics.counts[METRIC_RENDER_WORLD];
+
+        // Totals in microseconds
+        double totalPaintScreen = TicksToUs(metrics.totals[METRIC_PAINT_SCREEN]);
+        double totalObjectUpdateHandler = TicksToUs(metrics.totals[METRIC_OBJECT_UPDATE_HANDLER]);
 
         // Get the total time for evt_Paint and evt_Idle
-        double totalEvtPaint = gEventStats[EVENT_ID_PAINT].totalTime;
-        double totalEvtIdle = gEventStats[EVENT_ID_IDLE].totalTime;
-        double totalEvtInit = gEventStats[EVENT_ID_INITIALIZE].totalTime;
-        double totalEvtPoll = gEventStats[EVENT_ID_POLL].totalTime;
-
-        // Calculate percentages of frame time using cumulative times
-        double onWorldRenderPercent = (totalPaintScreen > 0) ?
-                                      (totalOnWorldRender / totalPaintScreen) * 100.0 : 0.0;
-        double onWorldUpdatePercent = (totalPaintScreen > 0) ?
-                                      (totalOnWorldUpdate / totalPaintScreen) * 100.0 : 0.0;
-        double spellVisualsRenderPercent = (totalPaintScreen > 0) ?
-                                           (totalSpellVisualsRender / totalPaintScreen) * 100.0 : 0.0;
-        double spellVisualsTickPercent = (totalPaintScreen > 0) ?
-                                         (totalSpellVisualsTick / totalPaintScreen) * 100.0 : 0.0;
-        double unitUpdatePercent = (totalPaintScreen > 0) ?
-                                   (totalUnitUpdate / totalPaintScreen) * 100.0 : 0.0;
+        double totalEvtPaint = TicksToUs(window.eventStats[EVENT_ID_PAINT].totalTime);
+        double totalEvtIdle = TicksToUs(window.eventStats[EVENT_ID_IDLE].totalTime);
+        double totalEvtPoll = TicksToUs(window.eventStats[EVENT_ID_POLL].totalTime);
+
+        const uint64_t oneMsTicks = UsToTicks(1000.0);
+
         double objectUpdateHandlerPercent = (totalEvtPoll > 0) ?
                                             (totalObjectUpdateHandler / totalEvtPoll) * 100.0 : 0.0;
-        double playSpellVisualPercent = (totalPaintScreen > 0) ?
-                                        (totalPlaySpellVisual / totalPaintScreen) * 100.0 : 0.0;
-        double unknownOnRender1Percent = (totalPaintScreen > 0) ?
-                                         (totalUnknownOnRender1 / totalPaintScreen) * 100.0 : 0.0;
-        double unknownOnRender2Percent = (totalPaintScreen > 0) ?
-                                         (totalUnknownOnRender2 / totalPaintScreen) * 100.0 : 0.0;
-        double unknownOnRender3Percent = (totalPaintScreen > 0) ?
-                                         (totalUnknownOnRender3 / totalPaintScreen) * 100.0 : 0.0;
-        double cM2SceneAdvanceTimePercent = (totalPaintScreen > 0) ?
-                                            (totalCM2SceneAdvanceTime / totalPaintScreen) * 100.0 : 0.0;
-        double cM2SceneAnimatePercent = (totalPaintScreen > 0) ?
-                                        (totalCM2SceneAnimate / totalPaintScreen) * 100.0 : 0.0;
-        double cM2SceneDrawPercent = (totalPaintScreen > 0) ?
-                                     (totalCM2SceneDraw / totalPaintScreen) * 100.0 : 0.0;
-        double drawBatchProjPercent = (totalPaintScreen > 0) ?
-                                      (totalDrawBatchProj / totalPaintScreen) * 100.0 : 0.0;
-        double drawBatchPercent = (totalPaintScreen > 0) ?
-                                  (totalDrawBatch / totalPaintScreen) * 100.0 : 0.0;
-        double drawBatchDoodadPercent = (totalPaintScreen > 0) ?
-                                        (totalDrawBatchDoodad / totalPaintScreen) * 100.0 : 0.0;
-        double drawRibbonPercent = (totalPaintScreen > 0) ?
-                                   (totalDrawRibbon / totalPaintScreen) * 100.0 : 0.0;
-        double drawCallbackPercent = (totalPaintScreen > 0) ?
-                                     (totalDrawCallback / totalPaintScreen) * 100.0 : 0.0;
-        double cM2SceneRenderDrawPercent = (totalPaintScreen > 0) ?
-                                           (totalCM2SceneRenderDraw / totalPaintScreen) * 100.0 : 0.0;
-        double frameOnLayerUpdatePercent = (totalPaintScreen > 0) ?
-                                           (totalFrameOnLayerUpdate / totalPaintScreen) * 100.0 : 0.0;
-        double cWorldRenderPercent = (totalPaintScreen > 0) ?
-                                     (totalCWorldRender / totalPaintScreen) * 100.0 : 0.0;
-        double cWorldUpdatePercent = (totalPaintScreen > 0) ?
-                                     (totalCWorldUpdate / totalPaintScreen) * 100.0 : 0.0;
-        double cWorldSceneRenderPercent = (totalPaintScreen > 0) ?
-                                          (totalCWorldSceneRender / totalPaintScreen) * 100.0 : 0.0;
-        double cWorldUnknownRenderPercent = (totalPaintScreen > 0) ?
-                                            (totalCWorldUnknownRender / totalPaintScreen) * 100.0 : 0.0;
-        double timeBetweenRenderPercent = (totalPaintScreen > 0) ?
-                                          (totalTimeBetweenRender / totalPaintScreen) * 100.0 : 0.0;
-        double frameOnScriptEventPercent = (totalPaintScreen > 0) ?
-                                           (totalFrameOnScriptEvent / totalPaintScreen) * 100.0 : 0.0;
-
-        // Convert microseconds to milliseconds for display
-        double totalOnWorldRenderMs = totalOnWorldRender / 1000.0;
-        double totalOnWorldUpdateMs = totalOnWorldUpdate / 1000.0;
-        double totalCWorldRenderMs = totalCWorldRender / 1000.0;
-        double totalCWorldUpdateMs = totalCWorldUpdate / 1000.0;
-        double totalCWorldSceneRenderMs = totalCWorldSceneRender / 1000.0;
-        double totalCWorldUnknownRenderMs = totalCWorldUnknownRender / 1000.0;
-        double totalTimeBetweenRenderMs = totalTimeBetweenRender / 1000.0;
-        double totalSpellVisualsRenderMs = totalSpellVisualsRender / 1000.0;
-        double totalSpellVisualsTickMs = totalSpellVisualsTick / 1000.0;
-        double totalUnitUpdateMs = totalUnitUpdate / 1000.0;
-        double totalObjectUpdateHandlerMs = totalObjectUpdateHandler / 1000.0;
-        double totalPlaySpellVisualMs = totalPlaySpellVisual / 1000.0;
-        double totalUnknownOnRender1Ms = totalUnknownOnRender1 / 1000.0;
-        double totalUnknownOnRender2Ms = totalUnknownOnRender2 / 1000.0;
-        double totalUnknownOnRender3Ms = totalUnknownOnRender3 / 1000.0;
-        double totalCM2SceneAdvanceTimeMs = totalCM2SceneAdvanceTime / 1000.0;
-        double totalCM2SceneAnimateMs = totalCM2SceneAnimate / 1000.0;
-        double totalCM2SceneDrawMs = totalCM2SceneDraw / 1000.0;
-        double totalDrawBatchProjMs = totalDrawBatchProj / 1000.0;
-        double totalDrawBatchMs = totalDrawBatch / 1000.0;
-        double totalDrawBatchDoodadMs = totalDrawBatchDoodad / 1000.0;
-        double totalDrawRibbonMs = totalDrawRibbon / 1000.0;
-        double totalDrawParticleMs = totalDrawParticle / 1000.0;
-        double totalDrawCallbackMs = totalDrawCallback / 1000.0;
-        double totalCM2SceneRenderDrawMs = totalCM2SceneRenderDraw / 1000.0;
-        double totalFrameOnLayerUpdateMs = totalFrameOnLayerUpdate / 1000.0;
-        double totalFrameOnScriptEventMs = totalFrameOnScriptEvent / 1000.0;
-        double totalEvtPaintMs = totalEvtPaint / 1000.0;
-        double totalEvtIdleMs = totalEvtIdle / 1000.0;
-        double totalCSimpleTopOnLayerUpdateMs = totalCSimpleTopOnLayerUpdate / 1000.0;
-        double totalCSimpleTopOnLayerRenderMs = totalCSimpleTopOnLayerRender / 1000.0;
-        double totalCSimpleFrameOnFrameRender1Ms = totalCSimpleFrameOnFrameRender1 / 1000.0;
-        double totalCSimpleFrameOnFrameRender2Ms = totalCSimpleFrameOnFrameRender2 / 1000.0;
-        double totalCSimpleModelOnFrameRenderMs = totalCSimpleModelOnFrameRender / 1000.0;
+
+        // Percentage of total render for a metric
+        auto renderPercent = [&](MetricId id) {
+            return (totalPaintScreen > 0) ? (TicksToUs(metrics.estimatedTotal(id)) / totalPaintScreen) * 100.0 : 0.0;
+        };
 
         // --- SUMMARY ---
         DEBUG_LOG(
                 "--------------------------------------------------------------------------------------------------------------------------------------");
-        // Calculate start time by subtracting 30 seconds from current time
-        auto now = std::chrono::system_clock::now();
-        auto thirtySecondsAgo = now - std::chrono::seconds(30);
-        std::time_t start_time_t = std::chrono::system_clock::to_time_t(thirtySecondsAgo);
-        std::time_t end_time_t = std::chrono::system_clock::to_time_t(now);
+        // Window bounds were captured when the window was retired, not when the report runs
+        double windowSeconds = (window.endTime - window.startTime) / 1000.0;
+        std::time_t end_time_t = window.endWallTime;
+        std::time_t start_time_t = end_time_t - static_cast<std::time_t>(windowSeconds + 0.5);
 
         std::tm start_tm, end_tm;
 #ifdef _WIN32
@@ -267,7 +759,7 @@ namespace perf_monitor {
             ss.str("");
             ss << std::fixed << std::setprecision(2) << std::left << std::setw(45) << "  ObjectUpdateHandler:"
                << std::right << std::setw(6) << objectUpdateHandlerPercent << "% ("
-               << std::right << std::setw(8) << totalObjectUpdateHandlerMs << " ms)";
+               << std::right << std::setw(8) << totalObjectUpdateHandler / 1000.0 << " ms)";
             DEBUG_LOG(ss.str());
         }
         {
@@ -287,196 +779,69 @@ namespace perf_monitor {
 
         // Convert PaintScreen to milliseconds
         double totalPaintScreenMs = totalPaintScreen / 1000.0;
+        auto paintScreenCount = metrics.counts[METRIC_PAINT_SCREEN];
 
         DEBUG_LOG(
                 std::fixed << std::setprecision(2)
                            << "[Total] Render: " << std::right << std::setw(8) << totalPaintScreenMs
-                           << " ms.  Frames: " << std::right << std::setw(6) << gPaintScreenStats.callCount
+                           << " ms.  Frames: " << std::right << std::setw(6) << paintScreenCount
                            << ".  Time per frame: " << std::right << std::setw(6)
-                           << (gPaintScreenStats.callCount > 0 ? totalPaintScreenMs /
-                                                                 gPaintScreenStats.callCount
-                                                               : 0.0)
+                           << (paintScreenCount > 0 ? totalPaintScreenMs / paintScreenCount : 0.0)
                            << " ms.  Avg fps: "
                            << std::right << std::setw(6)
-                           << (callCount > 0 ? callCount / (STATS_OUTPUT_INTERVAL_MS / 1000.0) : 0.0));
+                           << (callCount > 0 && windowSeconds > 0 ? callCount / windowSeconds : 0.0));
+        OutputMonitorOverhead(window);
 
         {
             DEBUG_LOG("--- FUNCTION STATS (% OF TOTAL RENDER) ---");
 
-            std::vector<std::pair<double, std::string>> allStats;
-            std::stringstream ss;
-
-            // OnWorldRender group - show parent then sorted sub-functions
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "OnWorldRender:"
-               << std::right << std::setw(6) << onWorldRenderPercent << "% ("
-               << std::right << std::setw(8) << totalOnWorldRenderMs << " ms)";
-            DEBUG_LOG(ss.str());
-
-            // OnWorldRender sub-functions sorted by performance
-            std::vector<std::pair<double, std::string>> renderStats;
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  UnknownOnRender1:"
-               << std::right << std::setw(6) << unknownOnRender1Percent << "% ("
-               << std::right << std::setw(8) << totalUnknownOnRender1Ms << " ms)";
-            renderStats.emplace_back(unknownOnRender1Percent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  UnknownOnRender2:"
-               << std::right << std::setw(6) << unknownOnRender2Percent << "% ("
-               << std::right << std::setw(8) << totalUnknownOnRender2Ms << " ms)";
-            renderStats.emplace_back(unknownOnRender2Percent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  UnknownOnRender3:"
-               << std::right << std::setw(6) << unknownOnRender3Percent << "% ("
-               << std::right << std::setw(8) << totalUnknownOnRender3Ms << " ms)";
-            renderStats.emplace_back(unknownOnRender3Percent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  CM2Scene::AdvanceTime:"
-               << std::right << std::setw(6) << cM2SceneAdvanceTimePercent << "% ("
-               << std::right << std::setw(8) << totalCM2SceneAdvanceTimeMs << " ms)";
-            renderStats.emplace_back(cM2SceneAdvanceTimePercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  CWorldSceneRender:"
-               << std::right << std::setw(6) << cWorldSceneRenderPercent << "% ("
-               << std::right << std::setw(8) << totalCWorldSceneRenderMs << " ms)";
-            renderStats.emplace_back(cWorldSceneRenderPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  CWorldRender:"
-               << std::right << std::setw(6) << cWorldRenderPercent << "% ("
-               << std::right << std::setw(8) << totalCWorldRenderMs << " ms)";
-            renderStats.emplace_back(cWorldRenderPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  CM2Scene::Animate:"
-               << std::right << std::setw(6) << cM2SceneAnimatePercent << "% ("
-               << std::right << std::setw(8) << totalCM2SceneAnimateMs << " ms)";
-            renderStats.emplace_back(cM2SceneAnimatePercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  CM2Scene::Draw:"
-               << std::right << std::setw(6) << cM2SceneDrawPercent << "% ("
-               << std::right << std::setw(8) << totalCM2SceneDrawMs << " ms)";
-            renderStats.emplace_back(cM2SceneDrawPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  DrawBatchProj:"
-               << std::right << std::setw(6) << drawBatchProjPercent << "% ("
-               << std::right << std::setw(8) << totalDrawBatchProjMs << " ms)";
-            renderStats.emplace_back(drawBatchProjPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  DrawBatch:"
-               << std::right << std::setw(6) << drawBatchPercent << "% ("
-               << std::right << std::setw(8) << totalDrawBatchMs << " ms)";
-            renderStats.emplace_back(drawBatchPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  DrawBatchDoodad:"
-               << std::right << std::setw(6) << drawBatchDoodadPercent << "% ("
-               << std::right << std::setw(8) << totalDrawBatchDoodadMs << " ms)";
-            renderStats.emplace_back(drawBatchDoodadPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  DrawRibbon:"
-               << std::right << std::setw(6) << drawRibbonPercent << "% ("
-               << std::right << std::setw(8) << totalDrawRibbonMs << " ms)";
-            renderStats.emplace_back(drawRibbonPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  DrawCallback:"
-               << std::right << std::setw(6) << drawCallbackPercent << "% ("
-               << std::right << std::setw(8) << totalDrawCallbackMs << " ms)";
-            renderStats.emplace_back(drawCallbackPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  CM2SceneRender::Draw:"
-               << std::right << std::setw(6) << cM2SceneRenderDrawPercent << "% ("
-               << std::right << std::setw(8) << totalCM2SceneRenderDrawMs << " ms)";
-            renderStats.emplace_back(cM2SceneRenderDrawPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  SpellVisualsTick:"
-               << std::right << std::setw(6) << spellVisualsTickPercent << "% ("
-               << std::right << std::setw(8) << totalSpellVisualsTickMs << " ms)";
-            renderStats.emplace_back(spellVisualsTickPercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  SpellVisualsRender:"
-               << std::right << std::setw(6) << spellVisualsRenderPercent << "% ("
-               << std::right << std::setw(8) << totalSpellVisualsRenderMs << " ms)";
-            renderStats.emplace_back(spellVisualsRenderPercent, ss.str());
-
-            // Sort and display OnWorldRender sub-functions
-            std::sort(renderStats.rbegin(), renderStats.rend());
-            for (const auto &stat: renderStats) {
-                DEBUG_LOG(stat.second);
+            bool hasChildren[METRIC_COUNT] = {};
+            for (int i = 0; i < METRIC_COUNT; ++i) {
+                if (kMetricInfo[i].summaryName != nullptr && kMetricInfo[i].parent != METRIC_NONE) {
+                    hasChildren[kMetricInfo[i].parent] = true;
+                }
             }
 
-            // OnWorldUpdate group - show parent then sorted sub-functions
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "OnWorldUpdate:"
-               << std::right << std::setw(6) << onWorldUpdatePercent << "% ("
-               << std::right << std::setw(8) << totalOnWorldUpdateMs << " ms)";
-            DEBUG_LOG(ss.str());
-
-            // OnWorldUpdate sub-functions sorted by performance
-            std::vector<std::pair<double, std::string>> updateStats;
+            // Groups first - show parent then sorted sub-functions
+            for (int parent = 0; parent < METRIC_COUNT; ++parent) {
+                if (!hasChildren[parent] || kMetricInfo[parent].summaryName == nullptr) {
+                    continue;
+                }
+                auto parentId = static_cast<MetricId>(parent);
+                DEBUG_LOG(FormatSummaryLine(kMetricInfo[parent].summaryName, renderPercent(parentId),
+                                            TicksToUs(metrics.estimatedTotal(parentId))));
 
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  CWorldUpdate:"
-               << std::right << std::setw(6) << cWorldUpdatePercent << "% ("
-               << std::right << std::setw(8) << totalCWorldUpdateMs << " ms)";
-            updateStats.emplace_back(cWorldUpdatePercent, ss.str());
+                std::vector<std::pair<double, std::string>> childStats;
+                for (int i = 0; i < METRIC_COUNT; ++i) {
+                    if (kMetricInfo[i].parent != parentId || kMetricInfo[i].summaryName == nullptr) {
+                        continue;
+                    }
+                    auto id = static_cast<MetricId>(i);
+                    childStats.emplace_back(renderPercent(id),
+                                            FormatSummaryLine((std::string("  ") + kMetricInfo[i].summaryName).c_str(),
+                                                              renderPercent(id),
+                                                              TicksToUs(metrics.estimatedTotal(id))));
+                }
 
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "  UnitUpdate:"
-               << std::right << std::setw(6) << unitUpdatePercent << "% ("
-               << std::right << std::setw(8) << totalUnitUpdateMs << " ms)";
-            updateStats.emplace_back(unitUpdatePercent, ss.str());
-
-            // Sort and display OnWorldUpdate sub-functions
-            std::sort(updateStats.rbegin(), updateStats.rend());
-            for (const auto &stat: updateStats) {
-                DEBUG_LOG(stat.second);
+                std::sort(childStats.rbegin(), childStats.rend());
+                for (const auto &stat: childStats) {
+                    DEBUG_LOG(stat.second);
+                }
             }
 
             DEBUG_LOG("------");
 
             // Now add remaining stats to be sorted at top level
-            allStats.clear();
-
-//            ss.str("");
-//            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "PlaySpellVisual:"
-//               << std::right << std::setw(6) << playSpellVisualPercent << "% ("
-//               << std::right << std::setw(8) << totalPlaySpellVisualMs << " ms)";
-//            allStats.emplace_back(playSpellVisualPercent, ss.str());
-
-            // Frame stats
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "All OnUpdates:"
-               << std::right << std::setw(6) << frameOnLayerUpdatePercent << "% ("
-               << std::right << std::setw(8) << totalFrameOnLayerUpdateMs << " ms)";
-            allStats.emplace_back(frameOnLayerUpdatePercent, ss.str());
-
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "All Events:"
-               << std::right << std::setw(6) << frameOnScriptEventPercent << "% ("
-               << std::right << std::setw(8) << totalFrameOnScriptEventMs << " ms)";
-            allStats.emplace_back(frameOnScriptEventPercent, ss.str());
-
-            double cSimpleTopOnLayerUpdatePercent = (totalPaintScreen > 0 ? (totalCSimpleTopOnLayerUpdate /
-                                                                             totalPaintScreen * 100.0) : 0.0);
-            ss.str("");
-            ss << std::fixed << std::setprecision(2) << std::left << std::setw(25) << "UIParent OnUpdate:"
-               << std::right << std::setw(6) << cSimpleTopOnLayerUpdatePercent << "% ("
-               << std::right << std::setw(8) << totalCSimpleTopOnLayerUpdateMs << " ms)";
-            allStats.emplace_back(cSimpleTopOnLayerUpdatePercent, ss.str());
+            std::vector<std::pair<double, std::string>> allStats;
+            for (int i = 0; i < METRIC_COUNT; ++i) {
+                if (kMetricInfo[i].summaryName == nullptr || kMetricInfo[i].parent != METRIC_NONE || hasChildren[i]) {
+                    continue;
+                }
+                auto id = static_cast<MetricId>(i);
+                allStats.emplace_back(renderPercent(id),
+                                      FormatSummaryLine(kMetricInfo[i].summaryName, renderPercent(id),
+                                                        TicksToUs(metrics.estimatedTotal(id))));
+            }
 
             std::sort(allStats.rbegin(), allStats.rend());
 
@@ -486,290 +851,256 @@ namespace perf_monitor {
         }
         NEWLINE_LOG();
 
-        // --- DETAILED STATS ---
-        DEBUG_LOG("--- DETAILED STATS ---");
-        gPaintScreenStats.outputStats();
-        gCSimpleTopOnLayerRenderStats.outputStats();
-        gCSimpleTopOnLayerUpdateStats.outputStats();
-        NEWLINE_LOG();
-        gOnWorldRenderStats.outputStats();
-        gUnknownOnRender1Stats.outputStats();
-        gUnknownOnRender2Stats.outputStats();
-        gUnknownOnRender3Stats.outputStats();
-        gCM2SceneAdvanceTimeStats.outputStats();
-        gCM2SceneAnimateStats.outputStats();
-        gCM2ModelAnimateMTStats.outputStats();
-        gCM2SceneDrawStats.outputStats();
-        gDrawBatchProjStats.outputStats();
-        gDrawBatchStats.outputStats();
-        gDrawBatchDoodadStats.outputStats();
-        gDrawRibbonStats.outputStats();
-        gDrawParticleStats.outputStats();
-        gDrawCallbackStats.outputStats();
-        gCM2SceneRenderDrawStats.outputStats();
-        gCWorldSceneRenderStats.outputStats();
+        // --- CALL TREE ---
+        {
+            // Built from hook nesting, so unlike the summary above nested hooks are never counted twice
+            DEBUG_LOG("--- CALL TREE (inclusive / self time, % of window, min 0.1ms inclusive) ---");
+            uint64_t windowTicks = UsToTicks(static_cast<double>(window.endTime - window.startTime) * 1000.0);
+            uint64_t minTicks = UsToTicks(100.0);
+
+            ArenaVector<std::pair<uint64_t, CallTreeNodeId>> roots(gReportArena);
+            for (CallTreeNodeId node = GetCallTreeFirstChild(CALL_TREE_ROOT);
+                 node != CALL_TREE_ROOT; node = GetCallTreeNextSibling(node)) {
+                if (window.callTree.nodes[node].inclusiveTime >= minTicks) {
+                    roots.emplace_back(window.callTree.nodes[node].inclusiveTime, node);
+                }
+            }
+            std::sort(roots.rbegin(), roots.rend());
+            for (const auto &root: roots) {
+                OutputCallTreeNode(window.callTree, root.second, 0, windowTicks, minTicks);
+            }
+        }
         NEWLINE_LOG();
-        gOnWorldUpdateStats.outputStats();
-        gUnitUpdateStats.outputStats();
-        gCWorldUpdateStats.outputStats();
 
+        // --- FRAME TIMES ---
+        OutputFrameTimes(window);
         NEWLINE_LOG();
-        gObjectUpdateHandlerStats.outputStats();
-//        gPlaySpellVisualStats.outputStats();
-        gFrameOnScriptEventStats.outputStats();
-        gFrameOnLayerUpdateStats.outputStats();
+
+        // --- DETAILED STATS ---
+        DEBUG_LOG("--- DETAILED STATS ---");
+        for (int i = 0; i < METRIC_COUNT; ++i) {
+            if (kMetricInfo[i].group == METRIC_GROUP_HIDDEN) {
+                continue;
+            }
+            if (i > 0 && kMetricInfo[i].group != kMetricInfo[i - 1].group) {
+                NEWLINE_LOG();
+            }
+            metrics.outputStats(static_cast<MetricId>(i));
+        }
+
         NEWLINE_LOG();
 
-        gLuaCCollectgarbageStats.outputStats();
-        gObjectFreeStats.outputStats();
+        // --- THREADS ---
+        OutputThreadSplit(window);
+
+        // --- SESSION TAIL LATENCY ---
+        DEBUG_LOG("--- SESSION TAIL LATENCY (all windows so far) ---");
+        for (int i = 0; i < METRIC_COUNT; ++i) {
+            if (kMetricInfo[i].group == METRIC_GROUP_HIDDEN) {
+                continue;
+            }
+            OutputSessionStatsLine(kMetricInfo[i].name, 45, gMetricSessionHistograms[i], metrics.histograms[i]);
+        }
 
         NEWLINE_LOG();
 
+        const size_t addonCount = window.addonCount;
+        char label[ADDON_LABEL_SIZE];
+
         // --- ADDON ONUPDATE PERFORMANCE ---
-        if (!gAddonOnUpdateStats.empty()) {
+        if (addonCount > 0) {
             DEBUG_LOG("--- ADDON/FRAME ONUPDATE PERFORMANCE (min 1ms total)---");
 
             // Sort addons by total time
-            std::vector<std::pair<double, std::string>> addonOnUpdateStats;
-            for (auto it = gAddonOnUpdateStats.begin();
-                 it != gAddonOnUpdateStats.end(); ++it) {
-                if (it->second.callCount > 0 && it->second.totalTime >= 1000.0) {
-                    addonOnUpdateStats.push_back(std::make_pair(it->second.totalTime, it->first));
+            ArenaVector<std::pair<uint64_t, AddonId>> addonOnUpdateStats(gReportArena);
+            for (size_t id = 0; id < addonCount; ++id) {
+                const AddonStats *addon = window.addons[id];
+                if (addon != nullptr && addon->onUpdate.callCount > 0 && addon->onUpdate.totalTime >= oneMsTicks) {
+                    addonOnUpdateStats.push_back(std::make_pair(addon->onUpdate.totalTime, static_cast<AddonId>(id)));
                 }
             }
             std::sort(addonOnUpdateStats.rbegin(), addonOnUpdateStats.rend());
 
             for (auto it = addonOnUpdateStats.begin();
                  it != addonOnUpdateStats.end(); ++it) {
-                gAddonOnUpdateStats[it->second].outputStats();
+                window.addons[it->second]->onUpdate.outputStats(AddonLabel(label, it->second, " OnUpdate"));
+                OutputErrorBound(window.addons[it->second]->error);
+            }
+            if (window.otherAddons.onUpdate.totalTime >= oneMsTicks) {
+                window.otherAddons.onUpdate.outputStats("Other addons/frames OnUpdate");
             }
         }
 
         // --- ADDON ONUPDATE MEMORY USAGE ---
-        if (!gAddonOnUpdateMemoryStats.empty()) {
+        if (addonCount > 0) {
             DEBUG_LOG("--- ADDON ONUPDATE MEMORY USAGE (min 1KB total increase) ---");
 
             // Sort addons by total memory increase
-            std::vector<std::pair<long long, std::string>> addonMemoryStats;
-            for (auto it = gAddonOnUpdateMemoryStats.begin();
-                 it != gAddonOnUpdateMemoryStats.end(); ++it) {
-                if (it->second.callCount > 0 && it->second.totalMemoryIncrease >= 1) {
-                    addonMemoryStats.push_back(std::make_pair(it->second.totalMemoryIncrease, it->first));
+            ArenaVector<std::pair<long long, AddonId>> addonMemoryStats(gReportArena);
+            for (size_t id = 0; id < addonCount; ++id) {
+                const AddonStats *addon = window.addons[id];
+                if (addon != nullptr && addon->onUpdateMemory.callCount > 0 &&
+                    addon->onUpdateMemory.totalMemoryIncrease >= 1) {
+                    addonMemoryStats.push_back(
+                            std::make_pair(addon->onUpdateMemory.totalMemoryIncrease, static_cast<AddonId>(id)));
                 }
             }
             std::sort(addonMemoryStats.rbegin(), addonMemoryStats.rend());
 
             for (auto it = addonMemoryStats.begin();
                  it != addonMemoryStats.end(); ++it) {
-                gAddonOnUpdateMemoryStats[it->second].outputStats();
+                window.addons[it->second]->onUpdateMemory.outputStats(AddonLabel(label, it->second, " OnUpdate Memory"));
+            }
+            if (window.otherAddons.onUpdateMemory.totalMemoryIncrease >= 1) {
+                window.otherAddons.onUpdateMemory.outputStats("Other addons/frames OnUpdate Memory");
             }
         }
 
         // --- ADDON ONEVENT MEMORY USAGE ---
-        if (!gAddonOnEventMemoryStats.empty()) {
+        if (addonCount > 0) {
             DEBUG_LOG("--- ADDON ONEVENT MEMORY USAGE (min 1KB total increase) ---");
 
             // Sort addons by total memory increase
-            std::vector<std::pair<long long, std::string>> addonEventMemoryStats;
-            for (auto it = gAddonOnEventMemoryStats.begin();
-                 it != gAddonOnEventMemoryStats.end(); ++it) {
-                if (it->second.callCount > 0 && it->second.totalMemoryIncrease >= 1) {
-                    addonEventMemoryStats.push_back(std::make_pair(it->second.totalMemoryIncrease, it->first));
+            ArenaVector<std::pair<long long, AddonId>> addonEventMemoryStats(gReportArena);
+            for (size_t id = 0; id < addonCount; ++id) {
+                const AddonStats *addon = window.addons[id];
+                if (addon != nullptr && addon->onEventMemory.callCount > 0 &&
+                    addon->onEventMemory.totalMemoryIncrease >= 1) {
+                    addonEventMemoryStats.push_back(
+                            std::make_pair(addon->onEventMemory.totalMemoryIncrease, static_cast<AddonId>(id)));
                 }
             }
             std::sort(addonEventMemoryStats.rbegin(), addonEventMemoryStats.rend());
 
             for (auto it = addonEventMemoryStats.begin();
                  it != addonEventMemoryStats.end(); ++it) {
-                gAddonOnEventMemoryStats[it->second].outputStats();
+                window.addons[it->second]->onEventMemory.outputStats(AddonLabel(label, it->second, " OnEvent Memory"));
+            }
+            if (window.otherAddons.onEventMemory.totalMemoryIncrease >= 1) {
+                window.otherAddons.onEventMemory.outputStats("Other addons/frames OnEvent Memory");
             }
         }
 
         // --- ADDON EVENT STATS ---
-        if (!gAddonScriptEventStats.empty()) {
+        if (addonCount > 0) {
             DEBUG_LOG("--- ADDON/FRAME EVENTS PERFORMANCE (min 1ms total)---");
 
             // Sort addons by total time
-            std::vector<std::pair<double, std::string>> addonStats;
-            for (auto it = gAddonScriptEventStats.begin();
-                 it != gAddonScriptEventStats.end(); ++it) {
-                if (it->second.callCount > 0 && it->second.totalTime >= 1000.0) {
-                    addonStats.push_back(std::make_pair(it->second.totalTime, it->first));
+            ArenaVector<std::pair<uint64_t, AddonId>> addonStats(gReportArena);
+            for (size_t id = 0; id < addonCount; ++id) {
+                const AddonStats *addon = window.addons[id];
+                if (addon != nullptr && addon->onEvent.callCount > 0 && addon->onEvent.totalTime >= oneMsTicks) {
+                    addonStats.push_back(std::make_pair(addon->onEvent.totalTime, static_cast<AddonId>(id)));
                 }
             }
             std::sort(addonStats.rbegin(), addonStats.rend());
 
             for (auto it = addonStats.begin();
                  it != addonStats.end(); ++it) {
-                gAddonScriptEventStats[it->second].outputStats();
+                window.addons[it->second]->onEvent.outputStats(AddonLabel(label, it->second, " All Events"));
+                OutputErrorBound(window.addons[it->second]->error);
+            }
+            if (window.otherAddons.onEvent.totalTime >= oneMsTicks) {
+                window.otherAddons.onEvent.outputStats("Other addons/frames All Events");
             }
         }
 
-        // --- ADDON SLOWEST EVENTS REPORT ---
-        if (!gAddonEventStats.empty()) {
+        // --- ADDON x EVENT MATRIX, SLICED BOTH WAYS ---
+        {
+            ArenaVector<ArenaVector<AddonEventEntry>> byAddon(GetAddonNameCount(),
+                                                              ArenaVector<AddonEventEntry>(gReportArena), gReportArena);
+            ArenaVector<ArenaVector<AddonEventEntry>> byEvent(EVENT_CODE_SLOTS,
+                                                              ArenaVector<AddonEventEntry>(gReportArena), gReportArena);
+            window.addonEvents.forEachCell([&](AddonId addonId, int eventSlot, const AddonEventCell &cell) {
+                AddonEventEntry entry = {addonId, eventSlot, cell};
+                byAddon[addonId].push_back(entry);
+                byEvent[eventSlot].push_back(entry);
+            });
+
             DEBUG_LOG("--- ADDON/FRAME SLOWEST EVENTS REPORT (min 1ms combined duration) ---");
+            for (size_t id = 0; id < byAddon.size(); ++id) {
+                auto &events = byAddon[id];
+                size_t eventCount = events.size();
+                if (SumTotalTime(events) < oneMsTicks) {
+                    continue;
+                }
 
-            for (const auto &addonPair: gAddonEventStats) {
-                const std::string &addonName = addonPair.first;
-                std::vector<EventStats> slowEvents = addonPair.second; // Copy for sorting
+                KeepSlowest(events, 10);
+                DEBUG_LOG("[" << GetAddonName(static_cast<AddonId>(id)) << "] Top " << events.size()
+                              << " slowest events (out of " << eventCount << " total):");
+                for (size_t i = 0; i < events.size(); ++i) {
+                    OutputAddonEventLine(i, window.eventCodeStats[events[i].eventSlot].name, events[i].cell);
+                }
+            }
 
-                if (!slowEvents.empty()) {
-                    // Calculate total duration for this addon
-                    double totalAddonDuration = 0.0;
-                    for (const auto &event: slowEvents) {
-                        totalAddonDuration += event.duration;
-                    }
+            NEWLINE_LOG();
 
-                    // Skip if total duration is less than 1ms (1000 microseconds)
-                    if (totalAddonDuration < 1000.0) {
-                        continue;
-                    }
-
-                    // Sort events by duration (descending) only when displaying
-                    std::sort(slowEvents.begin(), slowEvents.end());
-
-                    // Only show top 10 slowest events
-                    size_t eventsToShow = slowEvents.size() < 10 ? slowEvents.size() : 10;
-                    DEBUG_LOG("[" << addonName << "] Top " << eventsToShow << " slowest events (out of "
-                                  << slowEvents.size() << " total):");
-
-                    for (size_t i = 0; i < eventsToShow; ++i) {
-                        const EventStats &event = slowEvents[i];
-                        DEBUG_LOG("  " << std::right << std::setw(2) << (i + 1) << ".  "
-                                       << std::left << std::setw(50) << GetEventName(event.eventCode)
-                                       << " Total Duration: " << std::right << std::setw(8) << std::fixed
-                                       << std::setprecision(3)
-                                       << event.duration / 1000.0 << " ms"
-                                       << "      Count: " << std::right << std::setw(6) << event.count);
-                    }
+            // Same cells from the other side, which addons a busy event fans out to
+            DEBUG_LOG("--- EVENT FAN-OUT, SLOWEST ADDONS/FRAMES PER EVENT (top 10 events, min 1ms combined duration) ---");
+            ArenaVector<std::pair<uint64_t, int>> eventTotals(gReportArena);
+            for (int slot = 0; slot < EVENT_CODE_SLOTS; ++slot) {
+                uint64_t total = SumTotalTime(byEvent[slot]);
+                if (total >= oneMsTicks) {
+                    eventTotals.emplace_back(total, slot);
+                }
+            }
+            size_t eventsToShow = SelectLargest(eventTotals, 10);
+            for (size_t e = 0; e < eventsToShow; ++e) {
+                int slot = eventTotals[e].second;
+                auto &addons = byEvent[slot];
+                size_t addonCount = addons.size();
+
+                KeepSlowest(addons, 10);
+                DEBUG_LOG("[" << window.eventCodeStats[slot].name << "] "
+                              << std::fixed << std::setprecision(3) << TicksToMs(eventTotals[e].first)
+                              << " ms across " << addonCount << " addons/frames, top " << addons.size() << ":");
+                for (size_t i = 0; i < addons.size(); ++i) {
+                    OutputAddonEventLine(i, GetAddonName(addons[i].addonId), addons[i].cell);
                 }
             }
         }
 
 
         // --- SPELL VISUAL PERFORMANCE (TOP 10 SLOWEST) ---
-        if (!gSpellVisualStatsById.empty()) {
+        const SpellVisualTable &spellVisuals = window.spellVisualStats;
+        if (spellVisuals.size() > 0) {
             DEBUG_LOG("--- SPELL VISUAL PERFORMANCE (min 1ms total) ---");
 
-            // Sort spells by total time
-            std::vector<std::pair<double, uint32_t>> spellStats;
-            for (auto it = gSpellVisualStatsById.begin(); it != gSpellVisualStatsById.end(); ++it) {
-                if (it->second.callCount > 0 && it->second.totalTime >= 1000.0) {
-                    spellStats.push_back(std::make_pair(it->second.totalTime, it->first));
+            // Spells worth showing, keyed by total time
+            ArenaVector<std::pair<uint64_t, size_t>> spellStats(gReportArena);
+            for (size_t slot = 0; slot < spellVisuals.size(); ++slot) {
+                const FunctionStats &stats = spellVisuals.at(slot);
+                if (stats.callCount > 0 && stats.totalTime >= oneMsTicks) {
+                    spellStats.push_back(std::make_pair(stats.totalTime, slot));
                 }
             }
-            std::sort(spellStats.rbegin(), spellStats.rend());
-
-            // Show only top 10 spells
-            size_t spellsToShow = spellStats.size() < 10 ? spellStats.size() : 10;
+            // Show only top 10 spells, ranked by the time they are known to have taken
+            size_t spellsToShow = SelectLargest(spellStats, 10);
             for (size_t i = 0; i < spellsToShow; ++i) {
-                gSpellVisualStatsById[spellStats[i].second].outputStats(20);
+                spellVisuals.at(spellStats[i].second).outputStats(20);
+                OutputErrorBound(spellVisuals.error(spellStats[i].second));
+            }
+            if (spellVisuals.overflow().callCount > 0) {
+                spellVisuals.overflow().outputStats(20);
             }
         }
 
         // --- EVENT CODE DURATION STATISTICS (TOP 10) ---
-        if (!gEventCodeStats.empty()) {
+        if (!window.eventCodeStats.empty()) {
             DEBUG_LOG("--- TOTAL EVENT DURATION STATISTICS (SHOULD INCLUDE ALL ADDONS) ---");
 
-            // Sort event codes by total time
-            std::vector<std::pair<double, int>> eventCodeStats;
-            for (auto it = gEventCodeStats.begin(); it != gEventCodeStats.end(); ++it) {
-                if (it->second.callCount > 0) {
-                    eventCodeStats.push_back(std::make_pair(it->second.totalTime, it->first));
+            // Event code slots that ran, keyed by total time
+            ArenaVector<std::pair<uint64_t, size_t>> eventCodeStats(gReportArena);
+            for (size_t slot = 0; slot < window.eventCodeStats.size(); ++slot) {
+                if (window.eventCodeStats[slot].callCount > 0) {
+                    eventCodeStats.push_back(std::make_pair(window.eventCodeStats[slot].totalTime, slot));
                 }
             }
-            std::sort(eventCodeStats.rbegin(), eventCodeStats.rend());
-
             // Show only top 10 events
-            size_t eventsToShow = eventCodeStats.size() < 10 ? eventCodeStats.size() : 10;
+            size_t eventsToShow = SelectLargest(eventCodeStats, 10);
             for (size_t i = 0; i < eventsToShow; ++i) {
-                gEventCodeStats[eventCodeStats[i].second].outputStats(45);
-            }
-        }
-
-        // Clear all stats
-        gRenderWorldStats.clearStats();
-        gOnWorldRenderStats.clearStats();
-        gOnWorldUpdateStats.clearStats();
-        gCWorldRenderStats.clearStats();
-        gCWorldUpdateStats.clearStats();
-        gCWorldSceneRenderStats.clearStats();
-        gCWorldUnknownRenderStats.clearStats();
-        gTimeBetweenRenderStats.clearStats();
-        gFrameOnScriptEventStats.clearStats();
-        gCSimpleFrameOnFrameRender1Stats.clearStats();
-        gCSimpleFrameOnFrameRender2Stats.clearStats();
-        gCSimpleModelOnFrameRenderStats.clearStats();
-        gCSimpleTopOnLayerUpdateStats.clearStats();
-        gCSimpleTopOnLayerRenderStats.clearStats();
-        gSpellVisualsRenderStats.clearStats();
-        gSpellVisualsTickStats.clearStats();
-        gUnitUpdateStats.clearStats();
-        gObjectUpdateHandlerStats.clearStats();
-        gPlaySpellVisualStats.clearStats();
-        gUnknownOnRender1Stats.clearStats();
-        gUnknownOnRender2Stats.clearStats();
-        gUnknownOnRender3Stats.clearStats();
-        gCM2SceneAdvanceTimeStats.clearStats();
-        gCM2SceneAnimateStats.clearStats();
-        gCM2SceneDrawStats.clearStats();
-        gPaintScreenStats.clearStats();
-        gDrawBatchProjStats.clearStats();
-        gDrawBatchStats.clearStats();
-        gDrawBatchDoodadStats.clearStats();
-        gDrawRibbonStats.clearStats();
-        gDrawParticleStats.clearStats();
-        gDrawCallbackStats.clearStats();
-        gCM2SceneRenderDrawStats.clearStats();
-        gFrameOnLayerUpdateStats.clearStats();
-        gLuaCCollectgarbageStats.clearStats();
-        gCM2ModelAnimateMTStats.clearStats();
-        gObjectFreeStats.clearStats();
-
-        // Clear addon stats
-        for (auto it = gAddonScriptEventStats.begin();
-             it != gAddonScriptEventStats.end(); ++it) {
-            it->second.clearStats();
-        }
-
-        // Clear addon OnUpdate stats
-        for (auto it = gAddonOnUpdateStats.begin();
-             it != gAddonOnUpdateStats.end(); ++it) {
-            it->second.clearStats();
-        }
-
-        // Clear addon memory stats
-        for (auto it = gAddonOnUpdateMemoryStats.begin();
-             it != gAddonOnUpdateMemoryStats.end(); ++it) {
-            it->second.clearStats();
-        }
-
-        for (auto it = gAddonOnEventMemoryStats.begin();
-             it != gAddonOnEventMemoryStats.end(); ++it) {
-            it->second.clearStats();
-        }
-
-
-        // Clear addon event stats
-        gAddonEventStats.clear();
-
-        // Clear spell visual stats
-        for (auto it = gSpellVisualStatsById.begin(); it != gSpellVisualStatsById.end(); ++it) {
-            it->second.clearStats();
-        }
-
-        // Clear event code stats
-        for (auto it = gEventCodeStats.begin(); it != gEventCodeStats.end(); ++it) {
-            it->second.clearStats();
-        }
-        gEventCodeStartTimes.clear();
-
-        // Clear total events stats
-        gTotalEventsStats.clearStats();
-
-        // Clear individual event stats
-        for (auto it = gEventStats.begin(); it != gEventStats.end(); ++it) {
-            it->second.clearStats();
+                window.eventCodeStats[eventCodeStats[i].second].outputStats(45);
+            }
         }
 
         DEBUG_LOG(
@@ -2,73 +2,210 @@
 
 #include <string>
 #include <cstdint>
-#include <map>
+#include <type_traits>
 #include <vector>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <cstring>
+#include <limits>
+#include <ctime>
+#include <atomic>
 #include "logging.hpp"
+#include "timing.hpp"
+#include "addon_names.hpp"
+#include "event_matrix.hpp"
+#include "call_tree.hpp"
+#include "config.hpp"
+#include "frame_timeline.hpp"
+#include "monitor_arena.hpp"
+#include "monitor_overhead.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace perf_monitor {
     // Forward declarations
     enum EVENT_ID : int;
+    constexpr int EVENT_ID_COUNT = 29; // EVENTIDS, checked in events.cpp
     constexpr uint64_t STATS_OUTPUT_INTERVAL_MS = 30000; // 30 seconds
 
-    // Struct to encapsulate function performance statistics
-    struct FunctionStats {
-        std::string name;           // Name of the function being monitored
-        double totalTime = 0;    // Cumulative execution time in microseconds
+    // Index of the highest set bit, value must be non-zero
+    inline int HighestSetBit(uint64_t value) {
+#if defined(_MSC_VER)
+        // _BitScanReverse64 isn't available when targeting 32 bit
+        unsigned long index;
+        if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32))) {
+            return static_cast<int>(index) + 32;
+        }
+        _BitScanReverse(&index, static_cast<unsigned long>(value));
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    // Fixed memory, log bucketed (HDR style) latency histogram.
+    // Values below SUB_BUCKETS are recorded exactly, every power of two above that is split
+    // into SUB_BUCKETS linear sub-buckets so the relative error stays under ~6%.
+    struct LatencyHistogram {
+        static constexpr int SUB_BUCKET_BITS = 3;
+        static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+        static constexpr int MAX_MAGNITUDE = 40; // values >= 2^40 land in the last bucket
+        static constexpr int BUCKET_COUNT = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+        uint32_t buckets[BUCKET_COUNT] = {};
+        uint64_t totalCount = 0;
+
+        static int bucketIndex(uint64_t value) {
+            if (value < SUB_BUCKETS) {
+                return static_cast<int>(value);
+            }
+            int magnitude = HighestSetBit(value);
+            if (magnitude >= MAX_MAGNITUDE) {
+                return BUCKET_COUNT - 1;
+            }
+            int shift = magnitude - SUB_BUCKET_BITS;
+            auto subBucket = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+            return (shift + 1) * static_cast<int>(SUB_BUCKETS) + subBucket;
+        }
+
+        // Midpoint of the value range covered by a bucket
+        static uint64_t bucketValue(int index);
+
+        void record(uint64_t value) {
+            buckets[bucketIndex(value)]++;
+            totalCount++;
+        }
+
+        void merge(const LatencyHistogram &other);
+
+        // Value at the given percentile (0-100), 0 if empty
+        uint64_t percentile(double percent) const;
+
+        void clear();
+    };
+
+    // Timing of one function over a window, durations in timer ticks
+    struct TimingStats {
+        uint64_t totalTime = 0;     // Cumulative execution time in timer ticks
         size_t callCount = 0;       // Number of calls
-        double avgTime = 0.0;       // Running average time in microseconds
-        double slowestTime = 0;  // Slowest execution time in microseconds
-        double fastestTime = 999999999LL; // Fastest execution time in microseconds
-        uint64_t lastStatsOutputTime = 0; // Last time stats were output
-        uint64_t periodStartTime = 0;
+        uint64_t slowestTime = 0;   // Slowest execution time in timer ticks
+        uint64_t fastestTime = std::numeric_limits<uint64_t>::max(); // Fastest execution time in timer ticks
+        LatencyHistogram histogram; // Distribution for the current window
+
+        // Update stats with a new execution time in timer ticks
+        void update(uint64_t duration);
+
+        // Output statistics under the given name
+        void outputStats(const char *name, int nameWidth = 45) const;
+
+        // Adds other's calls in, as if they had all gone through update()
+        void merge(const TimingStats &other);
 
-        // Default constructor (required for map's operator[])
+        void clear();
+    };
+
+    // Struct to encapsulate function performance statistics
+    struct FunctionStats : TimingStats {
+        std::string name;                  // Name of the function being monitored
+        LatencyHistogram sessionHistogram; // Previous windows merged together
+
+        // Default constructor (required for the fixed arrays of stats)
         FunctionStats() : name("Unknown") {}
 
         FunctionStats(std::string functionName) : name(std::move(functionName)) {}
 
-        // Update stats with a new execution time
-        void update(long long duration);
+        using TimingStats::outputStats;
 
         // Output statistics for this function and then reset the stats
-        void outputStats();
+        void outputStats() const;
         
         // Output statistics with custom width
-        void outputStats(int nameWidth);
+        void outputStats(int nameWidth) const;
 
-        void clearStats();
+        // Output percentiles over every window so far including the current one
+        void outputSessionStats(int nameWidth);
 
-        // Check if it's time to output stats and do so if needed
-        bool checkAndOutputStats(uint64_t nowMs);
+        // Merges the window histogram into the session histogram and resets the window
+        void clearStats();
     };
 
-    // Structure to track slowest events for each addon
-    struct EventStats {
-        int eventCode;
-        double duration;
-        size_t count;
+    // Per window stats of the spell visuals that cost the most, in a table sized up front so a
+    // spell seen for the first time in the middle of a fight doesn't allocate.  Once every slot is
+    // taken it works like Space-Saving: a new spell takes over the slot with the least time, the
+    // stats already in it move to other, and that time becomes the newcomer's error().  A spell's
+    // real total for the window is between its totalTime and totalTime + error(), and a spell that
+    // took more than 1/SLOTS of the window's spell visual time is never the one evicted.
+    class SpellVisualTable {
+    public:
+        static constexpr size_t SLOTS = 256;
+        static constexpr size_t INDEX_SLOTS = SLOTS * 2; // open addressing, at most half full
 
-        EventStats(int code, double dur) : eventCode(code), duration(dur), count(1) {}
-        
-        bool operator<(const EventStats& other) const {
-            return duration > other.duration; // For max heap (slowest first)
+        SpellVisualTable();
+
+        // Stats of spellId, taking over the lightest slot if it doesn't have one
+        FunctionStats &find(uint32_t spellId) {
+            size_t index = homeIndex(spellId);
+            while (indices[index] != EMPTY) {
+                if (spellIds[indices[index]] == spellId) {
+                    return stats[indices[index]];
+                }
+                index = (index + 1) & (INDEX_SLOTS - 1);
+            }
+            return claim(index, spellId);
+        }
+
+        size_t size() const { return count; }
+
+        uint32_t spellId(size_t slot) const { return spellIds[slot]; }
+
+        const FunctionStats &at(size_t slot) const { return stats[slot]; }
+
+        // Most time the spell in slot could have had before it got the slot, in timer ticks
+        uint64_t error(size_t slot) const { return errors[slot]; }
+
+        // Spells that were evicted from their slot, callCount 0 if every spell fit
+        const FunctionStats &overflow() const { return other; }
+
+        // Slots taken over from another spell this window
+        size_t evictions() const { return evictionCount; }
+
+        // Frees every slot for the next window, keeping the names' storage
+        void clear();
+
+    private:
+        static constexpr uint16_t EMPTY = 0xFFFF;
+
+        static size_t homeIndex(uint32_t spellId) {
+            return (spellId * 2654435761u) & (INDEX_SLOTS - 1);
         }
+
+        FunctionStats &claim(size_t index, uint32_t spellId);
+
+        // Empties the slot with the least time counting its error into other, returns it
+        uint16_t evict();
+
+        // Removes spellId from the index, keeping every other id reachable from its home index
+        void unindex(uint32_t spellId);
+
+        uint16_t indices[INDEX_SLOTS];
+        uint32_t spellIds[SLOTS];
+        uint64_t errors[SLOTS];
+        FunctionStats stats[SLOTS];
+        FunctionStats other;
+        size_t count = 0;
+        size_t evictionCount = 0;
     };
 
     // Structure to track memory usage for addons
     struct MemoryStats {
-        std::string name;
         long long totalMemoryIncrease = 0;  // Total memory increase in KB
         long long maxMemoryIncrease = 0;    // Largest single memory increase in KB
         size_t callCount = 0;               // Number of calls tracked
         double avgMemoryIncrease = 0.0;     // Average memory increase per call in KB
 
-        MemoryStats() : name("Unknown") {}
-        MemoryStats(std::string addonName) : name(std::move(addonName)) {}
-
         void update(int memoryDelta) {
             if (memoryDelta > 0) {  // Only track increases
                 callCount++;
@@ -80,14 +217,18 @@ namespace perf_monitor {
             }
         }
 
-        void clearStats() {
-            totalMemoryIncrease = 0;
-            maxMemoryIncrease = 0;
-            callCount = 0;
-            avgMemoryIncrease = 0.0;
+        void merge(const MemoryStats &other) {
+            if (other.callCount > 0) {
+                callCount += other.callCount;
+                totalMemoryIncrease += other.totalMemoryIncrease;
+                if (other.maxMemoryIncrease > maxMemoryIncrease) {
+                    maxMemoryIncrease = other.maxMemoryIncrease;
+                }
+                avgMemoryIncrease = static_cast<double>(totalMemoryIncrease) / callCount;
+            }
         }
 
-        void outputStats() {
+        void outputStats(const char *name) const {
             if (callCount > 0) {
                 DEBUG_LOG(
                     std::fixed << std::setprecision(1)
@@ -101,52 +242,297 @@ namespace perf_monitor {
         }
     };
 
-    // Global statistics objects - extern declarations
-    extern FunctionStats gRenderWorldStats;
-    extern FunctionStats gOnWorldRenderStats;
-    extern FunctionStats gOnWorldUpdateStats;
-    extern FunctionStats gSpellVisualsRenderStats;
-    extern FunctionStats gSpellVisualsTickStats;
-    extern FunctionStats gUnitUpdateStats;
-    extern FunctionStats gFrameOnLayerUpdateStats;
-    extern FunctionStats gCWorldRenderStats;
-    extern FunctionStats gCWorldUpdateStats;
-    extern FunctionStats gCWorldSceneRenderStats;
-    extern FunctionStats gCWorldUnknownRenderStats;
-    extern FunctionStats gTimeBetweenRenderStats;
-    extern FunctionStats gFrameOnScriptEventStats;
-    extern FunctionStats gCSimpleFrameOnFrameRender1Stats;
-    extern FunctionStats gCSimpleFrameOnFrameRender2Stats;
-    extern FunctionStats gCSimpleModelOnFrameRenderStats;
-    extern FunctionStats gCSimpleTopOnLayerUpdateStats;
-    extern FunctionStats gCSimpleTopOnLayerRenderStats;
-    extern FunctionStats gObjectUpdateHandlerStats;
-    extern FunctionStats gPlaySpellVisualStats;
-    extern FunctionStats gUnknownOnRender1Stats;
-    extern FunctionStats gUnknownOnRender2Stats;
-    extern FunctionStats gUnknownOnRender3Stats;
-    extern FunctionStats gCM2SceneAdvanceTimeStats;
-    extern FunctionStats gCM2SceneAnimateStats;
-    extern FunctionStats gCM2SceneDrawStats;
-    extern FunctionStats gPaintScreenStats;
-    extern FunctionStats gDrawBatchProjStats;
-    extern FunctionStats gDrawBatchStats;
-    extern FunctionStats gDrawBatchDoodadStats;
-    extern FunctionStats gDrawRibbonStats;
-    extern FunctionStats gDrawParticleStats;
-    extern FunctionStats gDrawCallbackStats;
-    extern FunctionStats gCM2SceneRenderDrawStats;
-    extern FunctionStats gTotalEventsStats;
-    extern FunctionStats gLuaCCollectgarbageStats;
-    extern FunctionStats gCM2ModelAnimateMTStats;
-    extern FunctionStats gObjectFreeStats;
-
-    // Global maps and containers (not already declared in events.hpp)
-    extern std::map<std::string, std::vector<EventStats>> gAddonEventStats;
-    extern std::map<uint32_t, FunctionStats> gSpellVisualStatsById;
-    extern std::map<std::string, MemoryStats> gAddonOnEventMemoryStats;
-    extern std::map<std::string, MemoryStats> gAddonOnUpdateMemoryStats;
-
-    // OutputStats function declaration
-    void OutputStats(uint64_t startTime, uint64_t endTime);
+    // One addon's (or frame's) handlers during a window, named by its AddonId when reported
+    struct AddonStats {
+        TimingStats onEvent; // every event it handled
+        TimingStats onUpdate;
+        MemoryStats onEventMemory;
+        MemoryStats onUpdateMemory;
+        uint64_t error = 0;  // most OnEvent + OnUpdate time it could have had before taking over a slot
+
+        // What StatsWindow ranks slots by when it has to evict one, time including the error
+        uint64_t weight() const {
+            return onEvent.totalTime + onUpdate.totalTime + error;
+        }
+
+        void merge(const AddonStats &other) {
+            onEvent.merge(other.onEvent);
+            onUpdate.merge(other.onUpdate);
+            onEventMemory.merge(other.onEventMemory);
+            onUpdateMemory.merge(other.onUpdateMemory);
+        }
+    };
+
+    static_assert(std::is_trivially_destructible<AddonStats>::value, "AddonStats lives in an arena that is rewound");
+
+    // Ids for every fixed function we hook.  Ordered the way the detailed report prints them.
+    enum MetricId : uint16_t {
+        // Frame
+        METRIC_PAINT_SCREEN,
+        METRIC_UIPARENT_ON_RENDER,
+        METRIC_UIPARENT_ON_UPDATE,
+        // World render
+        METRIC_ON_WORLD_RENDER,
+        METRIC_UNKNOWN_ON_RENDER1,
+        METRIC_UNKNOWN_ON_RENDER2,
+        METRIC_UNKNOWN_ON_RENDER3,
+        METRIC_CM2_SCENE_ADVANCE_TIME,
+        METRIC_CM2_SCENE_ANIMATE,
+        METRIC_CM2_MODEL_ANIMATE_MT,
+        METRIC_CM2_SCENE_DRAW,
+        METRIC_DRAW_BATCH_PROJ,
+        METRIC_DRAW_BATCH,
+        METRIC_DRAW_BATCH_DOODAD,
+        METRIC_DRAW_RIBBON,
+        METRIC_DRAW_PARTICLE,
+        METRIC_DRAW_CALLBACK,
+        METRIC_CM2_SCENE_RENDER_DRAW,
+        METRIC_CWORLD_SCENE_RENDER,
+        // World update
+        METRIC_ON_WORLD_UPDATE,
+        METRIC_UNIT_UPDATE,
+        METRIC_CWORLD_UPDATE,
+        // Scripts / network
+        METRIC_OBJECT_UPDATE_HANDLER,
+        METRIC_FRAME_ON_SCRIPT_EVENT,
+        METRIC_FRAME_ON_LAYER_UPDATE,
+        // Garbage collection
+        METRIC_LUA_COLLECT_GARBAGE,
+        METRIC_OBJECT_FREE,
+        // Not part of the detailed report
+        METRIC_RENDER_WORLD,
+        METRIC_CWORLD_RENDER,
+        METRIC_CWORLD_UNKNOWN_RENDER,
+        METRIC_TIME_BETWEEN_RENDER,
+        METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER1,
+        METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER2,
+        METRIC_CSIMPLE_MODEL_ON_FRAME_RENDER,
+        METRIC_PLAY_SPELL_VISUAL,
+        METRIC_SPELL_VISUALS_RENDER,
+        METRIC_SPELL_VISUALS_TICK,
+        METRIC_TOTAL_EVENTS,
+
+        METRIC_COUNT,
+        METRIC_NONE = METRIC_COUNT
+    };
+
+    // Detailed report sections, a blank line is written between groups
+    enum MetricGroup : uint8_t {
+        METRIC_GROUP_FRAME,
+        METRIC_GROUP_WORLD_RENDER,
+        METRIC_GROUP_WORLD_UPDATE,
+        METRIC_GROUP_SCRIPT,
+        METRIC_GROUP_GARBAGE,
+        METRIC_GROUP_HIDDEN, // tracked but left out of the detailed report
+    };
+
+    struct MetricInfo {
+        MetricId id;
+        const char *name;        // Name used in the detailed report
+        const char *summaryName; // Label in the % of total render summary, nullptr to leave it out
+        MetricId parent;         // Summary group this metric is listed under
+        MetricGroup group;
+    };
+
+    constexpr MetricInfo kMetricInfo[METRIC_COUNT] = {
+            {METRIC_PAINT_SCREEN,                   "PaintScreen",                     nullptr,                  METRIC_NONE,            METRIC_GROUP_FRAME},
+            {METRIC_UIPARENT_ON_RENDER,             "UIParent OnRender",               nullptr,                  METRIC_NONE,            METRIC_GROUP_FRAME},
+            {METRIC_UIPARENT_ON_UPDATE,             "UIParent OnUpdate",               "UIParent OnUpdate:",     METRIC_NONE,            METRIC_GROUP_FRAME},
+            {METRIC_ON_WORLD_RENDER,                "OnWorldRender",                   "OnWorldRender:",         METRIC_NONE,            METRIC_GROUP_WORLD_RENDER},
+            {METRIC_UNKNOWN_ON_RENDER1,             "UnknownOnRender1",                "UnknownOnRender1:",      METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_UNKNOWN_ON_RENDER2,             "UnknownOnRender2",                "UnknownOnRender2:",      METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_UNKNOWN_ON_RENDER3,             "UnknownOnRender3",                "UnknownOnRender3:",      METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_CM2_SCENE_ADVANCE_TIME,         "CM2Scene::AdvanceTime",           "CM2Scene::AdvanceTime:", METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_CM2_SCENE_ANIMATE,              "CM2Scene::Animate",               "CM2Scene::Animate:",     METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_CM2_MODEL_ANIMATE_MT,           "CM2Model::AnimateMT",             nullptr,                  METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_CM2_SCENE_DRAW,                 "CM2Scene::Draw",                  "CM2Scene::Draw:",        METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_DRAW_BATCH_PROJ,                "CM2SceneRender::DrawBatchProj",   "DrawBatchProj:",         METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_DRAW_BATCH,                     "CM2SceneRender::DrawBatch",       "DrawBatch:",             METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_DRAW_BATCH_DOODAD,              "CM2SceneRender::DrawBatchDoodad", "DrawBatchDoodad:",       METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_DRAW_RIBBON,                    "CM2SceneRender::DrawRibbon",      "DrawRibbon:",            METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_DRAW_PARTICLE,                  "CM2SceneRender::DrawParticle",    nullptr,                  METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_DRAW_CALLBACK,                  "CM2SceneRender::DrawCallback",    "DrawCallback:",          METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_CM2_SCENE_RENDER_DRAW,          "CM2SceneRender::Draw",            "CM2SceneRender::Draw:",  METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_CWORLD_SCENE_RENDER,            "CWorldSceneRender",               "CWorldSceneRender:",     METRIC_ON_WORLD_RENDER, METRIC_GROUP_WORLD_RENDER},
+            {METRIC_ON_WORLD_UPDATE,                "OnWorldUpdate",                   "OnWorldUpdate:",         METRIC_NONE,            METRIC_GROUP_WORLD_UPDATE},
+            {METRIC_UNIT_UPDATE,                    "UnitUpdate",                      "UnitUpdate:",            METRIC_ON_WORLD_UPDATE, METRIC_GROUP_WORLD_UPDATE},
+            {METRIC_CWORLD_UPDATE,                  "CWorldUpdate",                    "CWorldUpdate:",          METRIC_ON_WORLD_UPDATE, METRIC_GROUP_WORLD_UPDATE},
+            {METRIC_OBJECT_UPDATE_HANDLER,          "ObjectUpdateHandler",             nullptr,                  METRIC_NONE,            METRIC_GROUP_SCRIPT},
+            {METRIC_FRAME_ON_SCRIPT_EVENT,          "All Event Handling",              "All Events:",            METRIC_NONE,            METRIC_GROUP_SCRIPT},
+            {METRIC_FRAME_ON_LAYER_UPDATE,          "All OnUpdates",                   "All OnUpdates:",         METRIC_NONE,            METRIC_GROUP_SCRIPT},
+            {METRIC_LUA_COLLECT_GARBAGE,            "Lua Garbage Collection",          nullptr,                  METRIC_NONE,            METRIC_GROUP_GARBAGE},
+            {METRIC_OBJECT_FREE,                    "World Object Garbage Collection", nullptr,                  METRIC_NONE,            METRIC_GROUP_GARBAGE},
+            {METRIC_RENDER_WORLD,                   "RenderWorld",                     nullptr,                  METRIC_NONE,            METRIC_GROUP_HIDDEN},
+            {METRIC_CWORLD_RENDER,                  "CWorldRender",                    "CWorldRender:",          METRIC_ON_WORLD_RENDER, METRIC_GROUP_HIDDEN},
+            {METRIC_CWORLD_UNKNOWN_RENDER,          "CWorldUnknownRender",             nullptr,                  METRIC_NONE,            METRIC_GROUP_HIDDEN},
+            {METRIC_TIME_BETWEEN_RENDER,            "TimeBetweenRender",               nullptr,                  METRIC_NONE,            METRIC_GROUP_HIDDEN},
+            {METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER1, "CSimpleFrameOnFrameRender1",      nullptr,                  METRIC_NONE,            METRIC_GROUP_HIDDEN},
+            {METRIC_CSIMPLE_FRAME_ON_FRAME_RENDER2, "CSimpleFrameOnFrameRender2",      nullptr,                  METRIC_NONE,            METRIC_GROUP_HIDDEN},
+            {METRIC_CSIMPLE_MODEL_ON_FRAME_RENDER,  "CSimpleModelOnFrameRender",       nullptr,                  METRIC_NONE,            METRIC_GROUP_HIDDEN},
+            {METRIC_PLAY_SPELL_VISUAL,              "PlaySpellVisual",                 nullptr,                  METRIC_NONE,            METRIC_GROUP_HIDDEN},
+            {METRIC_SPELL_VISUALS_RENDER,           "SpellVisualsRender",              "SpellVisualsRender:",    METRIC_ON_WORLD_RENDER, METRIC_GROUP_HIDDEN},
+            {METRIC_SPELL_VISUALS_TICK,             "SpellVisualsTick",                "SpellVisualsTick:",      METRIC_ON_WORLD_RENDER, METRIC_GROUP_HIDDEN},
+            {METRIC_TOTAL_EVENTS,                   "All Events",                      nullptr,                  METRIC_NONE,            METRIC_GROUP_HIDDEN},
+    };
+
+    constexpr bool MetricInfoMatchesIds(int index = 0) {
+        return index == METRIC_COUNT ||
+               (kMetricInfo[index].id == index && MetricInfoMatchesIds(index + 1));
+    }
+
+    static_assert(MetricInfoMatchesIds(), "kMetricInfo must be listed in MetricId order");
+
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Per window counters for every MetricId stored as contiguous, cache line aligned arrays so
+    // the hooks only touch one dense block and a window reset is a fill of each flat array.
+    // Durations are in timer ticks.
+    struct alignas(CACHE_LINE_SIZE) MetricTable {
+        alignas(CACHE_LINE_SIZE) uint64_t totals[METRIC_COUNT];
+        alignas(CACHE_LINE_SIZE) uint64_t counts[METRIC_COUNT];
+        alignas(CACHE_LINE_SIZE) uint64_t mins[METRIC_COUNT];
+        alignas(CACHE_LINE_SIZE) uint64_t maxs[METRIC_COUNT];
+        alignas(CACHE_LINE_SIZE) LatencyHistogram histograms[METRIC_COUNT];
+        // Sampled hooks only, see metric_sampler.hpp.  counts and totals above are timed calls.
+        alignas(CACHE_LINE_SIZE) uint64_t skipped[METRIC_COUNT]; // calls counted without timing
+        alignas(CACHE_LINE_SIZE) double squares[METRIC_COUNT];   // sum of squared timed durations
+
+        MetricTable() { reset(); }
+
+        void update(MetricId id, uint64_t duration) {
+            totals[id] += duration;
+            counts[id]++;
+            if (duration < mins[id]) mins[id] = duration;
+            if (duration > maxs[id]) maxs[id] = duration;
+            histograms[id].record(duration);
+        }
+
+        // update() for hooks that may be sampled, also keeps what the confidence interval needs
+        void updateSampled(MetricId id, uint64_t duration) {
+            update(id, duration);
+            auto value = static_cast<double>(duration);
+            squares[id] += value * value;
+        }
+
+        void skip(MetricId id) {
+            skipped[id]++;
+        }
+
+        // Timed and skipped
+        uint64_t calls(MetricId id) const {
+            return counts[id] + skipped[id];
+        }
+
+        // totals scaled up from the timed calls to every call, the same as totals when nothing was skipped
+        uint64_t estimatedTotal(MetricId id) const;
+
+        // Half width of the 95% confidence interval of estimatedTotal as a percentage of it, 0 when
+        // every call was timed
+        double estimatedTotalErrorPercent(MetricId id) const;
+
+        void merge(const MetricTable &other);
+
+        void reset();
+
+        void outputStats(MetricId id, int nameWidth = 45) const;
+    };
+
+    // Threads other than the game thread that get their own metric shard, see thread_shards.hpp
+    constexpr size_t MAX_THREAD_SHARDS = 8;
+
+    // ThreadMetricTotals::threadId of the shard every thread past MAX_THREAD_SHARDS shares
+    constexpr uint32_t SHARED_SHARD_THREAD_ID = 0;
+
+    // One thread's share of a window's metrics
+    struct ThreadMetricTotals {
+        uint32_t threadId;
+        uint64_t calls[METRIC_COUNT];
+        uint64_t totals[METRIC_COUNT]; // scaled up like MetricTable::estimatedTotal
+    };
+
+    // Most a window's per addon stats can take, past this further addons in the window are dropped
+    constexpr size_t WINDOW_ARENA_BYTES = 16 * 1024 * 1024;
+    // Most addons/frames a window keeps their own stats for, past this they take over the
+    // lightest slot the way SpellVisualTable does
+    constexpr size_t MAX_WINDOW_ADDONS = 1024;
+
+    // Everything accumulated during one stats window.  There are two of these, the hooks write
+    // into the active one while the stats worker reports and clears the retired one, so every
+    // metric shares exactly the same window boundaries.
+    struct StatsWindow {
+        MetricTable metrics;
+        FunctionStats eventStats[EVENT_ID_COUNT]; // named by initializeEventStats
+        std::vector<FunctionStats> eventCodeStats; // indexed by EventCodeSlot, named by initializeEventStats
+        SpellVisualTable spellVisualStats;
+
+        // Everything below whose size depends on how many addons show up.  Rewound when the
+        // window is cleared, so after the first few windows it never goes back to the heap.
+        MonitorArena arena{WINDOW_ARENA_BYTES};
+        AddonStats *addons[MAX_ADDON_NAMES] = {}; // by AddonId, nullptr until the addon shows up or once evicted
+        size_t addonCount = 0;                    // one past the highest AddonId in addons
+        AddonId trackedAddons[MAX_WINDOW_ADDONS]; // ids that have a slot in addons right now
+        size_t trackedAddonCount = 0;
+        AddonStats otherAddons;                   // everything evicted addons had before losing their slot
+        size_t addonEvictions = 0;
+        AddonEventMatrix addonEvents{arena};      // [AddonId][EventCodeSlot]
+        CallTreeWindow callTree;      // inclusive/self time per hook call path
+        MonitorOverhead overhead;     // what measuring all of the above cost
+        // Per thread split of metrics, [0] is the game thread and the shared shard comes last.  Filled
+        // in when the window is reported.
+        ThreadMetricTotals threads[MAX_THREAD_SHARDS + 2];
+        size_t threadCount = 0;
+
+        uint32_t epoch = 0;          // gStatsEpoch while this window was active
+        uint64_t startTime = 0;      // ms, same clock as the hooks
+        uint64_t endTime = 0;
+        std::time_t endWallTime = 0; // for the report header
+        uint64_t firstFrame = 0;     // frames [firstFrame, endFrame) of the frame ring
+        uint64_t endFrame = 0;
+        Config config;               // gConfig when the window closed, the stats worker reads this one
+
+        // Stats of addon id, allocated on first use or taken over from the lightest addon once
+        // MAX_WINDOW_ADDONS have one.  nullptr once the arena is full.
+        AddonStats *addon(AddonId id) {
+            AddonStats *stats = addons[id];
+            return stats != nullptr ? stats : addAddon(id);
+        }
+
+        AddonStats *addAddon(AddonId id);
+
+        void clear();
+    };
+
+    extern StatsWindow gStatsWindows[2];
+    // Only ever changed by the game thread, the low bit selects the active window.  Atomic
+    // because the thread shards read it from other threads.
+    extern std::atomic<uint32_t> gStatsEpoch;
+
+    inline StatsWindow &ActiveStats() {
+        return gStatsWindows[gStatsEpoch.load(std::memory_order_relaxed) & 1];
+    }
+
+    // Every previous window merged together, per metric.  Only touched by whoever reports.
+    extern LatencyHistogram gMetricSessionHistograms[METRIC_COUNT];
+    extern uint64_t gStatsPeriodStartTime;
+
+    // True once STATS_OUTPUT_INTERVAL_MS has passed since the current window started
+    bool ShouldOutputStats(uint64_t nowMs);
+
+    // Starts the thread that formats and clears retired windows
+    void StartStatsWorker();
+
+    // Game thread only.  Flips the hooks over to the other window and hands the finished one to
+    // the stats worker, or reports it inline when no worker is running.  Returns false and keeps
+    // accumulating into the current window while the previous report is still being written.
+    bool RetireStatsWindow(uint64_t nowMs);
+
+    // Shared formatting for FunctionStats and MetricTable lines, durations in timer ticks
+    void OutputStatsLine(const char *name, int nameWidth, size_t callCount, uint64_t totalTime, uint64_t slowestTime,
+                         uint64_t fastestTime, const LatencyHistogram &histogram);
+
+    void OutputSessionStatsLine(const char *name, int nameWidth, const LatencyHistogram &sessionHistogram,
+                                const LatencyHistogram &windowHistogram);
+
+    // Writes the report for a retired window
+    void OutputStats(StatsWindow &window);
 }
\ No newline at end of file
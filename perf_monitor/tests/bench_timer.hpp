@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace perf_monitor {
+    // Stops the compiler from dropping a result the benchmark never otherwise uses
+    inline void KeepValue(const void *value) {
+#if defined(_MSC_VER)
+        static const void *volatile sink;
+        sink = value;
+#else
+        asm volatile("" : : "g"(value) : "memory");
+#endif
+    }
+
+    // Runs body(i) for i in [0, iterations) and prints the mean ns per call
+    template<typename Body>
+    double RunBenchmark(const char *name, size_t iterations, Body body) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            body(i);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        double ns = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+        std::printf("%-50s %10.2f ns\n", name, ns);
+        return ns;
+    }
+}
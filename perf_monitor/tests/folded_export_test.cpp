@@ -0,0 +1,91 @@
+#include "call_tree.hpp"
+#include "folded_export.hpp"
+#include "stats.hpp"
+#include "test_check.hpp"
+#include "thread_shards.hpp"
+#include "timing.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+using namespace perf_monitor;
+
+static std::string WindowPath(unsigned window) {
+    char path[64];
+    std::snprintf(path, sizeof(path), "perf_monitor_window_%04u.folded", window);
+    return path;
+}
+
+static bool ReadFile(const std::string &path, std::string &text) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    text = contents.str();
+    return true;
+}
+
+// Every window gets its own file and only the last 20 stay on disk
+static void TestOneFilePerWindow() {
+    const unsigned windows = 23;
+    for (unsigned window = 1; window <= windows; ++window) {
+        CallTreeWindow &tree = ActiveStats().callTree;
+        tree.clear();
+        CallTreeEnter(METRIC_PAINT_SCREEN);
+        CallTreeLeave(UsToTicks(window * 1000.0));
+        ExportFoldedStacks(tree);
+    }
+
+    std::string text;
+    for (unsigned window = 1; window <= windows - 20; ++window) {
+        CHECK(!ReadFile(WindowPath(window), text));
+    }
+    for (unsigned window = windows - 19; window <= windows; ++window) {
+        CHECK(ReadFile(WindowPath(window), text));
+        CHECK(text == "PaintScreen " + std::to_string(window * 1000) + "\n");
+    }
+
+    // The session file sums every window
+    CHECK(ReadFile("perf_monitor_session.folded", text));
+    CHECK(text == "PaintScreen " + std::to_string(windows * (windows + 1) / 2 * 1000) + "\n");
+}
+
+static void WriteFile(const std::string &path, const std::string &text) {
+    std::ofstream file(path);
+    CHECK(file && (file << text));
+}
+
+// Left over from a longer session in the same directory, the first window of this one removes
+// every earlier window file so none of them outlive the retention cap or mix with this session
+static void WriteEarlierSession() {
+    for (unsigned window: {5u, 21u, 300u, 12345u}) {
+        WriteFile(WindowPath(window), "PaintScreen 1\n");
+    }
+    WriteFile("perf_monitor_window_notes.folded", "kept");
+}
+
+static void CheckEarlierSessionRemoved() {
+    std::string text;
+    CHECK(!ReadFile(WindowPath(300), text));
+    CHECK(!ReadFile(WindowPath(12345), text));
+    CHECK(ReadFile("perf_monitor_window_notes.folded", text) && text == "kept");
+}
+
+int main() {
+    // The exporter writes to the working directory
+    char directory[] = "/tmp/folded_export_testXXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    CHECK(chdir(directory) == 0);
+
+    SetGameThread();
+    WriteEarlierSession();
+    TestOneFilePerWindow();
+    CheckEarlierSessionRemoved();
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "main.hpp"
+#include "bench_timer.hpp"
+#include "timing.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace perf_monitor;
+
+// Stand in for a client frame, getAddonOrFrameId reads the frame name from word 38
+struct SyntheticFrame {
+    uintptr_t words[39] = {};
+    uintptr_t addonName[2] = {}; // script's addon pointer, name at [1] when the script has one
+};
+
+// Frame to addon resolution as the OnUpdate and OnEvent hooks do it, for the raid UI sized set of
+// frames a fight cycles through.  Host IsBadReadPtr is free, on Windows it is a real call per
+// checked byte, so the uncached numbers here are a lower bound.
+int main() {
+    CalibrateTimer();
+
+    const size_t frameCount = 1500;
+    std::vector<std::string> names;
+    std::vector<SyntheticFrame> frames(frameCount);
+    for (size_t i = 0; i < frameCount; ++i) {
+        names.push_back("RaidPullout" + std::to_string(i % 40) + "UnitButton" + std::to_string(i) + "HealthBar");
+    }
+    const std::string addonName = "pfUI";
+    for (size_t i = 0; i < frameCount; ++i) {
+        frames[i].words[38] = reinterpret_cast<uintptr_t>(names[i].c_str());
+        // A third of the scripts belong to a named addon, the rest fall back to the frame name
+        if (i % 3 == 0) {
+            frames[i].addonName[1] = reinterpret_cast<uintptr_t>(addonName.c_str());
+        }
+    }
+    auto frame = [&](size_t i) { return frames[(i * 7) % frameCount].words; };
+    auto addon = [&](size_t i) { return frames[(i * 7) % frameCount].addonName; };
+
+    const size_t iterations = 5000000;
+    AddonId id = 0;
+    RunBenchmark("uncached getAddonOrFrameId (old path)", iterations, [&](size_t i) {
+        id ^= getAddonOrFrameId(frame(i), addon(i));
+    });
+
+    for (size_t i = 0; i < frameCount; ++i) {
+        resolveAddonId(frame(i), addon(i));
+    }
+    RunBenchmark("resolveAddonId, cache hit", iterations, [&](size_t i) {
+        id ^= resolveAddonId(frame(i), addon(i));
+    });
+
+    RunBenchmark("resolveAddonId, cache miss", iterations, [&](size_t i) {
+        gFrameAddonCache.invalidateAll();
+        id ^= resolveAddonId(frame(i), addon(i));
+    });
+    KeepValue(&id);
+    return 0;
+}
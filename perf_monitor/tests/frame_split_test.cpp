@@ -0,0 +1,70 @@
+#include "call_tree.hpp"
+#include "frame_timeline.hpp"
+#include "stats.hpp"
+#include "test_check.hpp"
+#include "thread_shards.hpp"
+
+using namespace perf_monitor;
+
+// Enter and leave in the order the hooks in main.cpp do, the split is charged before leaving
+static void LeaveSplitHook(FrameSplit split, uint64_t duration) {
+    AddFrameSplit(split, duration);
+    CallTreeLeave(duration);
+}
+
+// World update 100 ticks, running a script event of 30 that fires another of 5
+static void TestNestedSplitsAreSelfTime() {
+    CallTreeEnter(METRIC_ON_WORLD_UPDATE);
+    CallTreeEnter(METRIC_FRAME_ON_SCRIPT_EVENT);
+    CallTreeEnter(METRIC_FRAME_ON_SCRIPT_EVENT);
+    LeaveSplitHook(FRAME_SPLIT_SCRIPT_EVENTS, 5);
+    LeaveSplitHook(FRAME_SPLIT_SCRIPT_EVENTS, 30);
+    LeaveSplitHook(FRAME_SPLIT_WORLD_UPDATE, 100);
+
+    const FrameRecord &frame = RecordFrame(1000, 120);
+    CHECK(frame.splits[FRAME_SPLIT_WORLD_UPDATE] == 70);
+    CHECK(frame.splits[FRAME_SPLIT_SCRIPT_EVENTS] == 30);
+}
+
+// A hook that doesn't charge a split passes its nested split time up to the split hook above it
+static void TestSplitTimeCrossesUnsplitHooks() {
+    CallTreeEnter(METRIC_UIPARENT_ON_UPDATE);
+    CallTreeEnter(METRIC_OBJECT_FREE);
+    CallTreeEnter(METRIC_CM2_MODEL_ANIMATE_MT);
+    CallTreeEnter(METRIC_LUA_COLLECT_GARBAGE);
+    LeaveSplitHook(FRAME_SPLIT_GARBAGE_COLLECTION, 8);
+    CallTreeLeave(20); // CM2ModelAnimateMT, no split
+    LeaveSplitHook(FRAME_SPLIT_GARBAGE_COLLECTION, 25);
+    LeaveSplitHook(FRAME_SPLIT_UI_UPDATE, 40);
+
+    // Two split hooks in a row at the top level each keep their whole duration
+    CallTreeEnter(METRIC_ON_WORLD_RENDER);
+    LeaveSplitHook(FRAME_SPLIT_WORLD_RENDER, 50);
+    CallTreeEnter(METRIC_ON_WORLD_RENDER);
+    LeaveSplitHook(FRAME_SPLIT_WORLD_RENDER, 10);
+
+    const FrameRecord &frame = RecordFrame(2000, 120);
+    CHECK(frame.splits[FRAME_SPLIT_GARBAGE_COLLECTION] == 25);
+    CHECK(frame.splits[FRAME_SPLIT_UI_UPDATE] == 15);
+    CHECK(frame.splits[FRAME_SPLIT_WORLD_RENDER] == 60);
+    CHECK(frame.splits[FRAME_SPLIT_WORLD_UPDATE] == 0);
+}
+
+// Directly recursive frames fold into one call tree node but still nest for the splits
+static void TestRecursiveSplitHook() {
+    CallTreeEnter(METRIC_ON_WORLD_RENDER);
+    CallTreeEnter(METRIC_ON_WORLD_RENDER);
+    LeaveSplitHook(FRAME_SPLIT_WORLD_RENDER, 30);
+    LeaveSplitHook(FRAME_SPLIT_WORLD_RENDER, 45);
+
+    const FrameRecord &frame = RecordFrame(3000, 120);
+    CHECK(frame.splits[FRAME_SPLIT_WORLD_RENDER] == 45);
+}
+
+int main() {
+    SetGameThread();
+    TestNestedSplitsAreSelfTime();
+    TestSplitTimeCrossesUnsplitHooks();
+    TestRecursiveSplitHook();
+    return 0;
+}
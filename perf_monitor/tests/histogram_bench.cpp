@@ -0,0 +1,40 @@
+#include "stats.hpp"
+#include "bench_timer.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace perf_monitor;
+
+// Cost of the update path every timed hook call goes through, on durations shaped like real
+// hook timings: mostly short with a long tail
+int main() {
+    const size_t iterations = 50000000;
+    std::mt19937_64 rng(3);
+    std::vector<uint64_t> durations(4096);
+    for (auto &duration: durations) {
+        duration = 200 + (rng() >> (40 + rng() % 24));
+    }
+
+    LatencyHistogram histogram;
+    RunBenchmark("LatencyHistogram::record", iterations, [&](size_t i) {
+        histogram.record(durations[i & 4095]);
+    });
+    KeepValue(&histogram);
+
+    TimingStats stats;
+    RunBenchmark("TimingStats::update (totals + histogram)", iterations, [&](size_t i) {
+        stats.update(durations[i & 4095]);
+    });
+    KeepValue(&stats);
+
+    uint64_t total = 0, slowest = 0;
+    RunBenchmark("totals only, no histogram", iterations, [&](size_t i) {
+        uint64_t duration = durations[i & 4095];
+        total += duration;
+        slowest = duration > slowest ? duration : slowest;
+        KeepValue(&total);
+    });
+    KeepValue(&slowest);
+    return 0;
+}
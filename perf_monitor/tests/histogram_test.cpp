@@ -0,0 +1,100 @@
+#include "stats.hpp"
+#include "test_check.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+using namespace perf_monitor;
+
+// Values below SUB_BUCKETS get a bucket each, then every power of two is split in SUB_BUCKETS
+static void TestBucketBoundaries() {
+    for (uint64_t value = 0; value < LatencyHistogram::SUB_BUCKETS; ++value) {
+        CHECK(LatencyHistogram::bucketIndex(value) == static_cast<int>(value));
+        CHECK(LatencyHistogram::bucketValue(static_cast<int>(value)) == value);
+    }
+    // [8, 16) is still one value per bucket, [16, 32) two per bucket
+    CHECK(LatencyHistogram::bucketIndex(8) == 8);
+    CHECK(LatencyHistogram::bucketIndex(15) == 15);
+    CHECK(LatencyHistogram::bucketIndex(16) == 16);
+    CHECK(LatencyHistogram::bucketIndex(17) == 16);
+    CHECK(LatencyHistogram::bucketIndex(18) == 17);
+    CHECK(LatencyHistogram::bucketIndex(31) == 23);
+    CHECK(LatencyHistogram::bucketIndex(32) == 24);
+
+    // Every bucket starts right after the previous one ends
+    int previous = static_cast<int>(LatencyHistogram::SUB_BUCKETS) - 1;
+    for (int magnitude = LatencyHistogram::SUB_BUCKET_BITS; magnitude < LatencyHistogram::MAX_MAGNITUDE; ++magnitude) {
+        uint64_t first = 1ULL << magnitude;
+        CHECK(LatencyHistogram::bucketIndex(first - 1) == previous);
+        CHECK(LatencyHistogram::bucketIndex(first) == previous + 1);
+        previous = LatencyHistogram::bucketIndex((first << 1) - 1);
+        CHECK(previous - LatencyHistogram::bucketIndex(first) == static_cast<int>(LatencyHistogram::SUB_BUCKETS) - 1);
+    }
+}
+
+static void TestMaxMagnitudeClamp() {
+    const int last = LatencyHistogram::BUCKET_COUNT - 1;
+    CHECK(LatencyHistogram::bucketIndex((1ULL << LatencyHistogram::MAX_MAGNITUDE) - 1) == last);
+    CHECK(LatencyHistogram::bucketIndex(1ULL << LatencyHistogram::MAX_MAGNITUDE) == last);
+    CHECK(LatencyHistogram::bucketIndex(std::numeric_limits<uint64_t>::max()) == last);
+
+    LatencyHistogram histogram;
+    histogram.record(std::numeric_limits<uint64_t>::max());
+    CHECK(histogram.buckets[last] == 1);
+    CHECK(histogram.percentile(100.0) == LatencyHistogram::bucketValue(last));
+}
+
+// Midpoints of a bucket 2^shift wide above 8 * 2^shift are off by at most 1/16
+static void TestPercentileErrorBound() {
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 1000000; ++i) {
+        uint64_t value = rng() >> (rng() % 64);
+        if (value >= (1ULL << LatencyHistogram::MAX_MAGNITUDE)) {
+            continue;
+        }
+        uint64_t estimate = LatencyHistogram::bucketValue(LatencyHistogram::bucketIndex(value));
+        uint64_t error = estimate > value ? estimate - value : value - estimate;
+        CHECK(error * 16 <= value);
+    }
+
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100000; ++value) {
+        histogram.record(value);
+    }
+    const double percents[] = {50.0, 95.0, 99.0, 99.9};
+    for (double percent: percents) {
+        double exact = percent / 100.0 * 100000.0;
+        double estimate = static_cast<double>(histogram.percentile(percent));
+        CHECK(estimate >= exact * (1.0 - 1.0 / 16) && estimate <= exact * (1.0 + 1.0 / 16));
+    }
+    CHECK(LatencyHistogram().percentile(99.0) == 0);
+}
+
+static void TestMerge() {
+    std::mt19937_64 rng(2);
+    LatencyHistogram first, second, combined;
+    for (int i = 0; i < 50000; ++i) {
+        uint64_t value = rng() % 1000000;
+        (i % 3 == 0 ? first : second).record(value);
+        combined.record(value);
+    }
+    first.merge(second);
+    CHECK(first.totalCount == combined.totalCount);
+    for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        CHECK(first.buckets[i] == combined.buckets[i]);
+    }
+    CHECK(first.percentile(99.9) == combined.percentile(99.9));
+
+    first.clear();
+    CHECK(first.totalCount == 0 && first.percentile(50.0) == 0);
+}
+
+int main() {
+    TestBucketBoundaries();
+    TestMaxMagnitudeClamp();
+    TestPercentileErrorBound();
+    TestMerge();
+    std::printf("histogram_test passed\n");
+    return 0;
+}
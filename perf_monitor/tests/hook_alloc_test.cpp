@@ -0,0 +1,211 @@
+#include "main.hpp"
+#include "config.hpp"
+#include "events.hpp"
+#include "hook_tiers.hpp"
+#include "logging.hpp"
+#include "stat_records.hpp"
+#include "stats.hpp"
+#include "test_check.hpp"
+#include "thread_shards.hpp"
+#include "timing.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Every allocation on the game thread while counting is on.  The stats worker and aggregator
+// allocate for the reports, that's off the game thread and allowed.
+static thread_local bool tCountAllocations = false;
+static uint64_t gAllocations = 0;
+
+void *operator new(size_t size) {
+    if (tCountAllocations) {
+        gAllocations++;
+    }
+    void *memory = std::malloc(size != 0 ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete[](void *memory) noexcept { std::free(memory); }
+
+void operator delete[](void *memory, size_t) noexcept { std::free(memory); }
+
+namespace perf_monitor {
+    // Hooks aren't declared in any header, the detours in main.cpp take their address directly
+    void IEvtQueueDispatchHook(hadesmem::PatchDetourBase *detour, uintptr_t *eventContext, EVENT_ID eventId,
+                               void *unk);
+    void RenderWorldHook(hadesmem::PatchDetourBase *detour, uintptr_t *worldFrame);
+    void PlaySpellVisualHook(hadesmem::PatchDetourBase *detour, uintptr_t *unit, uintptr_t *unk, uintptr_t *spellRec,
+                             uintptr_t *visualKit, void *param_3, void *param_4);
+    void DrawBatchHook(hadesmem::PatchDetourBase *detour, uintptr_t *this_ptr, void *dummy_edx);
+    void PaintScreenHook(hadesmem::PatchDetourBase *detour, uint32_t param_1, uint32_t param_2);
+    void FrameOnLayerUpdateHook(hadesmem::PatchDetourBase *detour, uintptr_t *frame, uint8_t unk, int unk2);
+    void FrameOnScriptEventHook(hadesmem::PatchDetourBase *detour, int *param_1, int *param_2);
+    void SignalEventHook(hadesmem::PatchDetourBase *detour, int eventCode);
+}
+
+using namespace perf_monitor;
+
+// A frame owned by a named addon, with an OnUpdate script (see FrameOnLayerUpdateHook) and the
+// addon name pointer pair FrameOnScriptEventHook gets
+struct MockScriptFrame {
+    uintptr_t words[0x128 + 1] = {};
+    uintptr_t addonName[2] = {};
+
+    explicit MockScriptFrame(const char *name) {
+        words[0x128] = 1;
+        words[75] = reinterpret_cast<uintptr_t>(name);
+        addonName[1] = reinterpret_cast<uintptr_t>(name);
+    }
+};
+
+static const char *const kAddonNames[] = {"pfUI", "BigWigs", "DBM", "Questie", "ShaguTweaks", "Bagnon",
+                                          "KTM", "Decursive", "SuperMacro", "Atlas", "Prat", "Auctioneer"};
+static const int kRaidEvents[] = {108, 112, 120, 137, 170, 204, 230, 260, 300, 320, 380, 400};
+
+static std::vector<MockScriptFrame *> gFrames;
+static hadesmem::PatchDetourBase gEventDetour, gFrameDetour, gSpellDetour, gDrawDetour, gPaintDetour,
+        gLayerUpdateDetour, gScriptEventDetour, gSignalDetour;
+static int gEventFanout = 0;
+
+static void MockEvent(uintptr_t *, EVENT_ID, void *) {}
+
+static void MockFrame(uintptr_t *) {}
+
+static void MockSpell(uintptr_t *, uintptr_t *, uintptr_t *, uintptr_t *, void *, void *) {}
+
+static void MockDraw(uintptr_t *, void *) {}
+
+static void MockPaint(uint32_t, uint32_t) {}
+
+static void MockLayerUpdate(uintptr_t *, uint8_t, int) {}
+
+static void MockScriptEvent(int *, int *) {}
+
+// Each event reaches a few addon frames, nested inside SignalEvent like in the client
+static void MockSignal(int eventCode) {
+    for (int i = 0; i < gEventFanout; ++i) {
+        MockScriptFrame *frame = gFrames[(i * 7 + static_cast<size_t>(eventCode)) % gFrames.size()];
+        FrameOnScriptEventHook(&gScriptEventDetour, reinterpret_cast<int *>(frame->words),
+                               reinterpret_cast<int *>(frame->addonName));
+    }
+}
+
+// One frame of a raid: events, every addon's OnUpdate, a spell visual with an id never seen
+// before, draw calls and the frame end, which closes the window when asked to
+static void RunFrame(uint32_t frameNumber, bool closeWindow) {
+    for (int e = 0; e < 4; ++e) {
+        IEvtQueueDispatchHook(&gEventDetour, nullptr, static_cast<EVENT_ID>(e * 5 % EVENTIDS), nullptr);
+    }
+    gEventFanout = 8;
+    for (int e = 0; e < 6; ++e) {
+        SignalEventHook(&gSignalDetour, kRaidEvents[(frameNumber + e) % 12]);
+    }
+    for (MockScriptFrame *frame: gFrames) {
+        FrameOnLayerUpdateHook(&gLayerUpdateDetour, frame->words, 0, 0);
+    }
+    uintptr_t spellRec[1] = {10000 + frameNumber};
+    PlaySpellVisualHook(&gSpellDetour, nullptr, nullptr, spellRec, nullptr, nullptr, nullptr);
+    for (int d = 0; d < 100; ++d) {
+        DrawBatchHook(&gDrawDetour, nullptr, nullptr);
+    }
+
+    if (closeWindow) {
+        // As if the window's 30 seconds were up
+        gStatsPeriodStartTime = static_cast<uint64_t>(TicksToMs(ReadTicks())) - STATS_OUTPUT_INTERVAL_MS;
+    }
+    RenderWorldHook(&gFrameDetour, nullptr);
+    PaintScreenHook(&gPaintDetour, 0, 0);
+}
+
+// Runs frames with a window closing every windowFrames, counting allocations when asked to.
+// Returns how many windows closed.
+static uint32_t RunFrames(uint32_t firstFrame, uint32_t frames, bool count) {
+    const uint32_t windowFrames = 250;
+    uint32_t epochBefore = gStatsEpoch.load();
+    for (uint32_t n = firstFrame; n < firstFrame + frames; ++n) {
+        tCountAllocations = count;
+        RunFrame(n, n % windowFrames == windowFrames - 1);
+
+        // Neither the cached name lookup nor a log line from the game thread
+        MockScriptFrame *frame = gFrames[n % gFrames.size()];
+        CHECK(resolveAddonId(frame->words, frame->addonName) != ADDON_NONE);
+        if (n % windowFrames == 0) {
+            DEBUG_LOG("Frame " << n << ": " << 16.7 << " ms, " << kAddonNames[n % 12]);
+        }
+        tCountAllocations = false;
+
+        // Let the stats worker finish the window's report so the next one can close
+        if (n % windowFrames == windowFrames - 1) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    return gStatsEpoch.load() - epochBefore;
+}
+
+static void TestSteadyStateDoesNotAllocate(const char *mode) {
+    static uint32_t nextFrame = 0;
+    // Warm-up sees every addon, event and window report for the first time
+    RunFrames(nextFrame, 500, false);
+    nextFrame += 500;
+
+    gAllocations = 0;
+    uint32_t windows = RunFrames(nextFrame, 2000, true);
+    nextFrame += 2000;
+    if (gAllocations != 0) {
+        std::fprintf(stderr, "%s: %llu allocations on the game thread after warm-up\n", mode,
+                     static_cast<unsigned long long>(gAllocations));
+    }
+    CHECK(windows > 1);
+    CHECK(gAllocations == 0);
+}
+
+int main() {
+    char directory[] = "/tmp/hook_alloc_testXXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    CHECK(chdir(directory) == 0);
+    CHECK(OpenLogFile("hook_alloc_test.log"));
+    CalibrateTimer();
+    SetGameThread();
+    initializeEventStats();
+    StartStatsWorker();
+    // GetLuaMemoryKB calls into the client
+    gConfig.tierMemory = 0;
+    ApplyHookTiers();
+    // The Ace blacklist ids are all 0 until the dll's init interns them, keep the addons off id 0
+    InternAddonName("Ace2", 4);
+
+    gEventDetour.trampoline = reinterpret_cast<void *>(&MockEvent);
+    gFrameDetour.trampoline = reinterpret_cast<void *>(&MockFrame);
+    gSpellDetour.trampoline = reinterpret_cast<void *>(&MockSpell);
+    gDrawDetour.trampoline = reinterpret_cast<void *>(&MockDraw);
+    gPaintDetour.trampoline = reinterpret_cast<void *>(&MockPaint);
+    gLayerUpdateDetour.trampoline = reinterpret_cast<void *>(&MockLayerUpdate);
+    gScriptEventDetour.trampoline = reinterpret_cast<void *>(&MockScriptEvent);
+    gSignalDetour.trampoline = reinterpret_cast<void *>(&MockSignal);
+
+    for (int i = 0; i < 48; ++i) {
+        gFrames.push_back(new MockScriptFrame(kAddonNames[i % 12]));
+    }
+
+    TestSteadyStateDoesNotAllocate("aggregator_thread=0");
+
+    // The same hooks queueing their stats for the aggregator instead
+    gConfig.aggregatorThread = 1;
+    CHECK(StartStatAggregator());
+    TestSteadyStateDoesNotAllocate("aggregator_thread=1");
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "main.hpp"
+#include "call_tree.hpp"
+#include "config.hpp"
+#include "hook_tiers.hpp"
+#include "logging.hpp"
+#include "stats.hpp"
+#include "test_check.hpp"
+#include "thread_shards.hpp"
+
+namespace perf_monitor {
+    // Hooks aren't declared in any header, the detours in main.cpp take their address directly
+    void OnWorldRenderHook(hadesmem::PatchDetourBase *detour, uintptr_t *worldFrame);
+    void CWorldRenderHook(hadesmem::PatchDetourBase *detour);
+    void DrawBatchHook(hadesmem::PatchDetourBase *detour, uintptr_t *this_ptr, void *dummy_edx);
+    void CM2ModelAnimateMTHook(hadesmem::PatchDetourBase *detour, uintptr_t *this_ptr, void *dummy_edx,
+                               float *param_1, float *param_2, float *param_3, float *param_4);
+    void FrameOnLayerUpdateHook(hadesmem::PatchDetourBase *detour, uintptr_t *frame, uint8_t unk, int unk2);
+}
+
+using namespace perf_monitor;
+
+// Mock originals, each counts how often the hook called through to it
+static int gOriginalCalls = 0;
+
+static void MockFrame(uintptr_t *) { gOriginalCalls++; }
+
+static void MockVoid() { gOriginalCalls++; }
+
+static void MockDraw(uintptr_t *, void *) { gOriginalCalls++; }
+
+static void MockAnimate(uintptr_t *, void *, float *, float *, float *, float *) { gOriginalCalls++; }
+
+static void MockLayerUpdate(uintptr_t *, uint8_t, int) { gOriginalCalls++; }
+
+static hadesmem::PatchDetourBase gFrameDetour, gVoidDetour, gDrawDetour, gAnimateDetour, gLayerUpdateDetour;
+
+// A frame with an OnUpdate script owned by a named addon, see FrameOnLayerUpdateHook
+struct MockScriptFrame {
+    uintptr_t words[0x128 + 1] = {};
+
+    explicit MockScriptFrame(const char *addonName) {
+        words[0x128] = 1;
+        words[75] = reinterpret_cast<uintptr_t>(addonName);
+    }
+};
+
+static uint64_t Calls(MetricId id) {
+    return ActiveStats().metrics.calls(id);
+}
+
+// Calls every render detail hook once, returns how many of them were timed
+static uint64_t CallRenderDetailHooks() {
+    uint64_t before = Calls(METRIC_CWORLD_RENDER) + Calls(METRIC_DRAW_BATCH) + Calls(METRIC_CM2_MODEL_ANIMATE_MT);
+    int originals = gOriginalCalls;
+    uintptr_t object[4] = {};
+    CWorldRenderHook(&gVoidDetour);
+    DrawBatchHook(&gDrawDetour, object, nullptr);
+    CM2ModelAnimateMTHook(&gAnimateDetour, object, nullptr, nullptr, nullptr, nullptr, nullptr);
+    // Disabled or not, the client's function always runs
+    CHECK(gOriginalCalls == originals + 3);
+    return Calls(METRIC_CWORLD_RENDER) + Calls(METRIC_DRAW_BATCH) + Calls(METRIC_CM2_MODEL_ANIMATE_MT) - before;
+}
+
+static void SetRenderDetailConfig(double enabled) {
+    gConfig.tierRenderDetail = enabled;
+    ApplyHookTiers();
+}
+
+static void TestDisabledTierIsNotTimed() {
+    SetRenderDetailConfig(1);
+    CHECK(CallRenderDetailHooks() == 3);
+
+    SetRenderDetailConfig(0);
+    CHECK(!HookTierEnabled(HOOK_TIER_RENDER_DETAIL));
+    size_t nodes = GetCallTreeNodeCount();
+    uint64_t skipped = ActiveStats().metrics.skipped[METRIC_CM2_MODEL_ANIMATE_MT];
+    CHECK(CallRenderDetailHooks() == 0);
+    // Not even counted as a skipped sample or entered into the call tree
+    CHECK(ActiveStats().metrics.skipped[METRIC_CM2_MODEL_ANIMATE_MT] == skipped);
+    CHECK(GetCallTreeNodeCount() == nodes);
+
+    // The minimal tier stays on
+    uint64_t worldRender = Calls(METRIC_ON_WORLD_RENDER);
+    uintptr_t worldFrame[4] = {};
+    OnWorldRenderHook(&gFrameDetour, worldFrame);
+    CHECK(Calls(METRIC_ON_WORLD_RENDER) == worldRender + 1);
+
+    // Re-enabled, as a config reload at the next window would
+    SetRenderDetailConfig(1);
+    CHECK(HookTierEnabled(HOOK_TIER_RENDER_DETAIL));
+    CHECK(CallRenderDetailHooks() == 3);
+}
+
+// The overhead controller turns a tier off over the config and gives it back
+static void TestSuppressedTier() {
+    SetRenderDetailConfig(1);
+    SuppressHookTiers(HOOK_TIER_RENDER_DETAIL);
+    CHECK((GetConfiguredHookTiers() & HOOK_TIER_RENDER_DETAIL) != 0);
+    CHECK(CallRenderDetailHooks() == 0);
+
+    SuppressHookTiers(0);
+    CHECK(CallRenderDetailHooks() == 3);
+}
+
+// With the memory tier off an addon OnUpdate is still timed but Lua memory is never read.  The
+// read calls into the client, so on the host it would crash rather than fail a check, and the
+// enabled side can't be run here.
+static void TestMemoryTierOff() {
+    gConfig.tierMemory = 0;
+    ApplyHookTiers();
+    CHECK(!HookTierEnabled(HOOK_TIER_MEMORY));
+
+    // The Ace blacklist ids are all 0 until the dll's init interns them, keep pfUI off id 0
+    InternAddonName("Ace2", 4);
+    MockScriptFrame frame("pfUI");
+    AddonId addonId = InternAddonName("pfUI", 4);
+    uint64_t onUpdate = Calls(METRIC_FRAME_ON_LAYER_UPDATE);
+    int originals = gOriginalCalls;
+    FrameOnLayerUpdateHook(&gLayerUpdateDetour, frame.words, 0, 0);
+    CHECK(gOriginalCalls == originals + 1);
+    CHECK(Calls(METRIC_FRAME_ON_LAYER_UPDATE) == onUpdate + 1);
+
+    const AddonStats *addon = ActiveStats().addons[addonId];
+    CHECK(addon != nullptr);
+    CHECK(addon->onUpdate.callCount == 1);
+    CHECK(addon->onUpdateMemory.callCount == 0);
+}
+
+int main() {
+    CHECK(OpenLogFile("hook_tier_test.log"));
+    CalibrateTimer();
+    SetGameThread();
+
+    gFrameDetour.trampoline = reinterpret_cast<void *>(&MockFrame);
+    gVoidDetour.trampoline = reinterpret_cast<void *>(&MockVoid);
+    gDrawDetour.trampoline = reinterpret_cast<void *>(&MockDraw);
+    gAnimateDetour.trampoline = reinterpret_cast<void *>(&MockAnimate);
+    gLayerUpdateDetour.trampoline = reinterpret_cast<void *>(&MockLayerUpdate);
+
+    TestDisabledTierIsNotTimed();
+    TestSuppressedTier();
+    TestMemoryTierOff();
+    return 0;
+}
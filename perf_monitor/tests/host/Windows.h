@@ -0,0 +1,27 @@
+#pragma once
+
+// Just enough of Windows.h for main.cpp in the host test build.  Calling conventions don't exist
+// on x86-64 Linux, and every pointer a test hands the hooks is readable.
+#include <cstddef>
+#include <cstdint>
+
+#define WINAPI
+#define __stdcall
+#define __fastcall
+#define __cdecl
+#define __thiscall
+#define __declspec(x)
+
+typedef int BOOL;
+typedef unsigned long DWORD;
+typedef void *PVOID;
+typedef void *HANDLE;
+typedef void *HINSTANCE;
+
+inline BOOL IsBadReadPtr(const void *, size_t) { return 0; }
+
+inline DWORD GetCurrentProcessId() { return 0; }
+
+inline HANDLE GetCurrentThread() { return nullptr; }
+
+inline DWORD GetCurrentThreadId() { return 0; }
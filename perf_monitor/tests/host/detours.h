@@ -0,0 +1,10 @@
+#pragma once
+
+// Detours is only used by the MSVC x86 naked hooks, which the host build leaves out
+inline long DetourTransactionBegin() { return 0; }
+
+inline long DetourUpdateThread(void *) { return 0; }
+
+inline long DetourAttach(void **, void *) { return 0; }
+
+inline long DetourTransactionCommit() { return 0; }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace hadesmem {
+    class Process;
+
+    // Tests call the hooks directly with a detour whose trampoline they point at a mock of the
+    // original function.  Nothing is ever patched.
+    class PatchDetourBase {
+    public:
+        virtual ~PatchDetourBase() = default;
+
+        template<typename T>
+        T GetTrampolineT() const {
+            return reinterpret_cast<T>(trampoline);
+        }
+
+        void Apply() {}
+
+        void Remove() {}
+
+        void *trampoline = nullptr;
+    };
+
+    template<typename T>
+    class PatchDetour : public PatchDetourBase {
+    public:
+        template<typename Hook>
+        PatchDetour(const Process &, T original, Hook) {
+            trampoline = reinterpret_cast<void *>(original);
+        }
+    };
+
+    namespace detail {
+        template<typename T, typename U>
+        T AliasCast(U value) {
+            return reinterpret_cast<T>(static_cast<uintptr_t>(value));
+        }
+    }
+}
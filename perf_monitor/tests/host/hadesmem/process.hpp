@@ -0,0 +1,8 @@
+#pragma once
+
+namespace hadesmem {
+    class Process {
+    public:
+        explicit Process(unsigned long) {}
+    };
+}
@@ -0,0 +1,113 @@
+#include "logging.hpp"
+#include "test_check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace perf_monitor;
+
+static const char *LOG_PATH = "logging_test.log";
+
+static std::string ReadLog() {
+    std::ifstream file(LOG_PATH);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+// The writer thread drains every few ms, wait until needle shows up or give up
+static bool WaitForLog(const std::string &needle) {
+    for (int i = 0; i < 400; ++i) {
+        if (ReadLog().find(needle) != std::string::npos) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+static int LoggingHelper(int value) {
+    DEBUG_LOG("inner line " << value);
+    return value * 2;
+}
+
+static std::atomic<bool> gOtherThreadLogged{false};
+
+// Streamed while the outer line is being formatted, returns once another thread got a line out
+static const char *WaitForOtherThread() {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!gOtherThreadLogged.load() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    return gOtherThreadLogged.load() ? "other thread was not blocked" : "other thread was blocked";
+}
+
+int main() {
+    CHECK(OpenLogFile(LOG_PATH));
+
+    // A streamed expression that logs itself used to spin on the producer lock forever
+    DEBUG_LOG("outer line " << LoggingHelper(21));
+    CHECK(WaitForLog("outer line 42"));
+    std::string log = ReadLog();
+    CHECK(log.find("inner line 21") != std::string::npos);
+    CHECK(log.find("inner line 21") < log.find("outer line 42"));
+
+    // Deeper than the formatters a thread has, the extra lines are dropped and counted
+    struct Nest {
+        static int log(int depth) {
+            if (depth > 0) {
+                DEBUG_LOG("nested " << depth << " " << log(depth - 1));
+            }
+            return depth;
+        }
+    };
+    Nest::log(6);
+    DEBUG_LOG("after nesting");
+    CHECK(WaitForLog("after nesting"));
+    log = ReadLog();
+    CHECK(log.find("nested 6 5") != std::string::npos && log.find("nested 3 2") != std::string::npos);
+    CHECK(log.find("nested 2 1") == std::string::npos && log.find("nested 1 0") == std::string::npos);
+    CHECK(log.find("[2 log lines dropped]") != std::string::npos);
+
+    // A slow expression on one thread doesn't hold up another thread's lines
+    std::thread slow([] { DEBUG_LOG("slow line: " << WaitForOtherThread()); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    DEBUG_LOG("fast line");
+    gOtherThreadLogged.store(true);
+    slow.join();
+    CHECK(WaitForLog("slow line: other thread was not blocked"));
+
+    // Lines from many threads come out whole, one per line
+    const int threadCount = 8, linesPerThread = 2000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < linesPerThread; ++i) {
+                DEBUG_LOG("thread " << t << " line " << i << " end");
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    DEBUG_LOG("all threads done");
+    CHECK(WaitForLog("all threads done"));
+    std::ifstream file(LOG_PATH);
+    std::string line;
+    int threadLines = 0;
+    while (std::getline(file, line)) {
+        if (line.find(": thread ") != std::string::npos) {
+            CHECK(line.size() > 4 && line.compare(line.size() - 4, 4, " end") == 0);
+            threadLines++;
+        }
+    }
+    CHECK(threadLines == threadCount * linesPerThread);
+
+    std::printf("logging_test passed\n");
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "stats.hpp"
+#include "bench_timer.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace perf_monitor;
+
+// MetricTable against the layout it replaced, one FunctionStats object per hooked function each
+// with its own heap name, updated and cleared one by one.  Both sides carry the same histogram.
+static FunctionStats gLegacyStats[METRIC_COUNT];
+static MetricTable gMetricTable;
+
+int main() {
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        gLegacyStats[i].name = kMetricInfo[i].name;
+    }
+
+    // Hook calls in the proportions of a busy frame: mostly draw batches, particles and animation
+    std::mt19937 rng(4);
+    std::vector<MetricId> ids(8192);
+    std::vector<uint64_t> durations(ids.size());
+    const MetricId hot[] = {METRIC_DRAW_BATCH, METRIC_DRAW_BATCH, METRIC_DRAW_BATCH, METRIC_DRAW_PARTICLE,
+                            METRIC_CM2_MODEL_ANIMATE_MT, METRIC_DRAW_CALLBACK};
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ids[i] = rng() % 4 != 0 ? hot[rng() % 6] : static_cast<MetricId>(rng() % METRIC_COUNT);
+        durations[i] = 300 + rng() % 5000;
+    }
+
+    const size_t iterations = 50000000;
+    RunBenchmark("update, FunctionStats per metric", iterations, [&](size_t i) {
+        gLegacyStats[ids[i & 8191]].update(durations[i & 8191]);
+    });
+    RunBenchmark("update, MetricTable", iterations, [&](size_t i) {
+        gMetricTable.update(ids[i & 8191], durations[i & 8191]);
+    });
+
+    const size_t resets = 200000;
+    RunBenchmark("window reset, clearStats() per metric", resets, [&](size_t) {
+        for (auto &stats: gLegacyStats) {
+            stats.clearStats();
+        }
+        KeepValue(gLegacyStats);
+    });
+    RunBenchmark("window reset, MetricTable::reset", resets, [&](size_t) {
+        gMetricTable.reset();
+        KeepValue(&gMetricTable);
+    });
+    return 0;
+}
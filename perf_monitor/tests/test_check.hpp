@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// assert() that stays on in Release builds
+#define CHECK(condition) ((condition) ? (void) 0 : perf_monitor::CheckFailed(#condition, __FILE__, __LINE__))
+
+namespace perf_monitor {
+    [[noreturn]] inline void CheckFailed(const char *condition, const char *file, int line) {
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, condition);
+        std::exit(1);
+    }
+}
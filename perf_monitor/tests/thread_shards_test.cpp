@@ -0,0 +1,99 @@
+#include "config.hpp"
+#include "logging.hpp"
+#include "metric_sampler.hpp"
+#include "monitor_overhead.hpp"
+#include "stat_records.hpp"
+#include "stats.hpp"
+#include "test_check.hpp"
+#include "thread_shards.hpp"
+#include "timing.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace perf_monitor;
+
+// More hooked threads than there are shards write while the game thread keeps closing windows.
+// Every update has to show up in exactly one reported window, whether its thread has a shard of
+// its own or takes turns on the shared one, and whether or not it raced an epoch flip.
+static void TestNoUpdateLost() {
+    const int threadCount = static_cast<int>(MAX_THREAD_SHARDS) + 4;
+    const uint64_t updatesPerThread = 200000;
+    const MetricId id = METRIC_CM2_MODEL_ANIMATE_MT;
+    uint64_t sessionBefore = gMetricSessionHistograms[id].totalCount;
+
+    std::atomic<int> running{threadCount};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&running, id, updatesPerThread] {
+            for (uint64_t i = 0; i < updatesPerThread; ++i) {
+                RecordMetric(id, 1);
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    // No stats worker, so each window is merged and reported right here while the threads write
+    uint64_t nowMs = 0;
+    unsigned windows = 0;
+    while (running.load() > 0) {
+        CHECK(RetireStatsWindow(++nowMs));
+        ++windows;
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    // Whatever the threads wrote after the last flip is in the active window
+    CHECK(RetireStatsWindow(++nowMs));
+
+    CHECK(windows > 1);
+    CHECK(gMetricSessionHistograms[id].totalCount - sessionBefore == threadCount * updatesPerThread);
+}
+
+// Only the client's worker threads call AnimateMT here, far over budget.  The overhead controller
+// has to see their calls when the window closes and raise the render hook sampling.
+static void TestOverheadCountsOtherThreads() {
+    const MetricId id = METRIC_CM2_MODEL_ANIMATE_MT;
+    const int threadCount = 4;
+    const uint64_t updatesPerThread = 100000;
+
+    // Give back whatever the controller took during the test above
+    gConfig.overheadBudgetPercent = 0;
+    uint64_t nowMs = gStatsPeriodStartTime;
+    CHECK(RetireStatsWindow(++nowMs));
+    CHECK(gMetricSamplers[id].sampleEvery == 1);
+
+    gConfig.overheadBudgetPercent = 2.0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([id, updatesPerThread] {
+            for (uint64_t i = 0; i < updatesPerThread; ++i) {
+                RecordMetric(id, 1);
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    // A millisecond long window, the calls' bookkeeping alone is well over 2% of it
+    CHECK(RetireStatsWindow(++nowMs));
+    CHECK(gMetricSamplers[id].sampleEvery >= 16);
+}
+
+int main() {
+    char directory[] = "/tmp/thread_shards_testXXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    CHECK(chdir(directory) == 0);
+    CHECK(OpenLogFile("thread_shards_test.log"));
+    CalibrateTimer();
+    SetGameThread();
+    CalibrateHookOverhead();
+
+    TestNoUpdateLost();
+    TestOverheadCountsOtherThreads();
+    return 0;
+}
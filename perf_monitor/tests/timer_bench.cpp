@@ -0,0 +1,73 @@
+#include "timing.hpp"
+#include "stats.hpp"
+#include "bench_timer.hpp"
+
+#include <chrono>
+
+using namespace perf_monitor;
+
+static int gWork = 0;
+
+// Stand in for the hooked function, about as short as DrawCallback
+static void ShortCall() {
+    gWork++;
+    KeepValue(&gWork);
+}
+
+// What every hook cost to time before ReadTicks: two clock reads and a microsecond conversion on
+// the game thread
+static void TimeWithChronoUs(TimingStats &stats, uint64_t &zeroCalls) {
+    auto start = std::chrono::high_resolution_clock::now();
+    ShortCall();
+    auto end = std::chrono::high_resolution_clock::now();
+    auto us = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    zeroCalls += us == 0.0;
+    stats.update(static_cast<uint64_t>(us));
+}
+
+static void TimeWithTicks(TimingStats &stats, uint64_t &zeroCalls) {
+    uint64_t start = ReadTicks();
+    ShortCall();
+    uint64_t duration = ReadTicks() - start;
+    zeroCalls += duration == 0;
+    stats.update(duration);
+}
+
+int main() {
+    CalibrateTimer();
+    const bool hasTsc = gTimerBackend == TimerBackend::Tsc;
+    const double tscTicksPerUs = gTicksPerUs;
+    std::printf("calibrated backend: %s, %.1f ticks/us\n", GetTimerBackendName(), gTicksPerUs);
+
+    const size_t iterations = 20000000;
+    TimingStats stats;
+    uint64_t zeroCalls = 0;
+
+    RunBenchmark("timed call, high_resolution_clock + us double", iterations, [&](size_t) {
+        TimeWithChronoUs(stats, zeroCalls);
+    });
+    std::printf("    %.1f%% of calls recorded as 0\n", 100.0 * zeroCalls / iterations);
+
+    gTimerBackend = TimerBackend::SteadyClock;
+    gTicksPerUs = 1000.0;
+    stats.clear();
+    zeroCalls = 0;
+    RunBenchmark("timed call, ReadTicks steady_clock backend", iterations, [&](size_t) {
+        TimeWithTicks(stats, zeroCalls);
+    });
+    std::printf("    %.1f%% of calls recorded as 0, mean %.1f ns\n", 100.0 * zeroCalls / iterations,
+                TicksToUs(stats.totalTime) * 1000.0 / iterations);
+
+    if (hasTsc) {
+        gTimerBackend = TimerBackend::Tsc;
+        gTicksPerUs = tscTicksPerUs;
+        stats.clear();
+        zeroCalls = 0;
+        RunBenchmark("timed call, ReadTicks TSC backend", iterations, [&](size_t) {
+            TimeWithTicks(stats, zeroCalls);
+        });
+        std::printf("    %.1f%% of calls recorded as 0, mean %.1f ns\n", 100.0 * zeroCalls / iterations,
+                    TicksToUs(stats.totalTime) * 1000.0 / iterations);
+    }
+    return 0;
+}
@@ -0,0 +1,489 @@
+#include "addon_names.hpp"
+#include "config.hpp"
+#include "events.hpp"
+#include "stats.hpp"
+#include "test_check.hpp"
+#include "timing.hpp"
+#include "window_report.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace perf_monitor;
+
+// What the exporter should write for one record, worked out from the window independently of
+// window_report.cpp.  Timing values are in ms: total, avg, max, min, p50, p95, p99, p99.9.  Memory
+// values are in KB: total, avg, max.
+struct ExpectedRecord {
+    std::string section;
+    std::string name;
+    long long id;
+    size_t calls;
+    bool memory;
+    std::vector<double> values;
+};
+
+static ExpectedRecord ExpectTiming(const char *section, const std::string &name, long long id, size_t calls,
+                                   uint64_t total, uint64_t slowest, uint64_t fastest,
+                                   const LatencyHistogram &histogram) {
+    ExpectedRecord record{section, name, id, calls, false, {}};
+    record.values.push_back(TicksToMs(total));
+    record.values.push_back(TicksToMs(total) / static_cast<double>(calls));
+    record.values.push_back(TicksToMs(slowest));
+    record.values.push_back(TicksToMs(fastest));
+    for (double percent: {50.0, 95.0, 99.0, 99.9}) {
+        uint64_t value = histogram.percentile(percent);
+        record.values.push_back(TicksToMs(std::min(std::max(value, fastest), slowest)));
+    }
+    return record;
+}
+
+static ExpectedRecord ExpectTiming(const char *section, const FunctionStats &stats, long long id) {
+    return ExpectTiming(section, stats.name, id, stats.callCount, stats.totalTime, stats.slowestTime,
+                        stats.fastestTime, stats.histogram);
+}
+
+static ExpectedRecord ExpectTiming(const char *section, const TimingStats &stats, const std::string &name) {
+    return ExpectTiming(section, name, -1, stats.callCount, stats.totalTime, stats.slowestTime, stats.fastestTime,
+                        stats.histogram);
+}
+
+static ExpectedRecord ExpectMemory(const char *section, const MemoryStats &stats, const std::string &name) {
+    return {section, name, -1, stats.callCount, true,
+            {static_cast<double>(stats.totalMemoryIncrease), stats.avgMemoryIncrease,
+             static_cast<double>(stats.maxMemoryIncrease)}};
+}
+
+// Every record of the window in report order
+static std::vector<ExpectedRecord> ExpectWindow(const StatsWindow &window) {
+    std::vector<ExpectedRecord> records;
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        auto id = static_cast<MetricId>(i);
+        if (window.metrics.counts[i] > 0) {
+            records.push_back(ExpectTiming("metrics", kMetricInfo[i].name, i, window.metrics.calls(id),
+                                           window.metrics.estimatedTotal(id), window.metrics.maxs[i],
+                                           window.metrics.mins[i], window.metrics.histograms[i]));
+        }
+    }
+    for (int id = 0; id < EVENT_ID_COUNT; ++id) {
+        if (window.eventStats[id].callCount > 0) {
+            records.push_back(ExpectTiming("events", window.eventStats[id], id));
+        }
+    }
+    for (int slot = 0; slot < static_cast<int>(window.eventCodeStats.size()); ++slot) {
+        if (window.eventCodeStats[slot].callCount > 0) {
+            long long code = slot <= MAX_EVENT_CODE ? slot : -1;
+            if (slot == OTHER_UI_EVENTS_SLOT) {
+                code = Events::OTHER_UI_EVENTS;
+            }
+            records.push_back(ExpectTiming("event_codes", window.eventCodeStats[slot], code));
+        }
+    }
+
+    const char *otherAddons = "Other addons/frames";
+    for (size_t i = 0; i < window.addonCount; ++i) {
+        if (window.addons[i] != nullptr && window.addons[i]->onUpdate.callCount > 0) {
+            records.push_back(ExpectTiming("addon_on_update", window.addons[i]->onUpdate,
+                                           GetAddonName(static_cast<AddonId>(i))));
+        }
+    }
+    if (window.otherAddons.onUpdate.callCount > 0) {
+        records.push_back(ExpectTiming("addon_on_update", window.otherAddons.onUpdate, otherAddons));
+    }
+    for (size_t i = 0; i < window.addonCount; ++i) {
+        if (window.addons[i] != nullptr && window.addons[i]->onEvent.callCount > 0) {
+            records.push_back(ExpectTiming("addon_on_event", window.addons[i]->onEvent,
+                                           GetAddonName(static_cast<AddonId>(i))));
+        }
+    }
+    if (window.otherAddons.onEvent.callCount > 0) {
+        records.push_back(ExpectTiming("addon_on_event", window.otherAddons.onEvent, otherAddons));
+    }
+    for (size_t i = 0; i < window.addonCount; ++i) {
+        if (window.addons[i] != nullptr && window.addons[i]->onUpdateMemory.callCount > 0) {
+            records.push_back(ExpectMemory("addon_on_update_memory", window.addons[i]->onUpdateMemory,
+                                           GetAddonName(static_cast<AddonId>(i))));
+        }
+    }
+    for (size_t i = 0; i < window.addonCount; ++i) {
+        if (window.addons[i] != nullptr && window.addons[i]->onEventMemory.callCount > 0) {
+            records.push_back(ExpectMemory("addon_on_event_memory", window.addons[i]->onEventMemory,
+                                           GetAddonName(static_cast<AddonId>(i))));
+        }
+    }
+
+    const SpellVisualTable &spellVisuals = window.spellVisualStats;
+    for (size_t slot = 0; slot < spellVisuals.size(); ++slot) {
+        if (spellVisuals.at(slot).callCount > 0) {
+            records.push_back(ExpectTiming("spell_visuals", spellVisuals.at(slot), spellVisuals.spellId(slot)));
+        }
+    }
+    return records;
+}
+
+// Just enough JSON for the NDJSON lines: objects, arrays, strings and numbers
+struct JsonValue {
+    enum Type { NUMBER, STRING, ARRAY, OBJECT } type = NUMBER;
+    double number = 0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue *member(const std::string &name) const {
+        for (const auto &entry: members) {
+            if (entry.first == name) {
+                return &entry.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string &text) : text(text) {}
+
+    JsonValue parseDocument() {
+        JsonValue value = parseValue();
+        CHECK(pos == text.size());
+        return value;
+    }
+
+private:
+    JsonValue parseValue() {
+        JsonValue value;
+        CHECK(pos < text.size());
+        if (text[pos] == '{') {
+            value.type = JsonValue::OBJECT;
+            ++pos;
+            while (text[pos] != '}') {
+                std::string name = parseString();
+                expect(':');
+                value.members.emplace_back(name, parseValue());
+                if (text[pos] == ',') {
+                    ++pos;
+                }
+            }
+            ++pos;
+        } else if (text[pos] == '[') {
+            value.type = JsonValue::ARRAY;
+            ++pos;
+            while (text[pos] != ']') {
+                value.items.push_back(parseValue());
+                if (text[pos] == ',') {
+                    ++pos;
+                }
+            }
+            ++pos;
+        } else if (text[pos] == '"') {
+            value.type = JsonValue::STRING;
+            value.text = parseString();
+        } else {
+            char *end;
+            value.number = std::strtod(text.c_str() + pos, &end);
+            CHECK(end != text.c_str() + pos);
+            pos = static_cast<size_t>(end - text.c_str());
+        }
+        return value;
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string result;
+        while (text[pos] != '"') {
+            if (text[pos] == '\\') {
+                ++pos;
+                if (text[pos] == 'u') {
+                    result += static_cast<char>(std::strtol(text.substr(pos + 1, 4).c_str(), nullptr, 16));
+                    pos += 5;
+                    continue;
+                }
+            }
+            result += text[pos++];
+        }
+        ++pos;
+        return result;
+    }
+
+    void expect(char c) {
+        CHECK(pos < text.size() && text[pos] == c);
+        ++pos;
+    }
+
+    const std::string &text;
+    size_t pos = 0;
+};
+
+// Printed with %.3f (%.1f for the KB average), so anything within half the last digit matches
+static bool Matches(double parsed, double expected, double precision) {
+    return std::fabs(parsed - expected) <= precision / 2 + 1e-9;
+}
+
+static const char *kTimingFields[] = {"total_ms", "avg_ms", "max_ms", "min_ms", "p50_ms", "p95_ms", "p99_ms",
+                                      "p999_ms"};
+static const char *kMemoryFields[] = {"total_kb", "avg_kb", "max_kb"};
+static const char *kSections[] = {"metrics", "events", "event_codes", "addon_on_update", "addon_on_event",
+                                  "addon_on_update_memory", "addon_on_event_memory", "spell_visuals"};
+
+static void CheckJsonWindow(const std::string &line, const StatsWindow &window, const char *windowEnd) {
+    JsonValue object = JsonParser(line).parseDocument();
+    CHECK(object.type == JsonValue::OBJECT);
+    CHECK(object.member("window_end")->text == windowEnd);
+    CHECK(object.member("start_ms")->number == static_cast<double>(window.startTime));
+    CHECK(object.member("end_ms")->number == static_cast<double>(window.endTime));
+    CHECK(object.member("frames")->number == static_cast<double>(window.endFrame - window.firstFrame));
+
+    std::vector<ExpectedRecord> expected = ExpectWindow(window);
+    size_t next = 0;
+    for (const char *section: kSections) {
+        const JsonValue *records = object.member(section);
+        CHECK(records != nullptr && records->type == JsonValue::ARRAY);
+        for (const JsonValue &record: records->items) {
+            CHECK(next < expected.size());
+            const ExpectedRecord &want = expected[next++];
+            CHECK(want.section == section);
+            CHECK(record.member("name")->text == want.name);
+            const JsonValue *id = record.member("id");
+            CHECK(want.id >= 0 ? id != nullptr && id->number == static_cast<double>(want.id) : id == nullptr);
+            CHECK(record.member("calls")->number == static_cast<double>(want.calls));
+            if (want.memory) {
+                for (size_t i = 0; i < 3; ++i) {
+                    CHECK(Matches(record.member(kMemoryFields[i])->number, want.values[i], i == 1 ? 0.1 : 1.0));
+                }
+            } else {
+                for (size_t i = 0; i < 8; ++i) {
+                    CHECK(Matches(record.member(kTimingFields[i])->number, want.values[i], 0.001));
+                }
+            }
+        }
+    }
+    CHECK(next == expected.size());
+}
+
+// Splits one CSV line, undoing the quoting of fields with commas or quotes in them
+static std::vector<std::string> SplitCsvLine(const std::string &line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+static void CheckCsvWindow(std::ifstream &file, const std::vector<ExpectedRecord> &expected,
+                           const std::string &windowEnd) {
+    for (const ExpectedRecord &want: expected) {
+        std::string line;
+        CHECK(std::getline(file, line));
+        std::vector<std::string> fields = SplitCsvLine(line);
+        CHECK(fields.size() == 14);
+        CHECK(fields[0] == windowEnd);
+        CHECK(fields[1] == want.section);
+        CHECK(fields[2] == want.name);
+        CHECK(want.id >= 0 ? fields[3] == std::to_string(want.id) : fields[3].empty());
+        CHECK(fields[4] == std::to_string(want.calls));
+        if (want.memory) {
+            for (size_t i = 0; i < 3; ++i) {
+                CHECK(Matches(std::strtod(fields[5 + i].c_str(), nullptr), want.values[i], i == 1 ? 0.1 : 1.0));
+            }
+            for (size_t i = 8; i < 13; ++i) {
+                CHECK(fields[i].empty());
+            }
+            CHECK(fields[13] == "kb");
+        } else {
+            for (size_t i = 0; i < 8; ++i) {
+                CHECK(Matches(std::strtod(fields[5 + i].c_str(), nullptr), want.values[i], 0.001));
+            }
+            CHECK(fields[13] == "ms");
+        }
+    }
+}
+
+// Something in every section, with names that need JSON escaping and CSV quoting, durations
+// spread over several orders of magnitude so the percentiles differ
+static void FillWindow(StatsWindow &window, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::lognormal_distribution<double> durationUs(4.0, 1.5);
+    auto duration = [&]() { return UsToTicks(durationUs(random)); };
+
+    window.clear();
+    window.startTime = 1000 * seed;
+    window.endTime = window.startTime + 30000;
+    window.endWallTime = 1700000000 + 30 * static_cast<std::time_t>(seed);
+    window.firstFrame = 100 * seed;
+    window.endFrame = window.firstFrame + 1800;
+
+    for (int i = 0; i < 500; ++i) {
+        window.metrics.update(METRIC_PAINT_SCREEN, duration());
+        window.metrics.update(METRIC_ON_WORLD_UPDATE, duration());
+        window.eventStats[EVENT_ID_IDLE].update(duration());
+        window.eventCodeStats[3].update(duration());
+    }
+    // A sampled hook reports every call and the scaled up total
+    for (int i = 0; i < 200; ++i) {
+        window.metrics.updateSampled(METRIC_CM2_MODEL_ANIMATE_MT, duration());
+        for (int skip = 0; skip < 3; ++skip) {
+            window.metrics.skip(METRIC_CM2_MODEL_ANIMATE_MT);
+        }
+    }
+    window.eventCodeStats[OTHER_UI_EVENTS_SLOT].update(duration());
+
+    const char *names[] = {"pfUI", "Quoted \"Frame\", with comma", "Tab\tName"};
+    for (const char *name: names) {
+        AddonId id = InternAddonName(name, std::strlen(name));
+        CHECK(id != ADDON_NONE);
+        AddonStats *addon = window.addon(id);
+        for (int i = 0; i < 50; ++i) {
+            addon->onUpdate.update(duration());
+            addon->onEvent.update(duration());
+            addon->onUpdateMemory.update(static_cast<int>(random() % 40));
+            addon->onEventMemory.update(static_cast<int>(random() % 7));
+        }
+        // A few event codes each, for the addon x event export
+        for (int slot: {3, 120, 400}) {
+            for (int i = 0; i < 10; ++i) {
+                CHECK(window.addonEvents.record(id, slot, duration()));
+            }
+        }
+    }
+
+    for (uint32_t spellId: {133u, 10187u, 25304u}) {
+        FunctionStats &stats = window.spellVisualStats.find(spellId);
+        for (int i = 0; i < 20; ++i) {
+            stats.update(duration());
+        }
+    }
+}
+
+static std::string WindowEnd(const StatsWindow &window) {
+    std::tm end_tm;
+    localtime_r(&window.endWallTime, &end_tm);
+    char windowEnd[32];
+    std::strftime(windowEnd, sizeof(windowEnd), "%Y-%m-%d %H:%M:%S", &end_tm);
+    return windowEnd;
+}
+
+// Two windows appended to both files, parsed back and compared record by record
+static void TestRoundTrip() {
+    StatsWindow &window = gStatsWindows[0];
+    window.config.reportNdjson = 1.0;
+    window.config.reportCsv = 1.0;
+    // A reload on the game thread after the window closed doesn't change what its report writes
+    gConfig.reportNdjson = 0;
+    gConfig.reportCsv = 0;
+    FillWindow(window, 1);
+    std::vector<ExpectedRecord> first = ExpectWindow(window);
+    std::string firstEnd = WindowEnd(window);
+    ExportWindowReport(window);
+    std::string firstLine;
+    {
+        std::ifstream ndjson("perf_monitor_windows.ndjson");
+        CHECK(std::getline(ndjson, firstLine));
+        CheckJsonWindow(firstLine, window, firstEnd.c_str());
+    }
+
+    // Every section had something in it
+    for (const char *section: kSections) {
+        CHECK(std::any_of(first.begin(), first.end(),
+                          [&](const ExpectedRecord &record) { return record.section == section; }));
+    }
+
+    FillWindow(window, 2);
+    std::string secondEnd = WindowEnd(window);
+    ExportWindowReport(window);
+
+    std::ifstream ndjson("perf_monitor_windows.ndjson");
+    std::string line;
+    CHECK(std::getline(ndjson, line) && line == firstLine);
+    CHECK(std::getline(ndjson, line));
+    CheckJsonWindow(line, window, secondEnd.c_str());
+    CHECK(!std::getline(ndjson, line));
+
+    std::ifstream csv("perf_monitor_windows.csv");
+    CHECK(std::getline(csv, line) && line == "window_end,section,name,id,calls,total,avg,max,min,p50,p95,p99,p999,unit");
+    CheckCsvWindow(csv, first, firstEnd);
+    CheckCsvWindow(csv, ExpectWindow(window), secondEnd);
+    CHECK(!std::getline(csv, line));
+}
+
+// Off by default, and when on only the report_addon_events slowest cells per window with the
+// names quoted like the other CSV
+static void TestAddonEvents() {
+    std::ifstream missing("perf_monitor_addon_events.csv");
+    CHECK(!missing);
+
+    StatsWindow &window = gStatsWindows[0];
+    window.config.reportNdjson = 0;
+    window.config.reportCsv = 0;
+    window.config.reportAddonEvents = 4;
+    FillWindow(window, 3);
+
+    struct Cell {
+        std::string addon;
+        std::string event;
+        uint64_t totalTime;
+        uint32_t count;
+        uint64_t maxTime;
+    };
+    std::vector<Cell> cells;
+    window.addonEvents.forEachCell([&](AddonId addonId, int eventSlot, const AddonEventCell &cell) {
+        cells.push_back({GetAddonName(addonId), window.eventCodeStats[eventSlot].name, cell.totalTime, cell.count,
+                         cell.maxTime});
+    });
+    CHECK(cells.size() == 9);
+    std::sort(cells.begin(), cells.end(), [](const Cell &a, const Cell &b) { return a.totalTime > b.totalTime; });
+
+    std::string windowEnd = WindowEnd(window);
+    ExportWindowReport(window);
+    std::ifstream csv("perf_monitor_addon_events.csv");
+    std::string line;
+    CHECK(std::getline(csv, line) && line == "window_end,addon,event,total_ms,count,max_ms");
+    for (size_t i = 0; i < 4; ++i) {
+        CHECK(std::getline(csv, line));
+        std::vector<std::string> fields = SplitCsvLine(line);
+        CHECK(fields.size() == 6);
+        CHECK(fields[0] == windowEnd);
+        CHECK(fields[1] == cells[i].addon);
+        CHECK(fields[2] == cells[i].event);
+        CHECK(Matches(std::atof(fields[3].c_str()), TicksToMs(cells[i].totalTime), 0.001));
+        CHECK(std::strtoul(fields[4].c_str(), nullptr, 10) == cells[i].count);
+        CHECK(Matches(std::atof(fields[5].c_str()), TicksToMs(cells[i].maxTime), 0.001));
+    }
+    CHECK(!std::getline(csv, line));
+}
+
+int main() {
+    // The exporter writes to the working directory
+    char directory[] = "/tmp/window_report_testXXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    CHECK(chdir(directory) == 0);
+
+    initializeEventStats();
+    TestRoundTrip();
+    TestAddonEvents();
+    return 0;
+}
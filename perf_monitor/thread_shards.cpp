@@ -0,0 +1,147 @@
+#include "thread_shards.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace perf_monitor {
+    // One thread's tables, indexed by window epoch & 1 like gStatsWindows.  Only the writing
+    // thread touches a table, it resets the one it is about to use the first time it sees a new
+    // epoch and then publishes that epoch so the stats worker knows the table belongs to it.
+    struct alignas(CACHE_LINE_SIZE) MetricShard {
+        MetricTable tables[2];
+        std::atomic<uint32_t> epochs[2]; // epoch + 1 of the window each table holds, 0 for none
+        // Odd while a thread is writing a table.  The writer makes it odd before it reads the
+        // epoch and the stats worker waits for it to be even after the epoch moved on, so an
+        // update either lands in the table before the worker reads it or goes to the next window.
+        std::atomic<uint32_t> sequence;
+        uint32_t threadId;
+    };
+
+    thread_local bool tIsGameThread = false;
+
+    static MetricShard gMetricShards[MAX_THREAD_SHARDS];
+    static std::atomic<size_t> gMetricShardCount{0};
+    // Every thread past MAX_THREAD_SHARDS writes this one, one at a time
+    static MetricShard gSharedMetricShard;
+    static std::mutex gSharedMetricShardMutex;
+    static std::atomic<bool> gShardOverflowLogged{false};
+    static uint32_t gGameThreadId = 0;
+    static thread_local MetricShard *tMetricShard = nullptr;
+
+    static uint32_t CurrentThreadId() {
+#ifdef _WIN32
+        return static_cast<uint32_t>(GetCurrentThreadId());
+#else
+        return static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+    }
+
+    void SetGameThread() {
+        tIsGameThread = true;
+        gGameThreadId = CurrentThreadId();
+    }
+
+    static MetricShard &ClaimMetricShard() {
+        size_t index = gMetricShardCount.fetch_add(1, std::memory_order_relaxed);
+        if (index >= MAX_THREAD_SHARDS) {
+            // More hooked threads than shards, the rest take turns on the shared one
+            if (!gShardOverflowLogged.exchange(true, std::memory_order_relaxed)) {
+                DEBUG_LOG("More than " << MAX_THREAD_SHARDS
+                                       << " threads call hooked functions, the extra threads share a locked stats shard");
+            }
+            return gSharedMetricShard;
+        }
+
+        // Published to the worker together with the shard's first epoch
+        MetricShard &shard = gMetricShards[index];
+        shard.threadId = CurrentThreadId();
+        return shard;
+    }
+
+    // Applies write to the shard's table for the active window
+    template<typename Write>
+    static void WriteShard(MetricShard &shard, Write write) {
+        uint32_t sequence = shard.sequence.load(std::memory_order_relaxed);
+        // Both sequentially consistent, pairs with the epoch flip and the load in WaitForShardWriter
+        shard.sequence.store(sequence + 1);
+        uint32_t epoch = gStatsEpoch.load();
+
+        uint32_t slot = epoch & 1;
+        if (shard.epochs[slot].load(std::memory_order_relaxed) != epoch + 1) {
+            shard.tables[slot].reset();
+            shard.epochs[slot].store(epoch + 1, std::memory_order_relaxed);
+        }
+        write(shard.tables[slot]);
+        shard.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    template<typename Write>
+    static void WriteThreadShard(Write write) {
+        if (tMetricShard == nullptr) {
+            tMetricShard = &ClaimMetricShard();
+        }
+        if (tMetricShard == &gSharedMetricShard) {
+            std::lock_guard<std::mutex> lock(gSharedMetricShardMutex);
+            WriteShard(*tMetricShard, write);
+            return;
+        }
+        WriteShard(*tMetricShard, write);
+    }
+
+    void OffThreadUpdate(MetricId id, uint64_t duration) {
+        WriteThreadShard([=](MetricTable &table) { table.update(id, duration); });
+    }
+
+    void OffThreadUpdateSampled(MetricId id, uint64_t duration) {
+        WriteThreadShard([=](MetricTable &table) { table.updateSampled(id, duration); });
+    }
+
+    void OffThreadSkip(MetricId id) {
+        WriteThreadShard([=](MetricTable &table) { table.skip(id); });
+    }
+
+    // A writer that started before the epoch flip may still hold the closed window's table
+    static void WaitForShardWriter(const MetricShard &shard) {
+        while (shard.sequence.load() & 1) {
+            std::this_thread::yield();
+        }
+    }
+
+    static void RecordThreadTotals(ThreadMetricTotals &thread, uint32_t threadId, const MetricTable &table) {
+        thread.threadId = threadId;
+        for (int i = 0; i < METRIC_COUNT; ++i) {
+            auto id = static_cast<MetricId>(i);
+            thread.calls[i] = table.calls(id);
+            thread.totals[i] = table.estimatedTotal(id);
+        }
+    }
+
+    static void MergeShard(StatsWindow &window, const MetricShard &shard, uint32_t threadId) {
+        WaitForShardWriter(shard);
+        uint32_t slot = window.epoch & 1;
+        if (shard.epochs[slot].load(std::memory_order_acquire) != window.epoch + 1) {
+            return; // no hooked calls on the shard's threads during this window
+        }
+        const MetricTable &table = shard.tables[slot];
+        RecordThreadTotals(window.threads[window.threadCount++], threadId, table);
+        window.metrics.merge(table);
+    }
+
+    void MergeThreadShards(StatsWindow &window) {
+        RecordThreadTotals(window.threads[0], gGameThreadId, window.metrics);
+        window.threadCount = 1;
+
+        size_t shardCount = std::min(gMetricShardCount.load(std::memory_order_relaxed), MAX_THREAD_SHARDS);
+        for (size_t i = 0; i < shardCount; ++i) {
+            MergeShard(window, gMetricShards[i], gMetricShards[i].threadId);
+        }
+        MergeShard(window, gSharedMetricShard, SHARED_SHARD_THREAD_ID);
+    }
+}
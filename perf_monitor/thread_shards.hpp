@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include "stats.hpp"
+
+namespace perf_monitor {
+    // Hooks such as CM2Model::AnimateMT also run on the client's worker threads.  The game thread
+    // writes the active window's MetricTable directly, every other thread gets its own shard: a
+    // cache line aligned pair of MetricTables, one per window, that only that thread writes and
+    // that are merged into the window when it closes.  Threads past MAX_THREAD_SHARDS
+    // share one more shard and take a lock to write it.
+    extern thread_local bool tIsGameThread;
+
+    // Call from the game thread before any hook is installed
+    void SetGameThread();
+
+    inline bool IsGameThread() {
+        return tIsGameThread;
+    }
+
+    // Off the game thread, claim the calling thread's shard on first use and apply one
+    // MetricTable update to its table for the active window
+    void OffThreadUpdate(MetricId id, uint64_t duration);
+    void OffThreadUpdateSampled(MetricId id, uint64_t duration);
+    void OffThreadSkip(MetricId id);
+
+    // The MetricTable updates a hook on the calling thread should make
+    inline void UpdateThreadMetric(MetricId id, uint64_t duration) {
+        if (tIsGameThread) {
+            ActiveStats().metrics.update(id, duration);
+            return;
+        }
+        OffThreadUpdate(id, duration);
+    }
+
+    inline void UpdateThreadMetricSampled(MetricId id, uint64_t duration) {
+        if (tIsGameThread) {
+            ActiveStats().metrics.updateSampled(id, duration);
+            return;
+        }
+        OffThreadUpdateSampled(id, duration);
+    }
+
+    inline void SkipThreadMetric(MetricId id) {
+        if (tIsGameThread) {
+            ActiveStats().metrics.skip(id);
+            return;
+        }
+        OffThreadSkip(id);
+    }
+
+    // Game thread, once gStatsEpoch moved past the window and before the overhead controller looks
+    // at it.  Records the game thread's and every shard's totals in window.threads and folds the
+    // shards' tables for the window into window.metrics.  Waits out any shard update that started
+    // before the epoch moved on, so none of them is lost.
+    void MergeThreadShards(StatsWindow &window);
+}
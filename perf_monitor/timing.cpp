@@ -0,0 +1,60 @@
+#include "timing.hpp"
+
+#include <thread>
+
+#if !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace perf_monitor {
+    TimerBackend gTimerBackend = TimerBackend::SteadyClock;
+    double gTicksPerUs = 1000.0; // steady clock ticks are nanoseconds
+
+    // CPUID.80000007H:EDX[8] - TSC runs at a constant rate across P/C states
+    static bool HasInvariantTsc() {
+        unsigned int regs[4] = {};
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0x80000000);
+        if (static_cast<unsigned int>(info[0]) < 0x80000007) {
+            return false;
+        }
+        __cpuid(info, 0x80000007);
+        regs[3] = static_cast<unsigned int>(info[3]);
+#else
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+            return false;
+        }
+        __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+        return (regs[3] & (1u << 8)) != 0;
+    }
+
+    void CalibrateTimer() {
+        if (!HasInvariantTsc()) {
+            gTimerBackend = TimerBackend::SteadyClock;
+            gTicksPerUs = 1000.0;
+            return;
+        }
+
+        auto clockStart = std::chrono::steady_clock::now();
+        uint64_t tscStart = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        uint64_t tscEnd = __rdtsc();
+        auto clockEnd = std::chrono::steady_clock::now();
+
+        auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(clockEnd - clockStart).count();
+        if (elapsedNs <= 0 || tscEnd <= tscStart) {
+            gTimerBackend = TimerBackend::SteadyClock;
+            gTicksPerUs = 1000.0;
+            return;
+        }
+
+        gTicksPerUs = static_cast<double>(tscEnd - tscStart) * 1000.0 / static_cast<double>(elapsedNs);
+        gTimerBackend = TimerBackend::Tsc;
+    }
+
+    const char *GetTimerBackendName() {
+        return gTimerBackend == TimerBackend::Tsc ? "invariant TSC" : "steady_clock";
+    }
+}
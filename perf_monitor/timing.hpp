@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+namespace perf_monitor {
+    enum class TimerBackend {
+        Tsc,         // invariant time stamp counter, raw cpu ticks
+        SteadyClock  // std::chrono::steady_clock nanoseconds, used when the TSC isn't invariant
+    };
+
+    extern TimerBackend gTimerBackend;
+    extern double gTicksPerUs;
+
+    // Raw timestamp in backend ticks.  Hooks only ever subtract these, conversion to
+    // time units is deferred until the stats are output.
+    inline uint64_t ReadTicks() {
+        if (gTimerBackend == TimerBackend::Tsc) {
+            return __rdtsc();
+        }
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    inline double TicksToUs(uint64_t ticks) {
+        return static_cast<double>(ticks) / gTicksPerUs;
+    }
+
+    inline double TicksToMs(uint64_t ticks) {
+        return TicksToUs(ticks) / 1000.0;
+    }
+
+    inline uint64_t UsToTicks(double us) {
+        return static_cast<uint64_t>(us * gTicksPerUs);
+    }
+
+    // Picks the backend and measures the TSC frequency against the steady clock.
+    // Must run once before any hook is installed.
+    void CalibrateTimer();
+
+    const char *GetTimerBackendName();
+}
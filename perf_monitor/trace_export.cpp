@@ -0,0 +1,177 @@
+#include "trace_export.hpp"
+#include "config.hpp"
+#include "events.hpp"
+#include "spsc_ring.hpp"
+#include "stats.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace perf_monitor {
+    bool gTraceRunning = false;
+
+    constexpr size_t TRACE_RING_SIZE = 1 << 22; // 131072 spans
+    constexpr size_t TRACE_FILE_BUFFER_SIZE = 1 << 20;
+    constexpr int TRACE_WRITER_IDLE_MS = 5;
+
+    static_assert(TRACE_RING_SIZE % sizeof(Span) == 0, "Spans must never straddle the ring wrap");
+
+    static SpscByteRing<TRACE_RING_SIZE> gTraceRing;
+    static std::FILE *gTraceFile = nullptr;
+    static uint64_t gTraceStartTicks = 0;
+    static uint64_t gTraceEndTicks = 0;
+    static bool gTraceArmed = false;
+    static std::atomic<bool> gTraceFinished{false};
+    static std::atomic<size_t> gTraceDroppedSpans{0};
+
+    void PushTraceSpan(const Span &span) {
+        if (!gTraceRing.tryPush(reinterpret_cast<const char *>(&span), sizeof(Span))) {
+            gTraceDroppedSpans.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void UpdateTraceWindow(uint64_t nowTicks) {
+        if (!gTraceArmed) {
+            return;
+        }
+        if (!gTraceRunning && nowTicks >= gTraceStartTicks) {
+            gTraceRunning = true;
+        }
+        if (gTraceRunning && nowTicks >= gTraceEndTicks) {
+            gTraceRunning = false;
+            gTraceArmed = false;
+            // Every span pushed so far is in the ring before the writer sees this
+            gTraceFinished.store(true, std::memory_order_release);
+        }
+    }
+
+    static void WriteJsonString(std::FILE *file, const char *text) {
+        std::fputc('"', file);
+        for (const char *c = text; *c != '\0'; ++c) {
+            if (*c == '"' || *c == '\\') {
+                std::fputc('\\', file);
+                std::fputc(*c, file);
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                std::fprintf(file, "\\u%04x", static_cast<unsigned char>(*c));
+            } else {
+                std::fputc(*c, file);
+            }
+        }
+        std::fputc('"', file);
+    }
+
+    static void WriteEventName(std::FILE *file, int eventCode) {
+        const char *eventName = GetEventName(eventCode);
+        if (eventName != nullptr) {
+            WriteJsonString(file, eventName);
+        } else {
+            std::fprintf(file, "\"UNKNOWN_EVENT_%d\"", eventCode);
+        }
+    }
+
+    // One complete ("X") event per span, a begin/end pair in a single record
+    static void WriteTraceSpan(std::FILE *file, const Span &span) {
+        double ts = (static_cast<double>(span.start) - static_cast<double>(gTraceStartTicks)) / gTicksPerUs;
+
+        std::fputs(",\n{\"name\":", file);
+        switch (span.kind) {
+            case SPAN_HOOK:
+                WriteJsonString(file, kMetricInfo[span.metric].name);
+                std::fputs(",\"cat\":\"hook\"", file);
+                break;
+            case SPAN_SIGNAL_EVENT:
+                WriteEventName(file, span.eventCode);
+                std::fputs(",\"cat\":\"event\"", file);
+                break;
+            default:
+                WriteJsonString(file, GetAddonName(span.addonId));
+                std::fputs(span.kind == SPAN_ADDON_ON_UPDATE ? ",\"cat\":\"OnUpdate\"" : ",\"cat\":\"OnEvent\"", file);
+                break;
+        }
+        std::fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1", ts,
+                     TicksToUs(span.duration));
+
+        switch (span.kind) {
+            case SPAN_HOOK:
+                break;
+            case SPAN_SIGNAL_EVENT:
+                std::fprintf(file, ",\"args\":{\"event_code\":%d}", span.eventCode);
+                break;
+            case SPAN_ADDON_EVENT:
+                std::fputs(",\"args\":{\"addon\":", file);
+                WriteJsonString(file, GetAddonName(span.addonId));
+                std::fputs(",\"event\":", file);
+                WriteEventName(file, span.eventCode);
+                std::fprintf(file, ",\"event_code\":%d,\"lua_kb\":%d}", span.eventCode, span.memoryDelta);
+                break;
+            case SPAN_ADDON_ON_UPDATE:
+                std::fputs(",\"args\":{\"addon\":", file);
+                WriteJsonString(file, GetAddonName(span.addonId));
+                std::fprintf(file, ",\"lua_kb\":%d}", span.memoryDelta);
+                break;
+        }
+        std::fputc('}', file);
+    }
+
+    static void TraceWriterThread() {
+        std::fputs("[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"WoW\"}},\n"
+                   "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Game thread\"}}",
+                   gTraceFile);
+
+        bool pendingFlush = false;
+        while (true) {
+            // Read the flag first, anything pushed before it was set is visible below
+            bool finished = gTraceFinished.load(std::memory_order_acquire);
+
+            const char *data;
+            size_t size = gTraceRing.peek(&data);
+            if (size == 0) {
+                if (finished) {
+                    break;
+                }
+                if (pendingFlush) {
+                    std::fflush(gTraceFile);
+                    pendingFlush = false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(TRACE_WRITER_IDLE_MS));
+                continue;
+            }
+
+            size_t spanCount = size / sizeof(Span);
+            for (size_t i = 0; i < spanCount; ++i) {
+                Span span;
+                std::memcpy(&span, data + i * sizeof(Span), sizeof(Span));
+                WriteTraceSpan(gTraceFile, span);
+            }
+            gTraceRing.consume(spanCount * sizeof(Span));
+            pendingFlush = true;
+        }
+
+        std::fprintf(gTraceFile, ",\n{\"name\":\"dropped spans\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":1,"
+                                 "\"args\":{\"count\":%zu}}\n]\n",
+                     TicksToUs(gTraceEndTicks - gTraceStartTicks), gTraceDroppedSpans.load(std::memory_order_relaxed));
+        std::fclose(gTraceFile);
+        gTraceFile = nullptr;
+    }
+
+    bool StartTraceExport(const char *path) {
+        if (gTraceArmed || gConfig.traceSeconds <= 0) {
+            return false;
+        }
+
+        gTraceFile = std::fopen(path, "wb");
+        if (!gTraceFile) {
+            return false;
+        }
+        std::setvbuf(gTraceFile, nullptr, _IOFBF, TRACE_FILE_BUFFER_SIZE);
+
+        gTraceStartTicks = ReadTicks() + UsToTicks(gConfig.traceStartSeconds * 1000000.0);
+        gTraceEndTicks = gTraceStartTicks + UsToTicks(gConfig.traceSeconds * 1000000.0);
+        gTraceArmed = true;
+        // Exits on its own once the trace window has closed and the ring is drained
+        std::thread(TraceWriterThread).detach();
+        return true;
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include "hitch_capture.hpp"
+
+namespace perf_monitor {
+    // Game thread only, true between the configured trace start and end
+    extern bool gTraceRunning;
+
+    inline bool IsTraceRunning() {
+        return gTraceRunning;
+    }
+
+    // Copies the raw span into the trace ring, the writer thread turns it into JSON.  Spans are
+    // dropped and counted when the writer falls behind.
+    void PushTraceSpan(const Span &span);
+
+    // Called once per frame, starts and stops the trace at the times set in the config
+    void UpdateTraceWindow(uint64_t nowTicks);
+
+    // Opens a Chrome trace (JSON array format, loadable by chrome://tracing and Perfetto) and starts
+    // its writer if gConfig.traceSeconds is set.  Call after CalibrateTimer and LoadConfigFile.
+    bool StartTraceExport(const char *path);
+}
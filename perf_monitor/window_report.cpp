@@ -0,0 +1,349 @@
+#include "window_report.hpp"
+#include "events.hpp"
+#include "stats.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+namespace perf_monitor {
+    static const char *WINDOW_NDJSON_PATH = "perf_monitor_windows.ndjson";
+    static const char *WINDOW_CSV_PATH = "perf_monitor_windows.csv";
+    static const char *ADDON_EVENTS_CSV_PATH = "perf_monitor_addon_events.csv";
+
+    // One row of a timing table, durations in timer ticks
+    struct TimingRecord {
+        const char *name;
+        long long id; // metric, event code or spell id, -1 when the name is the only key
+        size_t calls;
+        uint64_t totalTime;
+        uint64_t slowestTime;
+        uint64_t fastestTime;
+        const LatencyHistogram *histogram;
+
+        double avgMs() const {
+            return calls > 0 ? TicksToMs(totalTime) / static_cast<double>(calls) : 0.0;
+        }
+
+        // Clamped like the text report, bucket midpoints can fall outside the exact extremes
+        double percentileMs(double percent) const {
+            uint64_t value = histogram->percentile(percent);
+            return TicksToMs(std::min(std::max(value, fastestTime), slowestTime));
+        }
+    };
+
+    static TimingRecord MakeTimingRecord(const TimingStats &stats, const char *name, long long id) {
+        return {name, id, stats.callCount, stats.totalTime, stats.slowestTime, stats.fastestTime, &stats.histogram};
+    }
+
+    // Code SignalEvent was called with for an event code slot, -1 for the unknown events slot
+    static long long EventCodeOfSlot(int slot) {
+        if (slot <= MAX_EVENT_CODE) {
+            return slot;
+        }
+        return slot == OTHER_UI_EVENTS_SLOT ? static_cast<long long>(Events::OTHER_UI_EVENTS) : -1;
+    }
+
+    // Feeds every non-empty stat of the window to sink, grouped into sections in report order
+    template<typename Sink>
+    static void WalkWindow(const StatsWindow &window, Sink &sink) {
+        const MetricTable &metrics = window.metrics;
+        sink.beginSection("metrics");
+        for (int i = 0; i < METRIC_COUNT; ++i) {
+            auto id = static_cast<MetricId>(i);
+            if (metrics.counts[i] > 0) {
+                // Sampled hooks report every call and the scaled up total, like the text report
+                sink.timing({kMetricInfo[i].name, i, static_cast<size_t>(metrics.calls(id)), metrics.estimatedTotal(id),
+                             metrics.maxs[i], metrics.mins[i], &metrics.histograms[i]});
+            }
+        }
+        sink.endSection();
+
+        sink.beginSection("events");
+        for (int id = 0; id < EVENT_ID_COUNT; ++id) {
+            const FunctionStats &stats = window.eventStats[id];
+            if (stats.callCount > 0) {
+                sink.timing(MakeTimingRecord(stats, stats.name.c_str(), id));
+            }
+        }
+        sink.endSection();
+
+        sink.beginSection("event_codes");
+        for (size_t slot = 0; slot < window.eventCodeStats.size(); ++slot) {
+            const FunctionStats &stats = window.eventCodeStats[slot];
+            if (stats.callCount > 0) {
+                sink.timing(MakeTimingRecord(stats, stats.name.c_str(), EventCodeOfSlot(static_cast<int>(slot))));
+            }
+        }
+        sink.endSection();
+
+        sink.beginSection("addon_on_update");
+        for (size_t i = 0; i < window.addonCount; ++i) {
+            const AddonStats *addon = window.addons[i];
+            if (addon != nullptr && addon->onUpdate.callCount > 0) {
+                sink.timing(MakeTimingRecord(addon->onUpdate, GetAddonName(static_cast<AddonId>(i)), -1));
+            }
+        }
+        if (window.otherAddons.onUpdate.callCount > 0) {
+            sink.timing(MakeTimingRecord(window.otherAddons.onUpdate, "Other addons/frames", -1));
+        }
+        sink.endSection();
+
+        sink.beginSection("addon_on_event");
+        for (size_t i = 0; i < window.addonCount; ++i) {
+            const AddonStats *addon = window.addons[i];
+            if (addon != nullptr && addon->onEvent.callCount > 0) {
+                sink.timing(MakeTimingRecord(addon->onEvent, GetAddonName(static_cast<AddonId>(i)), -1));
+            }
+        }
+        if (window.otherAddons.onEvent.callCount > 0) {
+            sink.timing(MakeTimingRecord(window.otherAddons.onEvent, "Other addons/frames", -1));
+        }
+        sink.endSection();
+
+        sink.beginSection("addon_on_update_memory");
+        for (size_t i = 0; i < window.addonCount; ++i) {
+            const AddonStats *addon = window.addons[i];
+            if (addon != nullptr && addon->onUpdateMemory.callCount > 0) {
+                sink.memory(GetAddonName(static_cast<AddonId>(i)), addon->onUpdateMemory);
+            }
+        }
+        if (window.otherAddons.onUpdateMemory.callCount > 0) {
+            sink.memory("Other addons/frames", window.otherAddons.onUpdateMemory);
+        }
+        sink.endSection();
+
+        sink.beginSection("addon_on_event_memory");
+        for (size_t i = 0; i < window.addonCount; ++i) {
+            const AddonStats *addon = window.addons[i];
+            if (addon != nullptr && addon->onEventMemory.callCount > 0) {
+                sink.memory(GetAddonName(static_cast<AddonId>(i)), addon->onEventMemory);
+            }
+        }
+        if (window.otherAddons.onEventMemory.callCount > 0) {
+            sink.memory("Other addons/frames", window.otherAddons.onEventMemory);
+        }
+        sink.endSection();
+
+        sink.beginSection("spell_visuals");
+        const SpellVisualTable &spellVisuals = window.spellVisualStats;
+        for (size_t slot = 0; slot < spellVisuals.size(); ++slot) {
+            const FunctionStats &stats = spellVisuals.at(slot);
+            if (stats.callCount > 0) {
+                sink.timing(MakeTimingRecord(stats, stats.name.c_str(), spellVisuals.spellId(slot)));
+            }
+        }
+        if (spellVisuals.overflow().callCount > 0) {
+            sink.timing(MakeTimingRecord(spellVisuals.overflow(), spellVisuals.overflow().name.c_str(), -1));
+        }
+        sink.endSection();
+    }
+
+    static void WriteJsonString(std::FILE *file, const char *text) {
+        std::fputc('"', file);
+        for (const char *c = text; *c != '\0'; ++c) {
+            if (*c == '"' || *c == '\\') {
+                std::fputc('\\', file);
+                std::fputc(*c, file);
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                std::fprintf(file, "\\u%04x", static_cast<unsigned char>(*c));
+            } else {
+                std::fputc(*c, file);
+            }
+        }
+        std::fputc('"', file);
+    }
+
+    // "section":[{...},...] members of the window object
+    class JsonSink {
+    public:
+        explicit JsonSink(std::FILE *file) : file(file) {}
+
+        void beginSection(const char *section) {
+            std::fprintf(file, ",\"%s\":[", section);
+            firstRecord = true;
+        }
+
+        void endSection() {
+            std::fputc(']', file);
+        }
+
+        void timing(const TimingRecord &record) {
+            beginRecord(record.name);
+            if (record.id >= 0) {
+                std::fprintf(file, ",\"id\":%lld", record.id);
+            }
+            std::fprintf(file, ",\"calls\":%zu,\"total_ms\":%.3f,\"avg_ms\":%.3f,\"max_ms\":%.3f,\"min_ms\":%.3f,"
+                               "\"p50_ms\":%.3f,\"p95_ms\":%.3f,\"p99_ms\":%.3f,\"p999_ms\":%.3f}",
+                         record.calls, TicksToMs(record.totalTime), record.avgMs(), TicksToMs(record.slowestTime),
+                         TicksToMs(record.fastestTime), record.percentileMs(50.0), record.percentileMs(95.0),
+                         record.percentileMs(99.0), record.percentileMs(99.9));
+        }
+
+        void memory(const char *name, const MemoryStats &stats) {
+            beginRecord(name);
+            std::fprintf(file, ",\"calls\":%zu,\"total_kb\":%lld,\"avg_kb\":%.1f,\"max_kb\":%lld}",
+                         stats.callCount, stats.totalMemoryIncrease, stats.avgMemoryIncrease, stats.maxMemoryIncrease);
+        }
+
+    private:
+        void beginRecord(const char *name) {
+            std::fputs(firstRecord ? "{\"name\":" : ",{\"name\":", file);
+            WriteJsonString(file, name);
+            firstRecord = false;
+        }
+
+        std::FILE *file;
+        bool firstRecord = true;
+    };
+
+    // Quoted only when it has to be, names are almost always plain
+    static void WriteCsvField(std::FILE *file, const char *text) {
+        if (std::strpbrk(text, ",\"\r\n") == nullptr) {
+            std::fputs(text, file);
+            return;
+        }
+        std::fputc('"', file);
+        for (const char *c = text; *c != '\0'; ++c) {
+            if (*c == '"') {
+                std::fputc('"', file);
+            }
+            std::fputc(*c, file);
+        }
+        std::fputc('"', file);
+    }
+
+    // One row per record, memory rows leave the columns that only apply to timings empty
+    class CsvSink {
+    public:
+        CsvSink(std::FILE *file, const char *windowEnd) : file(file), windowEnd(windowEnd) {}
+
+        void beginSection(const char *name) {
+            section = name;
+        }
+
+        void endSection() {}
+
+        void timing(const TimingRecord &record) {
+            beginRow(record.name);
+            if (record.id >= 0) {
+                std::fprintf(file, "%lld", record.id);
+            }
+            std::fprintf(file, ",%zu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,ms\n",
+                         record.calls, TicksToMs(record.totalTime), record.avgMs(), TicksToMs(record.slowestTime),
+                         TicksToMs(record.fastestTime), record.percentileMs(50.0), record.percentileMs(95.0),
+                         record.percentileMs(99.0), record.percentileMs(99.9));
+        }
+
+        void memory(const char *name, const MemoryStats &stats) {
+            beginRow(name);
+            std::fprintf(file, ",%zu,%lld,%.1f,%lld,,,,,,kb\n",
+                         stats.callCount, stats.totalMemoryIncrease, stats.avgMemoryIncrease, stats.maxMemoryIncrease);
+        }
+
+    private:
+        void beginRow(const char *name) {
+            std::fprintf(file, "%s,%s,", windowEnd, section);
+            WriteCsvField(file, name);
+            std::fputc(',', file);
+        }
+
+        std::FILE *file;
+        const char *windowEnd;
+        const char *section = "";
+    };
+
+    struct AddonEventRow {
+        AddonId addonId;
+        int eventSlot;
+        AddonEventCell cell;
+    };
+
+    // The limit slowest addon x event code cells of the window, slowest first
+    static void WriteAddonEventRows(std::FILE *file, const StatsWindow &window, const char *windowEnd, size_t limit) {
+        std::vector<AddonEventRow> rows;
+        window.addonEvents.forEachCell([&](AddonId addonId, int eventSlot, const AddonEventCell &cell) {
+            rows.push_back({addonId, eventSlot, cell});
+        });
+        size_t keep = std::min(rows.size(), limit);
+        std::partial_sort(rows.begin(), rows.begin() + keep, rows.end(),
+                          [](const AddonEventRow &a, const AddonEventRow &b) {
+                              return a.cell.totalTime > b.cell.totalTime;
+                          });
+
+        for (size_t i = 0; i < keep; ++i) {
+            const AddonEventRow &row = rows[i];
+            std::fprintf(file, "%s,", windowEnd);
+            WriteCsvField(file, GetAddonName(row.addonId));
+            std::fputc(',', file);
+            WriteCsvField(file, window.eventCodeStats[row.eventSlot].name.c_str());
+            std::fprintf(file, ",%.3f,%u,%.3f\n", TicksToMs(row.cell.totalTime), row.cell.count,
+                         TicksToMs(row.cell.maxTime));
+        }
+    }
+
+    // Truncates on the first window of the session and appends after that
+    static std::FILE *OpenReportFile(const char *path, bool &started) {
+        std::FILE *file = std::fopen(path, started ? "ab" : "wb");
+        if (file) {
+            started = true;
+        }
+        return file;
+    }
+
+    void ExportWindowReport(const StatsWindow &window) {
+        static bool ndjsonStarted = false;
+        static bool csvStarted = false;
+        static bool addonEventsStarted = false;
+
+        std::tm end_tm;
+#ifdef _WIN32
+        localtime_s(&end_tm, &window.endWallTime);
+#else
+        localtime_r(&window.endWallTime, &end_tm);
+#endif
+        char windowEnd[32];
+        std::strftime(windowEnd, sizeof(windowEnd), "%Y-%m-%d %H:%M:%S", &end_tm);
+
+        if (window.config.reportNdjson > 0) {
+            std::FILE *file = OpenReportFile(WINDOW_NDJSON_PATH, ndjsonStarted);
+            if (file) {
+                std::fprintf(file, "{\"window_end\":\"%s\",\"start_ms\":%llu,\"end_ms\":%llu,\"frames\":%llu",
+                             windowEnd, static_cast<unsigned long long>(window.startTime),
+                             static_cast<unsigned long long>(window.endTime),
+                             static_cast<unsigned long long>(window.endFrame - window.firstFrame));
+                JsonSink sink(file);
+                WalkWindow(window, sink);
+                std::fputs("}\n", file);
+                std::fclose(file);
+            }
+        }
+
+        if (window.config.reportCsv > 0) {
+            bool writeHeader = !csvStarted;
+            std::FILE *file = OpenReportFile(WINDOW_CSV_PATH, csvStarted);
+            if (file) {
+                if (writeHeader) {
+                    std::fputs("window_end,section,name,id,calls,total,avg,max,min,p50,p95,p99,p999,unit\n", file);
+                }
+                CsvSink sink(file, windowEnd);
+                WalkWindow(window, sink);
+                std::fclose(file);
+            }
+        }
+
+        if (window.config.reportAddonEvents >= 1) {
+            bool writeHeader = !addonEventsStarted;
+            std::FILE *file = OpenReportFile(ADDON_EVENTS_CSV_PATH, addonEventsStarted);
+            if (file) {
+                if (writeHeader) {
+                    std::fputs("window_end,addon,event,total_ms,count,max_ms\n", file);
+                }
+                WriteAddonEventRows(file, window, windowEnd, static_cast<size_t>(window.config.reportAddonEvents));
+                std::fclose(file);
+            }
+        }
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace perf_monitor {
+    struct StatsWindow;
+
+    // Machine readable copies of the text report, for tooling that would otherwise scrape
+    // perf_monitor.log.  Depending on StatsWindow::config, gConfig as the window closed with it,
+    // each retired window is appended as
+    //   perf_monitor_windows.ndjson   one JSON object per window and line
+    //   perf_monitor_windows.csv      one row per stat, "window_end,section,name,..."
+    //   perf_monitor_addon_events.csv the report_addon_events slowest addon x event code cells
+    // The files are truncated by the first window of the session.  Written straight to the file
+    // as the window is walked, nothing is formatted into intermediate strings.  Stats worker only.
+    void ExportWindowReport(const StatsWindow &window);
+}
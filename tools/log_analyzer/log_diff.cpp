@@ -0,0 +1,216 @@
+#include "log_diff.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace perf_monitor {
+    constexpr int BOOTSTRAP_RESAMPLES = 2000;
+    constexpr double CONFIDENCE_LEVEL = 0.95;
+    // Fixed so running the same diff twice prints the same intervals
+    constexpr uint64_t BOOTSTRAP_SEED = 0x9e3779b97f4a7c15ull;
+
+    // One stat over the windows of one run
+    struct StatSeries {
+        std::vector<double> msPerFrame; // per window with frames, 0 where the stat wasn't logged
+        double totalMs = 0;
+        uint64_t calls = 0;
+        double p99Sum = 0;              // p99 of each window the stat was logged in
+        size_t p99Windows = 0;
+
+        double mean() const {
+            double sum = 0;
+            for (double value: msPerFrame) {
+                sum += value;
+            }
+            return msPerFrame.empty() ? 0 : sum / static_cast<double>(msPerFrame.size());
+        }
+
+        double perCallMs() const {
+            return calls > 0 ? totalMs / static_cast<double>(calls) : 0;
+        }
+
+        double p99Ms() const {
+            return p99Windows > 0 ? p99Sum / static_cast<double>(p99Windows) : 0;
+        }
+    };
+
+    // Every comparable stat of one run, keyed by section and name so two runs line up even
+    // though their name ids don't
+    struct RunStats {
+        size_t windowCount = 0;
+        StatSeries frameTime; // whole frame, render ms / frames
+        std::vector<StatSeries> series;
+        std::unordered_map<std::string, size_t> seriesByKey;
+    };
+
+    struct StatDiff {
+        std::string key;
+        const StatSeries *before; // nullptr when the stat only shows up in one run
+        const StatSeries *after;
+        double delta;             // after - before, ms per frame
+        double low = 0;           // confidence interval of delta
+        double high = 0;
+    };
+
+    static bool IsComparedSection(LogSection section) {
+        return section == LOG_SECTION_FUNCTIONS || section == LOG_SECTION_ADDON_ON_UPDATE ||
+               section == LOG_SECTION_ADDON_ON_EVENT || section == LOG_SECTION_EVENT_CODES;
+    }
+
+    static const char *SectionLabel(LogSection section) {
+        switch (section) {
+            case LOG_SECTION_FUNCTIONS:
+                return "function";
+            case LOG_SECTION_ADDON_ON_UPDATE:
+                return "OnUpdate";
+            case LOG_SECTION_ADDON_ON_EVENT:
+                return "OnEvent";
+            default:
+                return "event";
+        }
+    }
+
+    static void CollectRunStats(const LogParseResult &run, RunStats &stats) {
+        for (const auto &window: run.windows) {
+            if (window.frames > 0) {
+                stats.windowCount++;
+            }
+        }
+
+        // [section][nameId] -> index into stats.series, so keys are only built once per name
+        std::vector<std::vector<size_t>> seriesIndex(LOG_SECTION_COUNT);
+        size_t windowIndex = 0;
+        for (const auto &window: run.windows) {
+            if (window.frames == 0) {
+                continue;
+            }
+            auto frames = static_cast<double>(window.frames);
+            stats.frameTime.msPerFrame.push_back(window.renderMs / frames);
+            stats.frameTime.totalMs += window.renderMs;
+            stats.frameTime.calls += window.frames;
+
+            for (const auto &stat: window.stats) {
+                if (!IsComparedSection(stat.section)) {
+                    continue;
+                }
+                auto &indexes = seriesIndex[stat.section];
+                if (indexes.empty()) {
+                    indexes.assign(run.names.size(), SIZE_MAX);
+                }
+                size_t &index = indexes[stat.nameId];
+                if (index == SIZE_MAX) {
+                    std::string key = std::string(SectionLabel(stat.section)) + ' ' + run.names[stat.nameId];
+                    auto inserted = stats.seriesByKey.emplace(key, stats.series.size());
+                    if (inserted.second) {
+                        stats.series.emplace_back();
+                        stats.series.back().msPerFrame.assign(stats.windowCount, 0.0);
+                    }
+                    index = inserted.first->second;
+                }
+
+                StatSeries &series = stats.series[index];
+                series.msPerFrame[windowIndex] += stat.total / frames;
+                series.totalMs += stat.total;
+                series.calls += stat.calls;
+                series.p99Sum += stat.p99;
+                series.p99Windows++;
+            }
+            windowIndex++;
+        }
+    }
+
+    // Mean of one resample drawn with replacement, 0 for a stat missing from the run
+    static double ResampleMean(const StatSeries *series, size_t windowCount, std::mt19937_64 &rng) {
+        if (series == nullptr || windowCount == 0) {
+            return 0;
+        }
+        std::uniform_int_distribution<size_t> pick(0, windowCount - 1);
+        double sum = 0;
+        for (size_t i = 0; i < windowCount; ++i) {
+            sum += series->msPerFrame[pick(rng)];
+        }
+        return sum / static_cast<double>(windowCount);
+    }
+
+    // Percentile bootstrap of the difference in mean ms per frame, windows resampled independently
+    // for each run
+    static void BootstrapInterval(StatDiff &diff, const RunStats &before, const RunStats &after,
+                                  std::mt19937_64 &rng) {
+        std::vector<double> deltas(BOOTSTRAP_RESAMPLES);
+        for (double &delta: deltas) {
+            delta = ResampleMean(diff.after, after.windowCount, rng) - ResampleMean(diff.before, before.windowCount, rng);
+        }
+        std::sort(deltas.begin(), deltas.end());
+
+        double tail = (1.0 - CONFIDENCE_LEVEL) / 2.0;
+        diff.low = deltas[static_cast<size_t>(tail * BOOTSTRAP_RESAMPLES)];
+        diff.high = deltas[static_cast<size_t>((1.0 - tail) * BOOTSTRAP_RESAMPLES) - 1];
+    }
+
+    static void PrintDiffLine(std::FILE *out, const StatDiff &diff) {
+        static const StatSeries kEmpty;
+        const StatSeries &before = diff.before != nullptr ? *diff.before : kEmpty;
+        const StatSeries &after = diff.after != nullptr ? *diff.after : kEmpty;
+        bool significant = diff.low > 0 || diff.high < 0;
+
+        std::fprintf(out, "%-50s %9.4f %9.4f %+9.4f [%+9.4f, %+9.4f] %-3s %9.4f %+9.4f %9.3f %+9.3f\n",
+                     diff.key.c_str(), before.mean(), after.mean(), diff.delta, diff.low, diff.high,
+                     significant ? "*" : "", before.perCallMs(), after.perCallMs() - before.perCallMs(),
+                     before.p99Ms(), after.p99Ms() - before.p99Ms());
+    }
+
+    void PrintRunDiff(const LogParseResult &beforeRun, const LogParseResult &afterRun, size_t top, std::FILE *out) {
+        RunStats before;
+        RunStats after;
+        CollectRunStats(beforeRun, before);
+        CollectRunStats(afterRun, after);
+
+        std::vector<StatDiff> diffs;
+        for (const auto &entry: before.seriesByKey) {
+            auto match = after.seriesByKey.find(entry.first);
+            const StatSeries *afterSeries = match != after.seriesByKey.end() ? &after.series[match->second] : nullptr;
+            diffs.push_back({entry.first, &before.series[entry.second], afterSeries, 0});
+        }
+        for (const auto &entry: after.seriesByKey) {
+            if (before.seriesByKey.find(entry.first) == before.seriesByKey.end()) {
+                diffs.push_back({entry.first, nullptr, &after.series[entry.second], 0});
+            }
+        }
+        for (auto &diff: diffs) {
+            diff.delta = (diff.after != nullptr ? diff.after->mean() : 0) -
+                         (diff.before != nullptr ? diff.before->mean() : 0);
+        }
+
+        // Largest effect on frame time first, either direction
+        std::sort(diffs.begin(), diffs.end(), [](const StatDiff &a, const StatDiff &b) {
+            return std::fabs(a.delta) > std::fabs(b.delta);
+        });
+        if (diffs.size() > top) {
+            diffs.resize(top);
+        }
+
+        std::mt19937_64 rng(BOOTSTRAP_SEED);
+        StatDiff frameTime = {"Frame time (render ms / frames)", &before.frameTime, &after.frameTime,
+                              after.frameTime.mean() - before.frameTime.mean()};
+        BootstrapInterval(frameTime, before, after, rng);
+        for (auto &diff: diffs) {
+            BootstrapInterval(diff, before, after, rng);
+        }
+
+        std::fprintf(out, "--- RUN DIFF (before: %zu windows, after: %zu windows, ms per frame, %.0f%% bootstrap CI, "
+                          "* = CI excludes 0) ---\n", before.windowCount, after.windowCount, CONFIDENCE_LEVEL * 100.0);
+        std::fprintf(out, "%-50s %9s %9s %9s %-24s %-3s %9s %9s %9s %9s\n", "Stat", "Before", "After", "Delta",
+                     "  Confidence interval", "", "Call ms", "Delta", "p99 ms", "Delta");
+        PrintDiffLine(out, frameTime);
+        for (const auto &diff: diffs) {
+            PrintDiffLine(out, diff);
+        }
+        std::fprintf(out, "\n");
+    }
+}
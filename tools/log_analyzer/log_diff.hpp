@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include "log_parser.hpp"
+
+namespace perf_monitor {
+    // Compares two runs stat by stat, matched on section and name: hooked functions, addon
+    // OnUpdate/OnEvent and event codes.  Prints the change in frame time cost (ms per frame), per
+    // call time and p99 with a 95% bootstrap confidence interval for the frame time change, sorted
+    // by the size of that change.  Only the top stats by point estimate are bootstrapped.
+    void PrintRunDiff(const LogParseResult &before, const LogParseResult &after, size_t top, std::FILE *out);
+}
@@ -0,0 +1,313 @@
+#include "log_parser.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+namespace perf_monitor {
+    static const char WINDOW_START[] = "--- STATS from ";
+    static const char WINDOW_SEPARATOR[] = "----------";
+
+    struct SectionHeader {
+        const char *prefix;
+        LogSection section;
+        const char *nameSuffix; // stripped from addon names
+    };
+
+    static const SectionHeader kSectionHeaders[] = {
+            {"--- DETAILED STATS ---",                  LOG_SECTION_FUNCTIONS,              ""},
+            {"--- ADDON/FRAME ONUPDATE PERFORMANCE",    LOG_SECTION_ADDON_ON_UPDATE,        " OnUpdate"},
+            {"--- ADDON/FRAME EVENTS PERFORMANCE",      LOG_SECTION_ADDON_ON_EVENT,         " All Events"},
+            {"--- ADDON ONUPDATE MEMORY USAGE",         LOG_SECTION_ADDON_ON_UPDATE_MEMORY, " OnUpdate Memory"},
+            {"--- ADDON ONEVENT MEMORY USAGE",          LOG_SECTION_ADDON_ON_EVENT_MEMORY,  " OnEvent Memory"},
+            {"--- SPELL VISUAL PERFORMANCE",            LOG_SECTION_SPELL_VISUALS,          ""},
+            {"--- TOTAL EVENT DURATION STATISTICS",     LOG_SECTION_EVENT_CODES,            ""},
+    };
+
+    struct LogChunk {
+        uint32_t fileIndex;
+        const char *begin;
+        const char *end;
+    };
+
+    // What one thread parsed, name ids are local to the chunk until merged
+    struct ChunkResult {
+        std::vector<std::string> names;
+        std::vector<LogWindow> windows;
+    };
+
+    static bool StartsWith(const char *text, const char *end, const char *prefix) {
+        size_t length = std::strlen(prefix);
+        return static_cast<size_t>(end - text) >= length && std::memcmp(text, prefix, length) == 0;
+    }
+
+    // memmem without relying on a GNU extension
+    static const char *FindText(const char *text, const char *end, const char *needle, size_t needleLength) {
+        while (static_cast<size_t>(end - text) >= needleLength) {
+            auto first = static_cast<const char *>(std::memchr(text, needle[0], end - text - needleLength + 1));
+            if (first == nullptr) {
+                return nullptr;
+            }
+            if (std::memcmp(first, needle, needleLength) == 0) {
+                return first;
+            }
+            text = first + 1;
+        }
+        return nullptr;
+    }
+
+    // Pointer just past the first "label" in [text, end), or nullptr
+    template<size_t N>
+    static const char *FindAfter(const char *text, const char *end, const char (&label)[N]) {
+        const char *found = FindText(text, end, label, N - 1);
+        return found != nullptr ? found + N - 1 : nullptr;
+    }
+
+    // Plain decimal as written by iostreams with std::fixed, never reads past end
+    static double ParseNumber(const char *&text, const char *end) {
+        while (text < end && *text == ' ') {
+            ++text;
+        }
+        bool negative = text < end && *text == '-';
+        if (negative) {
+            ++text;
+        }
+        double value = 0;
+        while (text < end && *text >= '0' && *text <= '9') {
+            value = value * 10 + (*text++ - '0');
+        }
+        if (text < end && *text == '.') {
+            ++text;
+            double scale = 0.1;
+            while (text < end && *text >= '0' && *text <= '9') {
+                value += (*text++ - '0') * scale;
+                scale *= 0.1;
+            }
+        }
+        return negative ? -value : value;
+    }
+
+    // Number following the first "label" in [text, end), 0 if the label is missing
+    template<size_t N>
+    static double ParseNumberAfter(const char *text, const char *end, const char (&label)[N]) {
+        const char *found = FindAfter(text, end, label);
+        return found != nullptr ? ParseNumber(found, end) : 0;
+    }
+
+    // Skips the "MM-DD HH:MM:SS: " prefix DEBUG_LOG puts in front of every line
+    static const char *SkipTimestamp(const char *line, const char *end) {
+        if (end - line >= 16 && line[2] == '-' && line[5] == ' ' && line[14] == ':' && line[15] == ' ') {
+            return line + 16;
+        }
+        return line;
+    }
+
+    class ChunkParser {
+    public:
+        ChunkParser(const LogChunk &chunk, ChunkResult &result) : chunk(chunk), result(result) {}
+
+        void parse() {
+            const char *line = chunk.begin;
+            while (line < chunk.end) {
+                auto newline = static_cast<const char *>(std::memchr(line, '\n', chunk.end - line));
+                const char *lineEnd = newline != nullptr ? newline : chunk.end;
+                if (lineEnd > line && lineEnd[-1] == '\r') {
+                    parseLine(SkipTimestamp(line, lineEnd - 1), lineEnd - 1);
+                } else {
+                    parseLine(SkipTimestamp(line, lineEnd), lineEnd);
+                }
+                line = lineEnd + 1;
+            }
+        }
+
+    private:
+        void parseLine(const char *text, const char *end) {
+            if (StartsWith(text, end, WINDOW_START)) {
+                beginWindow(text + sizeof(WINDOW_START) - 1, end);
+                return;
+            }
+            if (window == nullptr) {
+                return;
+            }
+
+            if (StartsWith(text, end, WINDOW_SEPARATOR)) {
+                window = nullptr;
+            } else if (StartsWith(text, end, "--- ")) {
+                header = nullptr;
+                for (const auto &candidate: kSectionHeaders) {
+                    if (StartsWith(text, end, candidate.prefix)) {
+                        header = &candidate;
+                        break;
+                    }
+                }
+            } else if (StartsWith(text, end, "[Total] Render:")) {
+                window->renderMs = ParseNumberAfter(text, end, "Render:");
+                window->frames = static_cast<uint64_t>(ParseNumberAfter(text, end, "Frames:"));
+                window->avgFps = ParseNumberAfter(text, end, "Avg fps:");
+            } else if (header != nullptr && text < end && *text == '[') {
+                parseStat(text, end);
+            }
+        }
+
+        // "MM-DD HH:MM:SS to MM-DD HH:MM:SS ---"
+        void beginWindow(const char *text, const char *end) {
+            result.windows.emplace_back();
+            window = &result.windows.back();
+            header = nullptr;
+
+            window->fileIndex = chunk.fileIndex;
+            window->renderMs = 0;
+            window->frames = 0;
+            window->avgFps = 0;
+            std::memset(window->start, 0, sizeof(window->start));
+            std::memset(window->end, 0, sizeof(window->end));
+            if (end - text >= 32) {
+                std::memcpy(window->start, text, 14);
+                std::memcpy(window->end, text + 18, 14);
+            }
+        }
+
+        // "[name   ] Calls: ..." as written by OutputStatsLine or MemoryStats::outputStats
+        void parseStat(const char *text, const char *end) {
+            const char *nameEnd = FindAfter(text, end, "] Calls:");
+            if (nameEnd == nullptr) {
+                return;
+            }
+            const char *values = nameEnd;
+            nameEnd -= sizeof("] Calls:") - 1;
+
+            const char *name = text + 1;
+            while (nameEnd > name && nameEnd[-1] == ' ') {
+                --nameEnd;
+            }
+            size_t suffixLength = std::strlen(header->nameSuffix);
+            if (static_cast<size_t>(nameEnd - name) > suffixLength &&
+                std::memcmp(nameEnd - suffixLength, header->nameSuffix, suffixLength) == 0) {
+                nameEnd -= suffixLength;
+            }
+
+            LogStat stat;
+            stat.nameId = internName(name, nameEnd);
+            stat.section = header->section;
+            stat.calls = static_cast<uint64_t>(ParseNumber(values, end));
+            if (header->section == LOG_SECTION_ADDON_ON_UPDATE_MEMORY ||
+                header->section == LOG_SECTION_ADDON_ON_EVENT_MEMORY) {
+                stat.total = ParseNumberAfter(values, end, "Total Mem:");
+                stat.max = ParseNumberAfter(values, end, "Max:");
+                stat.p99 = 0;
+            } else {
+                stat.total = ParseNumberAfter(values, end, "Total:");
+                stat.max = ParseNumberAfter(values, end, "Slowest:");
+                stat.p99 = ParseNumberAfter(values, end, "p99:");
+            }
+            window->stats.push_back(stat);
+        }
+
+        uint32_t internName(const char *name, const char *nameEnd) {
+            // Reuses the key's buffer, lookups of names already seen don't allocate
+            key.assign(name, nameEnd);
+            auto found = nameIds.find(key);
+            if (found != nameIds.end()) {
+                return found->second;
+            }
+            auto id = static_cast<uint32_t>(result.names.size());
+            result.names.push_back(key);
+            nameIds.emplace(key, id);
+            return id;
+        }
+
+        const LogChunk &chunk;
+        ChunkResult &result;
+        LogWindow *window = nullptr;
+        const SectionHeader *header = nullptr;
+        std::unordered_map<std::string, uint32_t> nameIds;
+        std::string key;
+    };
+
+    // Start of the line holding the first window start at or after text, end if there is none
+    static const char *FindWindowStart(const char *fileBegin, const char *text, const char *end) {
+        const char *found = FindText(text, end, WINDOW_START, sizeof(WINDOW_START) - 1);
+        if (found == nullptr) {
+            return end;
+        }
+        while (found > fileBegin && found[-1] != '\n') {
+            --found;
+        }
+        return std::max(found, text);
+    }
+
+    static void SplitIntoChunks(uint32_t fileIndex, const MappedFile &file, size_t chunkBytes,
+                                std::vector<LogChunk> &chunks) {
+        const char *begin = file.data();
+        const char *end = begin + file.size();
+        const char *chunkBegin = begin;
+        while (chunkBegin < end) {
+            const char *chunkEnd = end;
+            if (static_cast<size_t>(end - chunkBegin) > chunkBytes) {
+                chunkEnd = FindWindowStart(begin, chunkBegin + chunkBytes, end);
+            }
+            chunks.push_back({fileIndex, chunkBegin, chunkEnd});
+            chunkBegin = chunkEnd;
+        }
+    }
+
+    void ParseLogFiles(const std::vector<std::string> &paths, unsigned threadCount, LogParseResult &result,
+                       size_t chunkBytes) {
+        std::vector<std::unique_ptr<MappedFile>> files;
+        std::vector<LogChunk> chunks;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            std::unique_ptr<MappedFile> file(new MappedFile);
+            if (!file->open(paths[i])) {
+                std::fprintf(stderr, "Couldn't read %s: %s\n", paths[i].c_str(), std::strerror(errno));
+                continue;
+            }
+            SplitIntoChunks(static_cast<uint32_t>(i), *file, chunkBytes, chunks);
+            result.bytesParsed += file->size();
+            files.push_back(std::move(file));
+        }
+
+        std::vector<ChunkResult> chunkResults(chunks.size());
+        std::atomic<size_t> nextChunk{0};
+        auto worker = [&] {
+            for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+                ChunkParser(chunks[i], chunkResults[i]).parse();
+            }
+        };
+
+        threadCount = std::max(1u, std::min(threadCount, static_cast<unsigned>(chunks.size())));
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto &thread: threads) {
+            thread.join();
+        }
+
+        // Chunks are in file order, so appending keeps the windows in order too
+        std::unordered_map<std::string, uint32_t> nameIds;
+        std::vector<uint32_t> remap;
+        for (auto &chunkResult: chunkResults) {
+            remap.resize(chunkResult.names.size());
+            for (size_t i = 0; i < chunkResult.names.size(); ++i) {
+                auto inserted = nameIds.emplace(chunkResult.names[i], static_cast<uint32_t>(result.names.size()));
+                if (inserted.second) {
+                    result.names.push_back(std::move(chunkResult.names[i]));
+                }
+                remap[i] = inserted.first->second;
+            }
+            for (auto &window: chunkResult.windows) {
+                for (auto &stat: window.stats) {
+                    stat.nameId = remap[stat.nameId];
+                }
+                result.windows.push_back(std::move(window));
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace perf_monitor {
+    // Chunks are cut at the first window start after every LOG_CHUNK_BYTES, so a thread always
+    // parses whole windows and a small log is a single chunk
+    constexpr size_t LOG_CHUNK_BYTES = 8 << 20;
+
+    // Report sections written by OutputStats that the analyzer reads, everything else is skipped
+    enum LogSection : uint8_t {
+        LOG_SECTION_NONE,
+        LOG_SECTION_FUNCTIONS,              // --- DETAILED STATS ---
+        LOG_SECTION_ADDON_ON_UPDATE,        // --- ADDON/FRAME ONUPDATE PERFORMANCE ---
+        LOG_SECTION_ADDON_ON_EVENT,         // --- ADDON/FRAME EVENTS PERFORMANCE ---
+        LOG_SECTION_ADDON_ON_UPDATE_MEMORY, // --- ADDON ONUPDATE MEMORY USAGE ---
+        LOG_SECTION_ADDON_ON_EVENT_MEMORY,  // --- ADDON ONEVENT MEMORY USAGE ---
+        LOG_SECTION_SPELL_VISUALS,          // --- SPELL VISUAL PERFORMANCE ---
+        LOG_SECTION_EVENT_CODES,            // --- TOTAL EVENT DURATION STATISTICS ---
+        LOG_SECTION_COUNT,
+    };
+
+    // One "[name] Calls: ..." line of a window.  Timing sections are in ms, memory sections in KB.
+    struct LogStat {
+        uint32_t nameId; // into LogParseResult::names
+        LogSection section;
+        uint64_t calls;
+        double total;
+        double max;  // slowest call, or largest single memory increase
+        double p99;  // 0 for memory lines
+    };
+
+    // One "--- STATS from ... to ... ---" block
+    struct LogWindow {
+        uint32_t fileIndex;
+        char start[16]; // "MM-DD HH:MM:SS" as logged
+        char end[16];
+        double renderMs;
+        uint64_t frames;
+        double avgFps;
+        std::vector<LogStat> stats;
+    };
+
+    struct LogParseResult {
+        // Addon names are stored without their " OnUpdate", " All Events", ... suffix so every
+        // addon section of the same addon shares one id
+        std::vector<std::string> names;
+        std::vector<LogWindow> windows; // in command line file order, then log order
+        size_t bytesParsed = 0;
+    };
+
+    // Maps every file, splits each one into chunks on window boundaries and parses the chunks on
+    // threadCount threads.  Files that can't be read are reported on stderr and skipped.  The result
+    // doesn't depend on threadCount or chunkBytes.
+    void ParseLogFiles(const std::vector<std::string> &paths, unsigned threadCount, LogParseResult &result,
+                       size_t chunkBytes = LOG_CHUNK_BYTES);
+}
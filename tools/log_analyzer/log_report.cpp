@@ -0,0 +1,262 @@
+#include "log_report.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+namespace perf_monitor {
+    // Running totals of one name over the window series, windows without the name count as 0
+    struct TrendAccumulator {
+        double sum = 0;         // sum of the per window values
+        double weightedSum = 0; // same, each value multiplied by its window index
+        double max = 0;
+        size_t maxWindow = 0;
+        size_t windows = 0;     // windows the name showed up in at all
+    };
+
+    // Change over the whole series of the least squares line through windows 0..n-1, as a
+    // percentage of the mean
+    static double TrendPercent(const TrendAccumulator &trend, size_t windowCount) {
+        if (windowCount < 2 || trend.sum <= 0) {
+            return 0;
+        }
+        auto n = static_cast<double>(windowCount);
+        double meanX = (n - 1) / 2.0;
+        double sumSquaresX = n * (n * n - 1) / 12.0;
+        double slope = (trend.weightedSum - meanX * trend.sum) / sumSquaresX;
+        return slope * (n - 1) / (trend.sum / n) * 100.0;
+    }
+
+    // Per name sums of valueOf over each window, folded into one accumulator per name.  valueOf
+    // returns false for stats that don't belong to the series.
+    template<typename ValueOf>
+    static std::vector<TrendAccumulator> AccumulateTrends(const LogParseResult &result, ValueOf valueOf) {
+        std::vector<TrendAccumulator> trends(result.names.size());
+        std::vector<double> windowValues(result.names.size(), 0.0);
+        std::vector<bool> seen(result.names.size(), false);
+        std::vector<uint32_t> touched;
+
+        for (size_t w = 0; w < result.windows.size(); ++w) {
+            for (const auto &stat: result.windows[w].stats) {
+                double value;
+                if (!valueOf(stat, value)) {
+                    continue;
+                }
+                windowValues[stat.nameId] += value;
+                if (!seen[stat.nameId]) {
+                    seen[stat.nameId] = true;
+                    touched.push_back(stat.nameId);
+                }
+            }
+
+            for (uint32_t id: touched) {
+                TrendAccumulator &trend = trends[id];
+                double value = windowValues[id];
+                trend.sum += value;
+                trend.weightedSum += static_cast<double>(w) * value;
+                if (value > trend.max) {
+                    trend.max = value;
+                    trend.maxWindow = w;
+                }
+                trend.windows++;
+                windowValues[id] = 0;
+                seen[id] = false;
+            }
+            touched.clear();
+        }
+        return trends;
+    }
+
+    // Ids of the names with the largest sums, largest first
+    static std::vector<uint32_t> TopBySum(const std::vector<TrendAccumulator> &trends, size_t top) {
+        std::vector<std::pair<double, uint32_t>> sums;
+        for (size_t id = 0; id < trends.size(); ++id) {
+            if (trends[id].sum > 0) {
+                sums.emplace_back(trends[id].sum, static_cast<uint32_t>(id));
+            }
+        }
+        std::sort(sums.rbegin(), sums.rend());
+
+        std::vector<uint32_t> ids;
+        for (size_t i = 0; i < sums.size() && i < top; ++i) {
+            ids.push_back(sums[i].second);
+        }
+        return ids;
+    }
+
+    static bool IsAddonTime(const LogStat &stat) {
+        return stat.section == LOG_SECTION_ADDON_ON_UPDATE || stat.section == LOG_SECTION_ADDON_ON_EVENT;
+    }
+
+    static bool IsAddonMemory(const LogStat &stat) {
+        return stat.section == LOG_SECTION_ADDON_ON_UPDATE_MEMORY || stat.section == LOG_SECTION_ADDON_ON_EVENT_MEMORY;
+    }
+
+    static const char *BaseName(const std::string &path) {
+        size_t slash = path.find_last_of("/\\");
+        return path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+    }
+
+    // Addon with the most OnUpdate + OnEvent time in a window, nullptr if none
+    static const std::string *HeaviestAddon(const LogParseResult &result, const LogWindow &window, double &ms) {
+        std::vector<std::pair<uint32_t, double>> totals;
+        for (const auto &stat: window.stats) {
+            if (!IsAddonTime(stat)) {
+                continue;
+            }
+            auto found = std::find_if(totals.begin(), totals.end(),
+                                      [&](const std::pair<uint32_t, double> &entry) { return entry.first == stat.nameId; });
+            if (found == totals.end()) {
+                totals.emplace_back(stat.nameId, stat.total);
+            } else {
+                found->second += stat.total;
+            }
+        }
+
+        const std::string *name = nullptr;
+        ms = 0;
+        for (const auto &entry: totals) {
+            if (entry.second > ms) {
+                ms = entry.second;
+                name = &result.names[entry.first];
+            }
+        }
+        return name;
+    }
+
+    void PrintSessionSummaries(const LogParseResult &result, const std::vector<std::string> &paths) {
+        std::printf("--- SESSIONS ---\n");
+        for (size_t file = 0; file < paths.size(); ++file) {
+            size_t windowCount = 0;
+            uint64_t frames = 0;
+            double renderMs = 0;
+            double fpsSum = 0;
+            double minFps = 0;
+            const LogWindow *first = nullptr;
+            const LogWindow *last = nullptr;
+            std::vector<double> addonMs(result.names.size(), 0.0);
+
+            for (const auto &window: result.windows) {
+                if (window.fileIndex != file) {
+                    continue;
+                }
+                if (first == nullptr) {
+                    first = &window;
+                    minFps = window.avgFps;
+                }
+                last = &window;
+                windowCount++;
+                frames += window.frames;
+                renderMs += window.renderMs;
+                fpsSum += window.avgFps;
+                minFps = std::min(minFps, window.avgFps);
+                for (const auto &stat: window.stats) {
+                    if (IsAddonTime(stat)) {
+                        addonMs[stat.nameId] += stat.total;
+                    }
+                }
+            }
+
+            if (windowCount == 0) {
+                std::printf("%s: no stats windows\n\n", BaseName(paths[file]));
+                continue;
+            }
+
+            std::printf("%s: %zu windows from %s to %s\n", BaseName(paths[file]), windowCount, first->start, last->end);
+            std::printf("  Frames: %llu  Render: %.1f s  Avg fps: %.2f  Lowest window fps: %.2f\n",
+                        static_cast<unsigned long long>(frames), renderMs / 1000.0, fpsSum / windowCount, minFps);
+
+            std::vector<std::pair<double, uint32_t>> addons;
+            for (size_t id = 0; id < addonMs.size(); ++id) {
+                if (addonMs[id] > 0) {
+                    addons.emplace_back(addonMs[id], static_cast<uint32_t>(id));
+                }
+            }
+            std::sort(addons.rbegin(), addons.rend());
+            for (size_t i = 0; i < addons.size() && i < 5; ++i) {
+                std::printf("  %-45s %10.1f ms  %6.2f ms/window\n", result.names[addons[i].second].c_str(),
+                            addons[i].first, addons[i].first / windowCount);
+            }
+            std::printf("\n");
+        }
+    }
+
+    void PrintWorstWindows(const LogParseResult &result, const std::vector<std::string> &paths, size_t top) {
+        std::vector<std::pair<double, size_t>> byFps;
+        for (size_t w = 0; w < result.windows.size(); ++w) {
+            if (result.windows[w].frames > 0) {
+                byFps.emplace_back(result.windows[w].avgFps, w);
+            }
+        }
+        std::sort(byFps.begin(), byFps.end());
+
+        std::printf("--- WORST WINDOWS (lowest avg fps) ---\n");
+        for (size_t i = 0; i < byFps.size() && i < top; ++i) {
+            const LogWindow &window = result.windows[byFps[i].second];
+            double addonMs;
+            const std::string *addon = HeaviestAddon(result, window, addonMs);
+
+            std::printf("%2zu. %-20s %s to %s  fps: %6.2f  frames: %6llu  ms/frame: %6.2f", i + 1,
+                        BaseName(paths[window.fileIndex]), window.start, window.end, window.avgFps,
+                        static_cast<unsigned long long>(window.frames), window.renderMs / window.frames);
+            if (addon != nullptr) {
+                std::printf("  heaviest addon: %s (%.1f ms)", addon->c_str(), addonMs);
+            }
+            std::printf("\n");
+        }
+        std::printf("\n");
+    }
+
+    void PrintFunctionTrends(const LogParseResult &result, size_t top) {
+        auto total = AccumulateTrends(result, [](const LogStat &stat, double &value) {
+            value = stat.total;
+            return stat.section == LOG_SECTION_FUNCTIONS;
+        });
+        auto p99 = AccumulateTrends(result, [](const LogStat &stat, double &value) {
+            value = stat.p99;
+            return stat.section == LOG_SECTION_FUNCTIONS;
+        });
+
+        size_t windowCount = result.windows.size();
+        std::printf("--- FUNCTION TRENDS (%zu windows, ms per window) ---\n", windowCount);
+        std::printf("%-45s %8s %10s %10s  %-26s %9s %8s\n", "Function", "Windows", "Mean", "Max", "Max window",
+                    "Worst p99", "Trend");
+        for (uint32_t id: TopBySum(total, top)) {
+            const TrendAccumulator &trend = total[id];
+            const LogWindow &maxWindow = result.windows[trend.maxWindow];
+            std::printf("%-45s %8zu %10.2f %10.2f  %s to %s %9.3f %+7.0f%%\n", result.names[id].c_str(),
+                        trend.windows, trend.sum / windowCount, trend.max, maxWindow.start, maxWindow.end + 6,
+                        p99[id].max, TrendPercent(trend, windowCount));
+        }
+        std::printf("\n");
+    }
+
+    void PrintAddonTrends(const LogParseResult &result, size_t top) {
+        auto total = AccumulateTrends(result, [](const LogStat &stat, double &value) {
+            value = stat.total;
+            return IsAddonTime(stat);
+        });
+        auto onUpdate = AccumulateTrends(result, [](const LogStat &stat, double &value) {
+            value = stat.total;
+            return stat.section == LOG_SECTION_ADDON_ON_UPDATE;
+        });
+        auto memory = AccumulateTrends(result, [](const LogStat &stat, double &value) {
+            value = stat.total;
+            return IsAddonMemory(stat);
+        });
+
+        size_t windowCount = result.windows.size();
+        std::printf("--- ADDON TRENDS (%zu windows, OnUpdate + OnEvent ms per window) ---\n", windowCount);
+        std::printf("%-45s %8s %10s %10s %10s %12s  %-26s %8s\n", "Addon", "Windows", "Mean", "OnUpdate", "Max",
+                    "Mem KB/win", "Max window", "Trend");
+        for (uint32_t id: TopBySum(total, top)) {
+            const TrendAccumulator &trend = total[id];
+            const LogWindow &maxWindow = result.windows[trend.maxWindow];
+            std::printf("%-45s %8zu %10.2f %10.2f %10.2f %12.1f  %s to %s %+7.0f%%\n", result.names[id].c_str(),
+                        trend.windows, trend.sum / windowCount, onUpdate[id].sum / windowCount, trend.max,
+                        memory[id].sum / windowCount, maxWindow.start, maxWindow.end + 6,
+                        TrendPercent(trend, windowCount));
+        }
+        std::printf("\n");
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "log_parser.hpp"
+
+namespace perf_monitor {
+    // Windows, time range, frames and fps of every log plus its heaviest addons
+    void PrintSessionSummaries(const LogParseResult &result, const std::vector<std::string> &paths);
+
+    // The top lowest fps windows across all logs
+    void PrintWorstWindows(const LogParseResult &result, const std::vector<std::string> &paths, size_t top);
+
+    // Per window totals of every hooked function and addon across all windows in order, with the
+    // change from the first to the last window fitted by least squares
+    void PrintFunctionTrends(const LogParseResult &result, size_t top);
+
+    void PrintAddonTrends(const LogParseResult &result, size_t top);
+}
@@ -0,0 +1,87 @@
+#include "log_diff.hpp"
+#include "log_parser.hpp"
+#include "log_report.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace perf_monitor;
+
+static void PrintUsage() {
+    std::fprintf(stderr,
+                 "Usage: perf_monitor_analyze [--threads N] [--top N] <perf_monitor.log>...\n"
+                 "       perf_monitor_analyze [--threads N] [--top N] --before <log>... --after <log>...\n"
+                 "Pass rotated logs oldest first (perf_monitor.log.3 ... perf_monitor.log), trends follow the\n"
+                 "order of the windows on the command line.  --before/--after compares two runs instead.\n");
+}
+
+int main(int argc, char **argv) {
+    unsigned threadCount = std::thread::hardware_concurrency();
+    size_t top = 20;
+    std::vector<std::string> paths;
+    std::vector<std::string> beforePaths;
+    std::vector<std::string> afterPaths;
+    std::vector<std::string> *pathList = &paths;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--before") == 0) {
+            pathList = &beforePaths;
+        } else if (std::strcmp(argv[i], "--after") == 0) {
+            pathList = &afterPaths;
+        } else if (argv[i][0] == '-') {
+            PrintUsage();
+            return 1;
+        } else {
+            pathList->emplace_back(argv[i]);
+        }
+    }
+
+    if (!beforePaths.empty() || !afterPaths.empty()) {
+        if (beforePaths.empty() || afterPaths.empty() || !paths.empty()) {
+            PrintUsage();
+            return 1;
+        }
+        LogParseResult before;
+        LogParseResult after;
+        ParseLogFiles(beforePaths, threadCount, before);
+        ParseLogFiles(afterPaths, threadCount, after);
+        if (before.windows.empty() || after.windows.empty()) {
+            std::fprintf(stderr, "Both runs need at least one stats window\n");
+            return 1;
+        }
+        PrintRunDiff(before, after, top, stdout);
+        return 0;
+    }
+
+    if (paths.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    auto parseStart = std::chrono::steady_clock::now();
+    LogParseResult result;
+    ParseLogFiles(paths, threadCount, result);
+    double parseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - parseStart).count();
+
+    std::fprintf(stderr, "Parsed %.1f MB, %zu windows in %.3f s (%.0f MB/s)\n",
+                 result.bytesParsed / (1024.0 * 1024.0), result.windows.size(), parseSeconds,
+                 parseSeconds > 0 ? result.bytesParsed / (1024.0 * 1024.0) / parseSeconds : 0.0);
+    if (result.windows.empty()) {
+        return 1;
+    }
+
+    PrintSessionSummaries(result, paths);
+    PrintWorstWindows(result, paths, top);
+    PrintFunctionTrends(result, top);
+    PrintAddonTrends(result, top);
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace perf_monitor {
+    MappedFile::~MappedFile() {
+        if (mapping != nullptr) {
+            munmap(const_cast<char *>(mapping), length);
+        }
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+
+    bool MappedFile::open(const std::string &path) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            return false;
+        }
+        if (info.st_size == 0) {
+            return true;
+        }
+
+        void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            return false;
+        }
+        // Every page is read exactly once, by whichever thread parses its chunk
+        madvise(view, static_cast<size_t>(info.st_size), MADV_WILLNEED);
+        mapping = static_cast<const char *>(view);
+        length = static_cast<size_t>(info.st_size);
+        return true;
+    }
+}
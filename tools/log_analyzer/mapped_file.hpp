@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace perf_monitor {
+    // Read only memory mapping of a whole file, unmapped on destruction
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        // False with errno set if the file couldn't be opened or mapped.  Empty files map fine.
+        bool open(const std::string &path);
+
+        const char *data() const { return mapping; }
+
+        size_t size() const { return length; }
+
+    private:
+        int fd = -1;
+        const char *mapping = nullptr;
+        size_t length = 0;
+    };
+}
@@ -0,0 +1,425 @@
+#include "log_diff.hpp"
+#include "log_parser.hpp"
+#include "test_check.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace perf_monitor;
+
+// One stat line of a synthetic window.  name is what the parser should report, the section's
+// suffix is added when the line is written.
+struct SyntheticStat {
+    LogSection section;
+    std::string name;
+    uint64_t calls;
+    double total; // ms, or KB for memory sections
+    double max;
+    double p99;
+};
+
+struct SyntheticWindow {
+    double renderMs;
+    uint64_t frames;
+    double avgFps;
+    std::vector<SyntheticStat> stats;
+};
+
+// Builds perf_monitor.log text the way OutputStats lays it out, with the DEBUG_LOG timestamps
+class LogWriter {
+public:
+    explicit LogWriter(bool crlf = false) : newline(crlf ? "\r\n" : "\n") {}
+
+    void window(const SyntheticWindow &window) {
+        char start[32];
+        char end[32];
+        std::snprintf(start, sizeof(start), "10-17 %02d:%02d:%02d", hour(), minute(), second());
+        seconds += 30;
+        std::snprintf(end, sizeof(end), "10-17 %02d:%02d:%02d", hour(), minute(), second());
+        prefix = std::string(end) + ": ";
+
+        line(std::string(134, '-'));
+        line(std::string("--- STATS from ") + start + " to " + end + " ---");
+        line("");
+        line("--- Main loop event times ---");
+        line("Total paint(render) event time:                  12.50 ms");
+        char text[512];
+        std::snprintf(text, sizeof(text), "[Total] Render: %8.2f ms.  Frames: %6llu.  Time per frame: %6.2f ms.  "
+                                          "Avg fps: %6.2f", window.renderMs,
+                      static_cast<unsigned long long>(window.frames),
+                      window.renderMs / static_cast<double>(window.frames), window.avgFps);
+        line(text);
+
+        // Not a section the analyzer reads, its stat lines must be skipped
+        line("--- FUNCTION STATS (% OF TOTAL RENDER) ---");
+        timingLine("PaintScreen", {LOG_SECTION_FUNCTIONS, "", 1, 999.0, 999.0, 999.0});
+
+        const struct {
+            LogSection section;
+            const char *suffix;
+            const char *header;
+        } sections[] = {
+                {LOG_SECTION_FUNCTIONS, "",
+                 "--- DETAILED STATS ---"},
+                {LOG_SECTION_ADDON_ON_UPDATE, " OnUpdate",
+                 "--- ADDON/FRAME ONUPDATE PERFORMANCE (min 1ms total)---"},
+                {LOG_SECTION_ADDON_ON_UPDATE_MEMORY, " OnUpdate Memory",
+                 "--- ADDON ONUPDATE MEMORY USAGE (min 1KB total increase) ---"},
+                {LOG_SECTION_ADDON_ON_EVENT_MEMORY, " OnEvent Memory",
+                 "--- ADDON ONEVENT MEMORY USAGE (min 1KB total increase) ---"},
+                {LOG_SECTION_ADDON_ON_EVENT, " All Events",
+                 "--- ADDON/FRAME EVENTS PERFORMANCE (min 1ms total)---"},
+                {LOG_SECTION_SPELL_VISUALS, "",
+                 "--- SPELL VISUAL PERFORMANCE (TOP 10 SLOWEST) ---"},
+                {LOG_SECTION_EVENT_CODES, "",
+                 "--- TOTAL EVENT DURATION STATISTICS ---"},
+        };
+        for (const auto &section: sections) {
+            line(section.header);
+            for (const auto &stat: window.stats) {
+                if (stat.section != section.section) {
+                    continue;
+                }
+                if (stat.section == LOG_SECTION_ADDON_ON_UPDATE_MEMORY ||
+                    stat.section == LOG_SECTION_ADDON_ON_EVENT_MEMORY) {
+                    memoryLine(stat.name + section.suffix, stat);
+                } else {
+                    timingLine(stat.name + section.suffix, stat);
+                }
+            }
+            line("[Not a stat line");
+            line("");
+        }
+    }
+
+    // The separator that closes the last window
+    void finish() {
+        line(std::string(134, '-'));
+    }
+
+    void save(const std::string &path) const {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+        CHECK(file.good());
+    }
+
+private:
+    int hour() const { return 12 + seconds / 3600 % 12; }
+
+    int minute() const { return seconds / 60 % 60; }
+
+    int second() const { return seconds % 60; }
+
+    void line(const std::string &contents) {
+        text += prefix + contents + newline;
+    }
+
+    // OutputStatsLine
+    void timingLine(const std::string &name, const SyntheticStat &stat) {
+        char buffer[512];
+        std::snprintf(buffer, sizeof(buffer),
+                      "[%-45s] Calls: %8llu, Total: %8.3f ms, Avg: %6.3f ms, Slowest: %7.3f ms, Fastest: %6.3f ms, "
+                      "p50: %6.3f, p95: %6.3f, p99: %6.3f, p99.9: %7.3f ms", name.c_str(),
+                      static_cast<unsigned long long>(stat.calls), stat.total,
+                      stat.total / static_cast<double>(stat.calls), stat.max, 0.001, stat.p99 / 2, stat.p99 * 0.9,
+                      stat.p99, stat.max);
+        line(buffer);
+    }
+
+    // MemoryStats::outputStats
+    void memoryLine(const std::string &name, const SyntheticStat &stat) {
+        char buffer[512];
+        std::snprintf(buffer, sizeof(buffer), "[%-45s] Calls: %6llu, Total Mem: %8lld KB, Avg: %6.1f KB, Max: %6lld KB",
+                      name.c_str(), static_cast<unsigned long long>(stat.calls), static_cast<long long>(stat.total),
+                      stat.total / static_cast<double>(stat.calls), static_cast<long long>(stat.max));
+        line(buffer);
+    }
+
+    const char *newline;
+    std::string text;
+    std::string prefix = "10-17 12:00:00: ";
+    int seconds = 0;
+};
+
+// Sums per section and name, in the same units as LogStat
+struct StatTotals {
+    uint64_t calls = 0;
+    double total = 0;
+    double max = 0;
+    double p99 = 0;
+    size_t lines = 0;
+};
+
+using TotalsByStat = std::map<std::pair<int, std::string>, StatTotals>;
+
+static void AddTotals(TotalsByStat &totals, LogSection section, const std::string &name, uint64_t calls,
+                      double total, double max, double p99) {
+    StatTotals &entry = totals[{section, name}];
+    entry.calls += calls;
+    entry.total += total;
+    entry.max += max;
+    entry.p99 += p99;
+    entry.lines++;
+}
+
+static TotalsByStat ParsedTotals(const LogParseResult &result) {
+    TotalsByStat totals;
+    for (const auto &window: result.windows) {
+        for (const auto &stat: window.stats) {
+            AddTotals(totals, stat.section, result.names[stat.nameId], stat.calls, stat.total, stat.max, stat.p99);
+        }
+    }
+    return totals;
+}
+
+// Printed with 3 decimals, summed over a few hundred lines
+static bool Near(double parsed, double expected) {
+    return std::fabs(parsed - expected) <= 1e-6 * std::max(1.0, std::fabs(expected));
+}
+
+// Random windows over a fixed cast of functions, addons, events and spells
+static SyntheticWindow RandomWindow(std::mt19937 &random) {
+    auto ms = [&](int maxThousandths) { return static_cast<double>(random() % maxThousandths + 1) / 1000.0; };
+    SyntheticWindow window;
+    window.frames = 1000 + random() % 1000;
+    // Printed with 2 decimals
+    window.renderMs = static_cast<double>(random() % 3000000 + 1) / 100.0;
+    window.avgFps = static_cast<double>(random() % 10000 + 1) / 100.0;
+
+    const char *functions[] = {"PaintScreen", "OnWorldUpdate", "CWorldScene::Render"};
+    for (const char *name: functions) {
+        window.stats.push_back({LOG_SECTION_FUNCTIONS, name, 1 + random() % 5000, ms(5000000), ms(50000), ms(40000)});
+    }
+    // Addons come and go between windows
+    const char *addons[] = {"pfUI", "Bagnon", "Some, Addon", "ShaguTweaks"};
+    for (const char *name: addons) {
+        if (random() % 4 == 0) {
+            continue;
+        }
+        window.stats.push_back({LOG_SECTION_ADDON_ON_UPDATE, name, 1 + random() % 5000, ms(900000), ms(9000),
+                                ms(8000)});
+        window.stats.push_back({LOG_SECTION_ADDON_ON_EVENT, name, 1 + random() % 500, ms(90000), ms(9000), ms(8000)});
+        window.stats.push_back({LOG_SECTION_ADDON_ON_UPDATE_MEMORY, name, 1 + random() % 50,
+                                static_cast<double>(1 + random() % 5000), static_cast<double>(random() % 100), 0});
+        window.stats.push_back({LOG_SECTION_ADDON_ON_EVENT_MEMORY, name, 1 + random() % 50,
+                                static_cast<double>(1 + random() % 500), static_cast<double>(random() % 100), 0});
+    }
+    const char *events[] = {"UNIT_HEALTH", "COMBAT_LOG_EVENT", "CHAT_MSG_ADDON"};
+    for (const char *name: events) {
+        window.stats.push_back({LOG_SECTION_EVENT_CODES, name, 1 + random() % 5000, ms(90000), ms(9000), ms(8000)});
+    }
+    window.stats.push_back({LOG_SECTION_SPELL_VISUALS, "Spell ID " + std::to_string(100 + random() % 5),
+                            1 + random() % 50, ms(9000), ms(900), ms(800)});
+    return window;
+}
+
+static std::string gDirectory;
+
+static std::string TempPath(const char *name) {
+    return gDirectory + "/" + name;
+}
+
+// Two logs, one with Windows line endings, parsed on one thread in one chunk per file
+static void TestParsedTotals(std::vector<std::string> &paths) {
+    std::mt19937 random(17);
+    TotalsByStat expected;
+    std::vector<SyntheticWindow> windows;
+    for (int file = 0; file < 2; ++file) {
+        LogWriter writer(file == 1);
+        for (int i = 0; i < 60; ++i) {
+            windows.push_back(RandomWindow(random));
+            writer.window(windows.back());
+            for (const auto &stat: windows.back().stats) {
+                AddTotals(expected, stat.section, stat.name, stat.calls, stat.total, stat.max, stat.p99);
+            }
+        }
+        writer.finish();
+        paths.push_back(TempPath(file == 0 ? "perf_monitor.log.1" : "perf_monitor.log"));
+        writer.save(paths.back());
+    }
+
+    LogParseResult result;
+    ParseLogFiles(paths, 1, result);
+    CHECK(result.windows.size() == windows.size());
+    for (size_t i = 0; i < windows.size(); ++i) {
+        const LogWindow &parsed = result.windows[i];
+        CHECK(parsed.fileIndex == (i < 60 ? 0u : 1u));
+        CHECK(parsed.frames == windows[i].frames);
+        CHECK(Near(parsed.renderMs, windows[i].renderMs));
+        CHECK(Near(parsed.avgFps, windows[i].avgFps));
+        CHECK(parsed.stats.size() == windows[i].stats.size());
+    }
+    CHECK(std::strcmp(result.windows[0].start, "10-17 12:00:00") == 0);
+    CHECK(std::strcmp(result.windows[0].end, "10-17 12:00:30") == 0);
+    CHECK(std::strcmp(result.windows[61].start, "10-17 12:00:30") == 0);
+
+    // Every addon section of an addon shares its suffix-less name
+    TotalsByStat parsed = ParsedTotals(result);
+    CHECK(parsed.size() == expected.size());
+    for (const auto &entry: expected) {
+        auto found = parsed.find(entry.first);
+        CHECK(found != parsed.end());
+        CHECK(found->second.lines == entry.second.lines);
+        CHECK(found->second.calls == entry.second.calls);
+        CHECK(Near(found->second.total, entry.second.total));
+        CHECK(Near(found->second.max, entry.second.max));
+        CHECK(Near(found->second.p99, entry.second.p99));
+    }
+    CHECK(parsed.count({LOG_SECTION_ADDON_ON_UPDATE_MEMORY, "pfUI"}) == 1);
+    CHECK(parsed.count({LOG_SECTION_ADDON_ON_UPDATE, "pfUI OnUpdate"}) == 0);
+}
+
+static bool SameResult(const LogParseResult &a, const LogParseResult &b) {
+    if (a.names != b.names || a.windows.size() != b.windows.size() || a.bytesParsed != b.bytesParsed) {
+        return false;
+    }
+    for (size_t i = 0; i < a.windows.size(); ++i) {
+        const LogWindow &x = a.windows[i];
+        const LogWindow &y = b.windows[i];
+        if (x.fileIndex != y.fileIndex || std::memcmp(x.start, y.start, sizeof(x.start)) != 0 ||
+            std::memcmp(x.end, y.end, sizeof(x.end)) != 0 || x.renderMs != y.renderMs || x.frames != y.frames ||
+            x.avgFps != y.avgFps || x.stats.size() != y.stats.size()) {
+            return false;
+        }
+        for (size_t j = 0; j < x.stats.size(); ++j) {
+            const LogStat &s = x.stats[j];
+            const LogStat &t = y.stats[j];
+            if (s.nameId != t.nameId || s.section != t.section || s.calls != t.calls || s.total != t.total ||
+                s.max != t.max || s.p99 != t.p99) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Cutting the files into many chunks and parsing them on several threads changes nothing
+static void TestChunkedParsingMatches(const std::vector<std::string> &paths) {
+    LogParseResult single;
+    ParseLogFiles(paths, 1, single);
+
+    const size_t chunkSizes[] = {1, 4096, 100000, LOG_CHUNK_BYTES};
+    const unsigned threadCounts[] = {1, 3, 8};
+    for (size_t chunkBytes: chunkSizes) {
+        for (unsigned threads: threadCounts) {
+            LogParseResult chunked;
+            ParseLogFiles(paths, threads, chunked, chunkBytes);
+            CHECK(SameResult(single, chunked));
+        }
+    }
+}
+
+// A run of windows with the same stats in each
+static LogParseResult ParseRun(const char *name, size_t windowCount,
+                               const std::vector<SyntheticStat> &stats, double renderMs) {
+    LogWriter writer;
+    for (size_t i = 0; i < windowCount; ++i) {
+        SyntheticWindow window{renderMs, 1000, 60.0, stats};
+        // A stat that costs 0.1 or 0.3 ms per frame in alternate windows, the same mean in both runs
+        window.stats.push_back({LOG_SECTION_EVENT_CODES, "UNIT_HEALTH", 100, i % 2 == 0 ? 100.0 : 300.0, 5.0,
+                                2.0});
+        writer.window(window);
+    }
+    writer.finish();
+    std::string path = TempPath(name);
+    writer.save(path);
+
+    LogParseResult result;
+    ParseLogFiles({path}, 2, result);
+    CHECK(result.windows.size() == windowCount);
+    return result;
+}
+
+static std::vector<std::string> DiffLines(const LogParseResult &before, const LogParseResult &after, size_t top) {
+    std::FILE *out = std::tmpfile();
+    CHECK(out != nullptr);
+    PrintRunDiff(before, after, top, out);
+    std::rewind(out);
+
+    std::vector<std::string> lines;
+    char buffer[512];
+    while (std::fgets(buffer, sizeof(buffer), out) != nullptr) {
+        lines.emplace_back(buffer);
+    }
+    std::fclose(out);
+    return lines;
+}
+
+static std::string DiffLine(const char *key, double before, double after, double low, double high,
+                            const char *significant, double beforeCallMs, double afterCallMs, double beforeP99,
+                            double afterP99) {
+    char buffer[512];
+    std::snprintf(buffer, sizeof(buffer), "%-50s %9.4f %9.4f %+9.4f [%+9.4f, %+9.4f] %-3s %9.4f %+9.4f %9.3f %+9.3f\n",
+                  key, before, after, after - before, low, high, significant, beforeCallMs,
+                  afterCallMs - beforeCallMs, beforeP99, afterP99 - beforeP99);
+    return buffer;
+}
+
+// Constant stats give a zero width interval, so every printed number is known exactly
+static void TestRunDiff() {
+    LogParseResult before = ParseRun("before.log", 10, {
+            {LOG_SECTION_FUNCTIONS,       "PaintScreen", 1000, 16000.0, 40.0, 30.0},
+            {LOG_SECTION_ADDON_ON_UPDATE, "pfUI",        100,  2000.0,  50.0, 1.5},
+            {LOG_SECTION_ADDON_ON_UPDATE, "Bagnon",      100,  500.0,   9.0,  0.75},
+    }, 16000.0);
+    LogParseResult after = ParseRun("after.log", 12, {
+            {LOG_SECTION_FUNCTIONS,       "PaintScreen", 1000, 16000.0, 40.0, 30.0},
+            {LOG_SECTION_ADDON_ON_UPDATE, "pfUI",        100,  4000.0,  90.0, 2.5},
+    }, 17000.0);
+
+    std::vector<std::string> lines = DiffLines(before, after, 4);
+    CHECK(lines.size() == 8);
+    CHECK(lines[0] == "--- RUN DIFF (before: 10 windows, after: 12 windows, ms per frame, 95% bootstrap CI, "
+                      "* = CI excludes 0) ---\n");
+    CHECK(lines[1].compare(0, 4, "Stat") == 0);
+    CHECK(lines[2] == DiffLine("Frame time (render ms / frames)", 16.0, 17.0, 1.0, 1.0, "*", 16.0, 17.0, 0, 0));
+    // Largest change first, a stat missing from one run counts as 0 there
+    CHECK(lines[3] == DiffLine("OnUpdate pfUI", 2.0, 4.0, 2.0, 2.0, "*", 20.0, 40.0, 1.5, 2.5));
+    CHECK(lines[4] == DiffLine("OnUpdate Bagnon", 0.5, 0.0, -0.5, -0.5, "*", 5.0, 0.0, 0.75, 0.0));
+
+    // Equal means, PaintScreen has a zero width interval and UNIT_HEALTH one around 0
+    bool paintScreen = false;
+    bool unitHealth = false;
+    for (size_t i = 5; i < 7; ++i) {
+        if (lines[i] == DiffLine("function PaintScreen", 16.0, 16.0, 0.0, 0.0, "", 16.0, 16.0, 30.0, 30.0)) {
+            paintScreen = true;
+        }
+        if (lines[i].compare(0, 11, "event UNIT_") == 0) {
+            double beforeMean, afterMean, delta, low, high;
+            CHECK(std::sscanf(lines[i].c_str() + 50, "%lf %lf %lf [%lf, %lf]", &beforeMean, &afterMean, &delta, &low,
+                              &high) == 5);
+            CHECK(Near(beforeMean, 0.2) && Near(afterMean, 0.2) && std::fabs(delta) < 1e-9);
+            CHECK(low < 0 && high > 0 && low > -0.2 && high < 0.2);
+            CHECK(lines[i].find('*') == std::string::npos);
+            unitHealth = true;
+        }
+    }
+    CHECK(paintScreen && unitHealth);
+    CHECK(lines[7] == "\n");
+
+    // The bootstrap is seeded, the same diff prints the same intervals
+    CHECK(DiffLines(before, after, 4) == lines);
+
+    // --top limits the stats, the frame time line is always printed
+    CHECK(DiffLines(before, after, 1).size() == 5);
+}
+
+int main() {
+    char directory[] = "/tmp/log_analyzer_testXXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    gDirectory = directory;
+
+    std::vector<std::string> paths;
+    TestParsedTotals(paths);
+    TestChunkedParsingMatches(paths);
+    TestRunDiff();
+    return 0;
+}